@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <cmath>
+#include <string>
+
+#include "engine/Frustum.hpp"
+#include "engine/FrustumCuller.hpp"
+#include "engine/Math.hpp"
+#include "engine/TransformHierarchy.hpp"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    template<typename F>
+    double measure(int iterations, F&& function) {
+        // warm up caches and worker threads once
+        function();
+
+        auto start = Clock::now();
+        for (int i = 0; i < iterations; i++) {
+            function();
+        }
+        std::chrono::duration<double> elapsed = Clock::now() - start;
+
+        return elapsed.count() / iterations;
+    }
+
+    void report(const char* name, size_t count, double seconds, const std::vector<uint32_t>& visible) {
+        std::cout << "  " << std::left << std::setw(28) << name
+                  << std::right << std::setw(10) << std::fixed << std::setprecision(3) << seconds * 1000.0 << " ms"
+                  << std::setw(14) << std::setprecision(1) << count / seconds / 1e6 << " Mobj/s"
+                  << std::setw(10) << visible.size() << " visible\n";
+    }
+
+    void benchCulling(size_t count) {
+        std::mt19937 random{42};
+        std::uniform_real_distribution<float> position{-500.0f, 500.0f};
+        std::uniform_real_distribution<float> size{0.5f, 4.0f};
+
+        vke::FrustumCuller culler;
+        for (size_t i = 0; i < count; i++) {
+            float center[3] = { position(random), position(random), position(random) };
+            float radius = size(random);
+            float min[3] = { center[0] - radius, center[1] - radius, center[2] - radius };
+            float max[3] = { center[0] + radius, center[1] + radius, center[2] + radius };
+
+            culler.addSphere(center, radius);
+            culler.addBox(min, max);
+        }
+
+        vke::Mat4 projection = vke::Mat4::perspective(1.0f, 16.0f / 9.0f, 0.1f, 400.0f);
+        vke::Frustum frustum = vke::Frustum::fromViewProjection(projection.data());
+
+        int iterations = count >= 1000000 ? 20 : 200;
+        std::vector<uint32_t> visible;
+
+        std::cout << "[Culling] " << count << " objects, SIMD width " << vke::FrustumCuller::getSimdWidth() << '\n';
+
+        culler.setSimdEnabled(false);
+        culler.setThreadCount(1);
+        report("spheres scalar", count, measure(iterations, [&] { culler.cullSpheres(frustum, visible); }), visible);
+        report("boxes scalar", count, measure(iterations, [&] { culler.cullBoxes(frustum, visible); }), visible);
+
+        culler.setSimdEnabled(true);
+        report("spheres simd", count, measure(iterations, [&] { culler.cullSpheres(frustum, visible); }), visible);
+        report("boxes simd", count, measure(iterations, [&] { culler.cullBoxes(frustum, visible); }), visible);
+
+        culler.setThreadCount(0);
+        report("spheres simd parallel", count, measure(iterations, [&] { culler.cullSpheres(frustum, visible); }), visible);
+        report("boxes simd parallel", count, measure(iterations, [&] { culler.cullBoxes(frustum, visible); }), visible);
+    }
+
+    void benchTransforms(size_t count) {
+        std::mt19937 random{7};
+        std::uniform_real_distribution<float> offset{-2.0f, 2.0f};
+
+        vke::TransformHierarchy hierarchy;
+        std::vector<vke::TransformHierarchy::Node> nodes;
+        nodes.reserve(count);
+
+        // shallow forest, every node hangs off one of the nodes created before it
+        for (size_t i = 0; i < count; i++) {
+            vke::TransformHierarchy::Node parent = i < 64 ? vke::TransformHierarchy::NONE : nodes[random() % i];
+            vke::TransformHierarchy::Node node = hierarchy.create(parent);
+            hierarchy.setPosition(node, offset(random), offset(random), offset(random));
+            nodes.push_back(node);
+        }
+
+        std::vector<float> mapped(count * 16);
+        uint64_t version = 0;
+        hierarchy.update();
+        version = hierarchy.writeWorld(mapped.data(), version).version;
+
+        std::cout << "[Transforms] " << count << " nodes\n";
+
+        float angle = 0.0f;
+        for (size_t fraction : { 100, 10, 1 }) {
+            size_t animated = count * fraction / 100;
+
+            double seconds = measure(100, [&] {
+                angle += 0.01f;
+                for (size_t i = 0; i < animated; i++) {
+                    hierarchy.setRotation(nodes[(i * 7919) % count], 0.0f, std::sin(angle), 0.0f, std::cos(angle));
+                }
+
+                hierarchy.update();
+                version = hierarchy.writeWorld(mapped.data(), version).version;
+            });
+
+            std::string name = std::to_string(fraction) + "% nodes animated";
+            std::cout << "  " << std::left << std::setw(28) << name
+                      << std::right << std::setw(10) << std::fixed << std::setprecision(3) << seconds * 1000.0 << " ms\n";
+        }
+    }
+
+    // Straightforward loops the batched math functions are measured against
+    void transformPointsScalar(const vke::Mat4& m, const vke::Vec3* points, vke::Vec3* out, size_t count) {
+        const float* c = m.data();
+        for (size_t i = 0; i < count; i++) {
+            vke::Vec3 p = points[i];
+            out[i] = {
+                c[0] * p.x + c[4] * p.y + c[8] * p.z + c[12],
+                c[1] * p.x + c[5] * p.y + c[9] * p.z + c[13],
+                c[2] * p.x + c[6] * p.y + c[10] * p.z + c[14]
+            };
+        }
+    }
+
+    void multiplyMatricesScalar(const vke::Mat4& a, const vke::Mat4* b, vke::Mat4* out, size_t count) {
+        const float* left = a.data();
+        for (size_t m = 0; m < count; m++) {
+            const float* right = b[m].data();
+            float* result = out[m].data();
+
+            for (int j = 0; j < 4; j++) {
+                for (int i = 0; i < 4; i++) {
+                    result[j * 4 + i] = left[i] * right[j * 4] + left[4 + i] * right[j * 4 + 1] + left[8 + i] * right[j * 4 + 2] + left[12 + i] * right[j * 4 + 3];
+                }
+            }
+        }
+    }
+
+    void transformAabbsScalar(const vke::Mat4& m, const vke::Aabb* boxes, vke::Aabb* out, size_t count) {
+        // all eight corners, the way it is usually done without thinking about it
+        for (size_t i = 0; i < count; i++) {
+            const vke::Aabb& box = boxes[i];
+            vke::Aabb result{ { INFINITY, INFINITY, INFINITY }, { -INFINITY, -INFINITY, -INFINITY } };
+
+            for (int corner = 0; corner < 8; corner++) {
+                vke::Vec3 point{ corner & 1 ? box.max.x : box.min.x, corner & 2 ? box.max.y : box.min.y, corner & 4 ? box.max.z : box.min.z };
+                vke::Vec3 transformed;
+                transformPointsScalar(m, &point, &transformed, 1);
+
+                result.min = { std::min(result.min.x, transformed.x), std::min(result.min.y, transformed.y), std::min(result.min.z, transformed.z) };
+                result.max = { std::max(result.max.x, transformed.x), std::max(result.max.y, transformed.y), std::max(result.max.z, transformed.z) };
+            }
+
+            out[i] = result;
+        }
+    }
+
+    void reportMath(const char* name, size_t count, double scalar, double simd) {
+        std::cout << "  " << std::left << std::setw(28) << name
+                  << std::right << std::setw(10) << std::fixed << std::setprecision(3) << scalar * 1000.0 << " ms scalar"
+                  << std::setw(10) << simd * 1000.0 << " ms simd"
+                  << std::setw(10) << std::setprecision(1) << count / simd / 1e6 << " M/s"
+                  << std::setw(8) << std::setprecision(2) << scalar / simd << "x\n";
+    }
+
+    void benchMath(size_t count) {
+        std::mt19937 random{13};
+        std::uniform_real_distribution<float> value{-10.0f, 10.0f};
+
+        vke::Mat4 matrix = vke::Mat4::compose({ 1.0f, 2.0f, 3.0f }, vke::Quat::fromAxisAngle({ 1.0f, 1.0f, 0.0f }, 0.7f), { 2.0f, 2.0f, 2.0f });
+
+        std::vector<vke::Vec3> points(count);
+        std::vector<vke::Vec3> transformed(count);
+        std::vector<vke::Mat4> matrices(count);
+        std::vector<vke::Mat4> products(count);
+        std::vector<vke::Aabb> boxes(count);
+        std::vector<vke::Aabb> transformedBoxes(count);
+
+        for (size_t i = 0; i < count; i++) {
+            points[i] = { value(random), value(random), value(random) };
+            matrices[i] = vke::Mat4::compose(points[i], vke::Quat::fromAxisAngle({ value(random), value(random), 1.0f }, value(random)), { 1.0f, 1.0f, 1.0f });
+            vke::Vec3 extent{ std::abs(value(random)), std::abs(value(random)), std::abs(value(random)) };
+            boxes[i] = { points[i] - extent, points[i] + extent };
+        }
+
+        std::cout << "[Math] " << count << " elements, SIMD width " << vke::getMathSimdWidth() << '\n';
+
+        reportMath("transform points", count,
+                   measure(100, [&] { transformPointsScalar(matrix, points.data(), transformed.data(), count); }),
+                   measure(100, [&] { vke::transformPoints(matrix, points.data(), transformed.data(), count); }));
+        reportMath("multiply matrices", count,
+                   measure(100, [&] { multiplyMatricesScalar(matrix, matrices.data(), products.data(), count); }),
+                   measure(100, [&] { vke::multiplyMatrices(matrix, matrices.data(), products.data(), count); }));
+        reportMath("transform aabbs", count,
+                   measure(100, [&] { transformAabbsScalar(matrix, boxes.data(), transformedBoxes.data(), count); }),
+                   measure(100, [&] { vke::transformAabbs(matrix, boxes.data(), transformedBoxes.data(), count); }));
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string only = argc > 1 ? argv[1] : "";
+
+    if (only.empty() || only == "culling") {
+        benchCulling(100000);
+        benchCulling(1000000);
+    }
+
+    if (only.empty() || only == "transforms") {
+        benchTransforms(50000);
+    }
+
+    if (only.empty() || only == "math") {
+        benchMath(100000);
+    }
+
+    return 0;
+}
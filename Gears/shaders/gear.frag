@@ -0,0 +1,13 @@
+#version 450
+
+layout(location = 0) in vec3 inNormal;
+layout(location = 1) in vec3 inColor;
+
+layout(location = 0) out vec4 outColor;
+
+const vec3 LIGHT_DIRECTION = normalize(vec3(5.0, 5.0, 10.0));
+
+void main() {
+    float diffuse = max(dot(normalize(inNormal), LIGHT_DIRECTION), 0.0);
+    outColor = vec4(inColor * (0.2 + 0.8 * diffuse), 1.0);
+}
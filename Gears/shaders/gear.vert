@@ -0,0 +1,21 @@
+#version 450
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec3 inColor;
+// per instance world matrix, one column per location
+layout(location = 3) in mat4 inModel;
+
+layout(push_constant) uniform Camera {
+    mat4 viewProjection;
+} camera;
+
+layout(location = 0) out vec3 outNormal;
+layout(location = 1) out vec3 outColor;
+
+void main() {
+    gl_Position = camera.viewProjection * inModel * vec4(inPosition, 1.0);
+    // gears are only rotated and translated, so the model matrix works for normals as well
+    outNormal = mat3(inModel) * inNormal;
+    outColor = inColor;
+}
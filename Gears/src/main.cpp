@@ -2,27 +2,500 @@
 
 #include <engine/VkEngineApp.hpp>
 #include <engine/EngineResult.hpp>
+#include <engine/MeshOptimizer.hpp>
+#include <engine/Frustum.hpp>
+#include <engine/Math.hpp>
+#include <engine/Trace.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
 #include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32_t MAX_GEARS = 100000;
+    constexpr uint32_t MAX_TESSELLATION = 64;
+    // frames of a headless run when --frames is not given
+    constexpr uint32_t DEFAULT_HEADLESS_FRAMES = 1000;
+    constexpr float PI = 3.14159265f;
+    // same speed as the original glxgears, in degrees per second
+    constexpr float ROTATION_SPEED = 70.0f;
+    // simulated time per frame in fixed-frame runs, so every run animates exactly the same workload
+    constexpr float FIXED_TIME_STEP = 1.0f / 60.0f;
+    constexpr float CLUSTER_SPACING = 16.0f;
+    // position, normal, color
+    constexpr uint32_t VERTEX_STRIDE = 9;
+
+    struct Options {
+        uint32_t count = 3;
+        uint32_t tessellation = 1;
+        uint32_t frames = 0;
+        bool headless = false;
+        bool dynamicRendering = false;
+        // Chrome trace written after the run, needs an engine built with VKENGINE_TRACING
+        std::string trace;
+        // engine default when not given
+        std::optional<vke::VkEngineApp::Profile> profile;
+    };
+
+    // The three glxgears gears, placed and phased so their teeth mesh
+    struct GearShape {
+        float innerRadius;
+        float outerRadius;
+        float width;
+        uint32_t teeth;
+        float toothDepth;
+        float color[3];
+        float position[2];
+        float ratio;
+        float phase;
+    };
+
+    constexpr GearShape SHAPES[] = {
+        { 1.0f, 4.0f, 1.0f, 20, 0.7f, { 0.8f, 0.1f, 0.0f }, { -3.0f, -2.0f }, 1.0f, 0.0f },
+        { 0.5f, 2.0f, 2.0f, 10, 0.7f, { 0.0f, 0.8f, 0.2f }, { 3.1f, -2.0f }, -2.0f, -9.0f },
+        { 1.3f, 2.0f, 0.5f, 10, 0.7f, { 0.2f, 0.2f, 1.0f }, { -3.1f, 4.2f }, -2.0f, -25.0f },
+    };
+
+    constexpr uint32_t SHAPE_COUNT = std::size(SHAPES);
+
+    // Per gear animation, angle is ratio * time + phase
+    struct Spin {
+        float ratio;
+        float phase;
+    };
+
+    struct Camera {
+        vke::Mat4 viewProjection;
+    };
+
+    void addVertex(vke::MeshData& mesh, const float* position, const float* normal, const float* color) {
+        mesh.vertices.insert(mesh.vertices.end(), position, position + 3);
+        mesh.vertices.insert(mesh.vertices.end(), normal, normal + 3);
+        mesh.vertices.insert(mesh.vertices.end(), color, color + 3);
+        mesh.indices.push_back(static_cast<uint32_t>(mesh.indices.size()));
+    }
+
+    // Takes triangles counter clockwise seen from outside. The projection flips Y and the engine pipeline treats
+    // clockwise as front facing, so they are emitted in reverse. Shared vertices are merged by MeshOptimizer later.
+    void addTriangle(vke::MeshData& mesh, const float* a, const float* b, const float* c, const float* na, const float* nb, const float* nc, const float* color) {
+        addVertex(mesh, a, na, color);
+        addVertex(mesh, c, nc, color);
+        addVertex(mesh, b, nb, color);
+    }
+
+    void addTriangle(vke::MeshData& mesh, const float* a, const float* b, const float* c, const float* normal, const float* color) {
+        addTriangle(mesh, a, b, c, normal, normal, normal, color);
+    }
+
+    // Gear in the XY plane centered at origin, every edge of the tooth profile is split into tessellation segments
+    vke::MeshData generateGear(const GearShape& shape, uint32_t tessellation) {
+        float r0 = shape.innerRadius;
+        float r1 = shape.outerRadius - shape.toothDepth * 0.5f;
+        float r2 = shape.outerRadius + shape.toothDepth * 0.5f;
+        float h = shape.width * 0.5f;
+        float da = 2.0f * PI / static_cast<float>(shape.teeth) / 4.0f;
+
+        // outline as (angle, radius): flank up, top land, flank down, bottom land
+        std::vector<float> angles;
+        std::vector<float> radii;
+        for (uint32_t tooth = 0; tooth < shape.teeth; tooth++) {
+            float a = static_cast<float>(tooth) * 4.0f * da;
+            const float edges[4][4] = {
+                { a, r1, a + da, r2 },
+                { a + da, r2, a + 2.0f * da, r2 },
+                { a + 2.0f * da, r2, a + 3.0f * da, r1 },
+                { a + 3.0f * da, r1, a + 4.0f * da, r1 },
+            };
+
+            for (const auto& edge : edges) {
+                for (uint32_t step = 0; step < tessellation; step++) {
+                    float t = static_cast<float>(step) / static_cast<float>(tessellation);
+                    angles.push_back(edge[0] + (edge[2] - edge[0]) * t);
+                    radii.push_back(edge[1] + (edge[3] - edge[1]) * t);
+                }
+            }
+        }
+
+        vke::MeshData mesh;
+        mesh.vertexStride = VERTEX_STRIDE;
+
+        const float front[3] = { 0.0f, 0.0f, 1.0f };
+        const float back[3] = { 0.0f, 0.0f, -1.0f };
+        const float* color = shape.color;
+
+        for (size_t k = 0, segments = angles.size(); k < segments; k++) {
+            size_t next = (k + 1) % segments;
+            float c0 = std::cos(angles[k]), s0 = std::sin(angles[k]);
+            float c1 = std::cos(angles[next]), s1 = std::sin(angles[next]);
+
+            float outerFront0[3] = { radii[k] * c0, radii[k] * s0, h };
+            float outerFront1[3] = { radii[next] * c1, radii[next] * s1, h };
+            float outerBack0[3] = { radii[k] * c0, radii[k] * s0, -h };
+            float outerBack1[3] = { radii[next] * c1, radii[next] * s1, -h };
+            float innerFront0[3] = { r0 * c0, r0 * s0, h };
+            float innerFront1[3] = { r0 * c1, r0 * s1, h };
+            float innerBack0[3] = { r0 * c0, r0 * s0, -h };
+            float innerBack1[3] = { r0 * c1, r0 * s1, -h };
+
+            addTriangle(mesh, innerFront0, outerFront0, outerFront1, front, color);
+            addTriangle(mesh, innerFront0, outerFront1, innerFront1, front, color);
+
+            addTriangle(mesh, innerBack0, outerBack1, outerBack0, back, color);
+            addTriangle(mesh, innerBack0, innerBack1, outerBack1, back, color);
+
+            // outer surface, flat shaded so teeth keep their edges
+            float dx = outerFront1[0] - outerFront0[0];
+            float dy = outerFront1[1] - outerFront0[1];
+            float length = std::sqrt(dx * dx + dy * dy);
+            float outward[3] = { dy / length, -dx / length, 0.0f };
+            addTriangle(mesh, outerFront0, outerBack0, outerBack1, outward, color);
+            addTriangle(mesh, outerFront0, outerBack1, outerFront1, outward, color);
+
+            // hole in the middle, smooth shaded
+            float inward0[3] = { -c0, -s0, 0.0f };
+            float inward1[3] = { -c1, -s1, 0.0f };
+            addTriangle(mesh, innerFront0, innerBack1, innerBack0, inward0, inward1, inward0, color);
+            addTriangle(mesh, innerFront0, innerFront1, innerBack1, inward0, inward1, inward1, color);
+        }
+
+        return mesh;
+    }
+
+    // Every shape is generated and optimized on its own thread
+    std::vector<vke::MeshData> generateGears(uint32_t tessellation) {
+        std::vector<vke::MeshData> meshes(SHAPE_COUNT);
+        std::vector<std::thread> workers;
+
+        for (uint32_t i = 0; i < SHAPE_COUNT; i++) {
+            workers.emplace_back([&meshes, i, tessellation] {
+                meshes[i] = generateGear(SHAPES[i], tessellation);
+                vke::MeshOptimizer::optimize(meshes[i]);
+            });
+        }
+
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+
+        return meshes;
+    }
+
+    bool parseNumber(const char* text, uint32_t& value) {
+        char* end;
+        unsigned long parsed = std::strtoul(text, &end, 10);
+        if (*text == '\0' || *end != '\0')
+            return false;
+
+        value = static_cast<uint32_t>(std::min<unsigned long>(parsed, UINT32_MAX));
+        return true;
+    }
+
+    bool parseProfile(std::string_view text, std::optional<vke::VkEngineApp::Profile>& profile) {
+        if (text == "release") {
+            profile = vke::VkEngineApp::Profile::RELEASE;
+        } else if (text == "debug") {
+            profile = vke::VkEngineApp::Profile::DEBUG;
+        } else if (text == "gpu-assisted") {
+            profile = vke::VkEngineApp::Profile::GPU_ASSISTED;
+        } else if (text == "best-practices") {
+            profile = vke::VkEngineApp::Profile::BEST_PRACTICES;
+        } else {
+            return false;
+        }
+
+        return true;
+    }
+
+    const char* getProfileName(vke::VkEngineApp::Profile profile) {
+        switch (profile) {
+            case vke::VkEngineApp::Profile::RELEASE:
+                return "release";
+            case vke::VkEngineApp::Profile::DEBUG:
+                return "debug";
+            case vke::VkEngineApp::Profile::GPU_ASSISTED:
+                return "gpu-assisted";
+            case vke::VkEngineApp::Profile::BEST_PRACTICES:
+                return "best-practices";
+        }
+
+        return "unknown";
+    }
+
+    bool parseOptions(int argc, char* argv[], Options& options) {
+        for (int i = 1; i < argc; i++) {
+            std::string_view argument = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (argument == "--count" && hasValue) {
+                if (!parseNumber(argv[++i], options.count))
+                    return false;
+            } else if (argument == "--tessellation" && hasValue) {
+                if (!parseNumber(argv[++i], options.tessellation))
+                    return false;
+            } else if (argument == "--frames" && hasValue) {
+                if (!parseNumber(argv[++i], options.frames))
+                    return false;
+            } else if (argument == "--headless") {
+                options.headless = true;
+            } else if (argument == "--dynamic-rendering") {
+                options.dynamicRendering = true;
+            } else if (argument == "--trace" && hasValue) {
+                options.trace = argv[++i];
+            } else if (argument == "--profile" && hasValue) {
+                if (!parseProfile(argv[++i], options.profile))
+                    return false;
+            } else {
+                return false;
+            }
+        }
+
+        options.count = std::clamp(options.count, 1u, MAX_GEARS);
+        options.tessellation = std::clamp(options.tessellation, 1u, MAX_TESSELLATION);
+        if (options.headless && options.frames == 0) {
+            options.frames = DEFAULT_HEADLESS_FRAMES;
+        }
+
+        return true;
+    }
+}
 
 class GearsApp : public vke::VkEngineApp {
+    Options mOptions;
+    std::vector<vke::Mesh> mMeshes;
+    vke::EntityStore mStore;
+    vke::TransformHierarchy mHierarchy;
+    float mGridExtent;
+    float mTime;
+    uint32_t mFrame;
+    Clock::time_point mLastFrame;
+    std::vector<float> mFrameTimes;
+    uint64_t mTotalDraws;
+    uint64_t mTotalVisible;
+
+    void createScene() {
+        uint32_t clusters = (mOptions.count + SHAPE_COUNT - 1) / SHAPE_COUNT;
+        uint32_t columns = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(clusters))));
+        float offset = static_cast<float>(columns - 1) * 0.5f;
+        mGridExtent = static_cast<float>(columns) * CLUSTER_SPACING;
+
+        for (uint32_t cluster = 0, created = 0; cluster < clusters; cluster++) {
+            vke::TransformHierarchy::Node parent = mHierarchy.create();
+            mHierarchy.setPosition(parent, (static_cast<float>(cluster % columns) - offset) * CLUSTER_SPACING, (static_cast<float>(cluster / columns) - offset) * CLUSTER_SPACING, 0.0f);
+
+            for (uint32_t shape = 0; shape < SHAPE_COUNT && created < mOptions.count; shape++, created++) {
+                const GearShape& gear = SHAPES[shape];
+                float halfWidth = gear.width * 0.5f;
+                float tip = gear.outerRadius + gear.toothDepth * 0.5f;
+
+                vke::TransformHierarchy::Node node = mHierarchy.create(parent);
+                mHierarchy.setPosition(node, gear.position[0], gear.position[1], 0.0f);
+
+                mStore.create(vke::Renderable{ &mMeshes[shape] },
+                              vke::Transform{ node },
+                              vke::Bounds{ { 0.0f, 0.0f, 0.0f }, std::sqrt(tip * tip + halfWidth * halfWidth) },
+                              Spin{ gear.ratio, gear.phase });
+            }
+        }
+    }
+
+    void updateCamera(vke::Frustum& frustum, Camera& camera) const {
+        VkExtent2D extent = getSwapchainExtent();
+        float distance = std::max(mGridExtent, 2.0f * CLUSTER_SPACING) * 0.9f;
+        float orbit = mTime * 0.1f;
+
+        vke::Vec3 eye{ std::sin(orbit) * distance * 0.5f, -std::cos(orbit) * distance * 0.5f, distance * 0.7f };
+        float aspect = static_cast<float>(extent.width) / static_cast<float>(std::max(extent.height, 1u));
+
+        camera.viewProjection = vke::Mat4::perspective(0.8f, aspect, 1.0f, distance * 3.0f) * vke::Mat4::lookAt(eye, { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f });
+        frustum = vke::Frustum::fromViewProjection(camera.viewProjection.data());
+    }
+
+protected:
+    vke::EngineResult<std::map<VkShaderStageFlagBits, vke::ShaderFile>> loadShaders() override {
+        std::map<VkShaderStageFlagBits, vke::ShaderFile> shaders;
+
+        if (auto file = vke::ShaderFile::loadFromFile(GEARS_SHADER_DIR "/gear.vert.spv", "main")) {
+            shaders.emplace(VK_SHADER_STAGE_VERTEX_BIT, std::move(file.getOk()));
+        } else {
+            return vke::EngineResult<std::map<VkShaderStageFlagBits, vke::ShaderFile>>::error(std::move(file.getError()));
+        }
+
+        if (auto file = vke::ShaderFile::loadFromFile(GEARS_SHADER_DIR "/gear.frag.spv", "main")) {
+            shaders.emplace(VK_SHADER_STAGE_FRAGMENT_BIT, std::move(file.getOk()));
+        } else {
+            return vke::EngineResult<std::map<VkShaderStageFlagBits, vke::ShaderFile>>::error(std::move(file.getError()));
+        }
+
+        return shaders;
+    }
+
+    vke::PipelineDescription describePipeline() override {
+        vke::PipelineDescription description;
+        description.vertexBinding(sizeof(float) * VERTEX_STRIDE)
+                   .vertexAttribute(0, vke::PipelineDescription::VERTEX_BINDING, VK_FORMAT_R32G32B32_SFLOAT, 0)
+                   .vertexAttribute(1, vke::PipelineDescription::VERTEX_BINDING, VK_FORMAT_R32G32B32_SFLOAT, sizeof(float) * 3)
+                   .vertexAttribute(2, vke::PipelineDescription::VERTEX_BINDING, VK_FORMAT_R32G32B32_SFLOAT, sizeof(float) * 6)
+                   // world matrix written by drawScene(), one column per location
+                   .instanceBinding(vke::TransformHierarchy::MATRIX_SIZE)
+                   .pushConstant<Camera>(VK_SHADER_STAGE_VERTEX_BIT);
+
+        for (uint32_t column = 0; column < 4; column++) {
+            description.vertexAttribute(3 + column, vke::PipelineDescription::INSTANCE_BINDING, VK_FORMAT_R32G32B32A32_SFLOAT, sizeof(float) * 4 * column);
+        }
+
+        return description;
+    }
+
+    vke::EngineResult<void> onInit() override {
+        auto start = Clock::now();
+        std::vector<vke::MeshData> meshes = generateGears(mOptions.tessellation);
+        std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+
+        size_t triangles = 0;
+        for (const vke::MeshData& data : meshes) {
+            triangles += data.indices.size() / 3;
+
+            if (auto mesh = createMesh(data)) {
+                mMeshes.push_back(std::move(mesh.getOk()));
+            } else {
+                return mesh;
+            }
+        }
+
+        std::cout << "[GEARS]: Generated " << meshes.size() << " gear meshes (" << triangles << " triangles) in " << elapsed.count() << " ms\n";
+
+        // entities point at meshes, so they are created only after mMeshes stopped growing
+        createScene();
+
+        std::cout << "[GEARS]: " << mStore.size() << " gears, tessellation " << mOptions.tessellation << '\n';
+
+        return {};
+    }
+
+    void render(VkCommandBuffer cmdBuffer) override {
+        Clock::time_point now = Clock::now();
+        float delta = 0.0f;
+
+        // draws of the previous frame have been recorded by now
+        if (mFrame > 0) {
+            delta = std::chrono::duration<float>(now - mLastFrame).count();
+            mFrameTimes.push_back(delta);
+            mTotalDraws += getDrawStats().draws;
+        }
+        mLastFrame = now;
+
+        mTime += mOptions.frames > 0 ? FIXED_TIME_STEP : delta;
+
+        float angle = mTime * ROTATION_SPEED;
+        {
+            VKE_TRACE_SCOPE("Gears::animate");
+            mStore.forEach<vke::Transform, Spin>([this, angle](vke::Entity, vke::Transform& transform, Spin& spin) {
+                vke::Quat rotation = vke::Quat::fromAxisAngle({ 0.0f, 0.0f, 1.0f }, (angle * spin.ratio + spin.phase) * PI / 180.0f);
+                mHierarchy.setRotation(transform.node, rotation.x, rotation.y, rotation.z, rotation.w);
+            });
+        }
+
+        vke::Frustum frustum;
+        Camera camera;
+        updateCamera(frustum, camera);
+
+        pushConstants(cmdBuffer, VK_SHADER_STAGE_VERTEX_BIT, camera);
+        mTotalVisible += drawScene(mStore, mHierarchy, frustum);
+
+        mFrame++;
+        if (mOptions.frames > 0 && mFrame >= mOptions.frames) {
+            stop();
+        }
+    }
+
+public:
+    explicit GearsApp(const Options& options) : mOptions{options}, mMeshes{}, mStore{}, mHierarchy{}, mGridExtent{0.0f}, mTime{0.0f}, mFrame{0}, mLastFrame{}, mFrameTimes{}, mTotalDraws{0}, mTotalVisible{0} {
+        mFrameTimes.reserve(options.frames);
+    }
+
+    void printReport() const {
+        if (mFrameTimes.empty())
+            return;
+
+        std::vector<float> sorted = mFrameTimes;
+        std::sort(sorted.begin(), sorted.end());
+
+        double total = 0.0;
+        for (float time : sorted) {
+            total += time;
+        }
+
+        auto percentile = [&sorted](double p) {
+            size_t index = std::min(sorted.size() - 1, static_cast<size_t>(p * static_cast<double>(sorted.size())));
+            return sorted[index] * 1000.0f;
+        };
+
+        size_t frames = sorted.size();
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << "[GEARS]: " << mFrame << " frames, " << mStore.size() << " gears, tessellation " << mOptions.tessellation << ", " << getProfileName(getProfile()) << " profile\n"
+                  << "  FPS: " << static_cast<double>(frames) / total << '\n'
+                  << "  frame time ms: p50 " << percentile(0.5) << ", p90 " << percentile(0.9) << ", p99 " << percentile(0.99) << ", max " << sorted.back() * 1000.0f << '\n'
+                  << "  draws per frame: " << static_cast<double>(mTotalDraws) / static_cast<double>(frames) << '\n'
+                  << "  visible gears per frame: " << static_cast<double>(mTotalVisible) / static_cast<double>(mFrame) << '\n'
+                  << "  " << getDrawStats() << '\n';
+    }
 };
 
 int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " [--count 1-" << MAX_GEARS << "] [--tessellation 1-" << MAX_TESSELLATION << "] [--frames N] [--headless] [--dynamic-rendering] [--trace FILE]\n"
+                  << "       [--profile release|debug|gpu-assisted|best-practices]\n"
+                  << "  --headless  hidden window, runs " << DEFAULT_HEADLESS_FRAMES << " frames unless --frames says otherwise\n"
+                  << "  --trace     writes CPU and GPU scopes as Chrome trace JSON, open in ui.perfetto.dev\n"
+                  << "  --profile   validation to run with, compare frame times of the same run across profiles\n";
+        return 1;
+    }
+
     std::cout << "[GEARS]: Launching Gears\n";
 
-    GearsApp app{};
+    GearsApp app{options};
+    app.setWindowHidden(options.headless);
+    if (options.dynamicRendering) {
+        app.setRenderPath(vke::VkEngineApp::RenderPath::DYNAMIC_RENDERING);
+    }
+    if (options.profile) {
+        app.setProfile(*options.profile);
+    }
 
+    Clock::time_point createStart = Clock::now();
     if (vke::EngineResult<void> result = app.create(1024, 720, "Gears"); !result) {
         std::cerr << "[GEARS] [FATAL]: " << result.getError() << '\n';
         return 1;
     }
+    std::chrono::duration<double, std::milli> createTime = Clock::now() - createStart;
+
+    std::cout << "[GEARS]: Created with " << getProfileName(app.getProfile()) << " profile in " << createTime.count() << " ms\n";
 
     if (vke::EngineResult<void> result = app.run(); !result) {
         std::cerr << "[GEARS] [FATAL]: " << result.getError() << '\n';
         return 1;
     }
 
+    app.printReport();
+
+    if (!options.trace.empty()) {
+        if (vke::EngineResult<void> result = vke::trace::exportChromeJson(options.trace); !result) {
+            std::cerr << "[GEARS] [ERROR]: Writing trace failed: " << result.getError() << '\n';
+        }
+    }
+
     std::cout << "[GEARS]: Bye!\n";
     return 0;
 }
@@ -0,0 +1,254 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "engine/MeshData.hpp"
+#include "engine/MeshFile.hpp"
+#include "engine/MeshOptimizer.hpp"
+
+// Converts Wavefront OBJ into the engine's binary mesh format. Output vertices are position, normal and texture
+// coordinate (8 floats); faces without normals get flat ones, missing texture coordinates are zero.
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    constexpr uint32_t VERTEX_STRIDE = 8;
+
+    struct Options {
+        const char* input = nullptr;
+        const char* output = nullptr;
+        bool optimize = true;
+        // OBJ faces are counter clockwise, engine pipeline treats clockwise as front facing under the Y flipped
+        // Mat4::perspective(), so winding is reversed unless asked otherwise
+        bool keepWinding = false;
+    };
+
+    struct ObjData {
+        std::vector<float> positions;
+        std::vector<float> normals;
+        std::vector<float> uvs;
+    };
+
+    // Corner of a face, indexes are zero based with -1 meaning absent
+    struct Corner {
+        long position;
+        long uv;
+        long normal;
+    };
+
+    // OBJ indexes are one based, negative ones count back from the last element read so far
+    long resolveIndex(long index, size_t count) {
+        if (index > 0)
+            return index - 1;
+        if (index < 0)
+            return static_cast<long>(count) + index;
+        return -1;
+    }
+
+    bool parseCorner(const char*& cursor, const ObjData& obj, Corner& corner) {
+        char* end;
+        corner = { -1, -1, -1 };
+
+        corner.position = resolveIndex(std::strtol(cursor, &end, 10), obj.positions.size() / 3);
+        if (end == cursor)
+            return false;
+        cursor = end;
+
+        if (*cursor == '/') {
+            cursor++;
+            if (*cursor != '/') {
+                corner.uv = resolveIndex(std::strtol(cursor, &end, 10), obj.uvs.size() / 2);
+                cursor = end;
+            }
+
+            if (*cursor == '/') {
+                cursor++;
+                corner.normal = resolveIndex(std::strtol(cursor, &end, 10), obj.normals.size() / 3);
+                cursor = end;
+            }
+        }
+
+        return corner.position >= 0 && static_cast<size_t>(corner.position) < obj.positions.size() / 3 &&
+               (corner.uv < 0 || static_cast<size_t>(corner.uv) < obj.uvs.size() / 2) &&
+               (corner.normal < 0 || static_cast<size_t>(corner.normal) < obj.normals.size() / 3);
+    }
+
+    void addVertex(vke::MeshData& mesh, const ObjData& obj, const Corner& corner, const float* faceNormal) {
+        const float* position = &obj.positions[corner.position * 3];
+        const float* normal = corner.normal >= 0 ? &obj.normals[corner.normal * 3] : faceNormal;
+
+        mesh.vertices.insert(mesh.vertices.end(), position, position + 3);
+        mesh.vertices.insert(mesh.vertices.end(), normal, normal + 3);
+
+        if (corner.uv >= 0) {
+            mesh.vertices.push_back(obj.uvs[corner.uv * 2]);
+            // OBJ puts v = 0 at the bottom of the image, Vulkan at the top
+            mesh.vertices.push_back(1.0f - obj.uvs[corner.uv * 2 + 1]);
+        } else {
+            mesh.vertices.push_back(0.0f);
+            mesh.vertices.push_back(0.0f);
+        }
+
+        mesh.indices.push_back(static_cast<uint32_t>(mesh.indices.size()));
+    }
+
+    void computeNormal(const ObjData& obj, const Corner& a, const Corner& b, const Corner& c, float* normal) {
+        const float* pa = &obj.positions[a.position * 3];
+        const float* pb = &obj.positions[b.position * 3];
+        const float* pc = &obj.positions[c.position * 3];
+
+        float e1[3] = { pb[0] - pa[0], pb[1] - pa[1], pb[2] - pa[2] };
+        float e2[3] = { pc[0] - pa[0], pc[1] - pa[1], pc[2] - pa[2] };
+        normal[0] = e1[1] * e2[2] - e1[2] * e2[1];
+        normal[1] = e1[2] * e2[0] - e1[0] * e2[2];
+        normal[2] = e1[0] * e2[1] - e1[1] * e2[0];
+
+        float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        if (length > 0.0f) {
+            for (int i = 0; i < 3; i++) {
+                normal[i] /= length;
+            }
+        }
+    }
+
+    // Unsupported statements (materials, groups, lines) are skipped, every face becomes a triangle fan
+    bool parseObj(const std::string& text, const Options& options, vke::MeshData& mesh) {
+        ObjData obj;
+        std::vector<Corner> face;
+        size_t line = 0;
+
+        for (size_t begin = 0; begin < text.size();) {
+            size_t end = text.find('\n', begin);
+            if (end == std::string::npos) {
+                end = text.size();
+            }
+
+            std::string_view statement(text.data() + begin, end - begin);
+            const char* cursor = statement.data();
+            begin = end + 1;
+            line++;
+
+            auto readFloats = [&cursor](std::vector<float>& out, int count) {
+                for (int i = 0; i < count; i++) {
+                    char* next;
+                    out.push_back(std::strtof(cursor, &next));
+                    cursor = next;
+                }
+            };
+
+            if (statement.starts_with("v ")) {
+                cursor += 2;
+                readFloats(obj.positions, 3);
+            } else if (statement.starts_with("vn ")) {
+                cursor += 3;
+                readFloats(obj.normals, 3);
+            } else if (statement.starts_with("vt ")) {
+                cursor += 3;
+                readFloats(obj.uvs, 2);
+            } else if (statement.starts_with("f ")) {
+                cursor += 2;
+                face.clear();
+
+                const char* last = statement.data() + statement.size();
+                while (true) {
+                    while (cursor < last && (*cursor == ' ' || *cursor == '\t' || *cursor == '\r')) {
+                        cursor++;
+                    }
+                    if (cursor >= last)
+                        break;
+
+                    Corner corner;
+                    if (!parseCorner(cursor, obj, corner)) {
+                        std::cerr << "[MESHCONV] [ERROR]: Invalid face at line " << line << '\n';
+                        return false;
+                    }
+                    face.push_back(corner);
+                }
+
+                for (size_t i = 2; i < face.size(); i++) {
+                    float normal[3];
+                    computeNormal(obj, face[0], face[i - 1], face[i], normal);
+
+                    addVertex(mesh, obj, face[0], normal);
+                    if (options.keepWinding) {
+                        addVertex(mesh, obj, face[i - 1], normal);
+                        addVertex(mesh, obj, face[i], normal);
+                    } else {
+                        addVertex(mesh, obj, face[i], normal);
+                        addVertex(mesh, obj, face[i - 1], normal);
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool parseOptions(int argc, char* argv[], Options& options) {
+        for (int i = 1; i < argc; i++) {
+            std::string_view argument = argv[i];
+
+            if (argument == "--no-optimize") {
+                options.optimize = false;
+            } else if (argument == "--keep-winding") {
+                options.keepWinding = true;
+            } else if (argument.starts_with("--")) {
+                return false;
+            } else if (!options.input) {
+                options.input = argv[i];
+            } else if (!options.output) {
+                options.output = argv[i];
+            } else {
+                return false;
+            }
+        }
+
+        return options.input && options.output;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0] << " <input.obj> <output.vkem> [--no-optimize] [--keep-winding]\n";
+        return 1;
+    }
+
+    auto start = Clock::now();
+
+    std::ifstream input(options.input, std::ios::binary);
+    if (input.fail()) {
+        std::cerr << "[MESHCONV] [ERROR]: Can not open " << options.input << '\n';
+        return 1;
+    }
+
+    std::stringstream contents;
+    contents << input.rdbuf();
+
+    vke::MeshData mesh;
+    mesh.vertexStride = VERTEX_STRIDE;
+    if (!parseObj(contents.str(), options, mesh))
+        return 1;
+
+    if (options.optimize) {
+        std::cout << "[MESHCONV]: " << vke::MeshOptimizer::optimize(mesh) << '\n';
+    } else {
+        vke::MeshOptimizer::deduplicateVertices(mesh);
+    }
+
+    if (vke::EngineResult<void> result = vke::MeshFile::write(options.output, mesh); !result) {
+        std::cerr << "[MESHCONV] [ERROR]: " << result.getError() << '\n';
+        return 1;
+    }
+
+    std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+    std::cout << "[MESHCONV]: Wrote " << options.output << ", " << mesh.getVertexCount() << " vertices, "
+              << mesh.indices.size() / 3 << " triangles in " << elapsed.count() << " ms\n";
+
+    return 0;
+}
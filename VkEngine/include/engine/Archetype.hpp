@@ -0,0 +1,74 @@
+#ifndef ARCHETYPE_HPP
+#define ARCHETYPE_HPP
+
+#include <array>
+#include <memory>
+#include <vector>
+#include "engine/ComponentRegistry.hpp"
+
+namespace vke {
+
+    struct Entity {
+        uint32_t index;
+        uint32_t generation;
+
+        bool operator==(const Entity& other) const = default;
+    };
+
+    // All entities sharing one component signature. They are packed into fixed size chunks, and every chunk holds
+    // one contiguous column per component, so iterating a component touches only its own memory.
+    class Archetype {
+    public:
+        static constexpr size_t CHUNK_BYTES = 16 * 1024;
+        static constexpr uint32_t NO_COLUMN = UINT32_MAX;
+
+        struct Chunk {
+            std::unique_ptr<std::byte[]> data;
+            uint32_t count;
+        };
+
+        struct Location {
+            uint32_t chunk;
+            uint32_t row;
+        };
+
+    private:
+        Signature mSignature;
+        std::vector<ComponentId> mComponents;
+        std::array<uint32_t, ComponentRegistry::MAX_COMPONENTS> mColumnOffsets;
+        uint32_t mCapacity;
+        // CHUNK_BYTES unless a single entity needs more
+        size_t mChunkBytes;
+        // every chunk except the last one is always full
+        std::vector<Chunk> mChunks;
+        size_t mSize;
+
+    public:
+        explicit Archetype(Signature signature);
+
+        Signature getSignature() const;
+        const std::vector<ComponentId>& getComponents() const;
+        bool hasComponent(ComponentId id) const;
+        uint32_t getChunkCapacity() const;
+        size_t getChunkBytes() const;
+        size_t getChunkCount() const;
+        size_t size() const;
+
+        Location allocate(Entity entity);
+        // Fills the hole with the last entity of the archetype, returns entity that moved into location
+        // (or the removed one when it was the last)
+        Entity remove(Location location);
+
+        uint32_t getCount(size_t chunk) const;
+        Entity* getEntities(size_t chunk);
+        void* getColumn(size_t chunk, ComponentId id);
+        void* getComponent(Location location, ComponentId id);
+
+        template<typename T>
+        T* getColumn(size_t chunk) {
+            return static_cast<T*>(getColumn(chunk, ComponentRegistry::id<T>()));
+        }
+    };
+}
+
+#endif
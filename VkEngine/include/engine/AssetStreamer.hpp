@@ -0,0 +1,162 @@
+#ifndef ASSETSTREAMER_HPP
+#define ASSETSTREAMER_HPP
+
+#include <vulkan/vulkan.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <thread>
+#include <vector>
+#include "engine/EngineResult.hpp"
+#include "engine/MemoryType.hpp"
+#include "engine/Mesh.hpp"
+
+namespace vke {
+
+    // Loads assets in the background so the frame loop never waits on disk. Files are read in batches through
+    // io_uring (or a pool of threads doing blocking reads when io_uring is unavailable) straight into a persistently
+    // mapped staging ring, validated in place on worker threads and copied into device local buffers at the start
+    // of a frame, a bounded number of bytes per frame.
+    //
+    // load*(), get*(), takeFinished() and record() belong to the render thread, everything else happens internally.
+    class AssetStreamer {
+    public:
+        using Handle = uint32_t;
+
+        enum class State {
+            LOADING,
+            READY,
+            FAILED
+        };
+
+        struct Stats {
+            uint64_t requested;
+            uint64_t uploaded;
+            uint64_t failed;
+            uint64_t bytesRead;
+            uint64_t bytesUploaded;
+            bool ioRing;
+        };
+
+    private:
+        static constexpr uint64_t NO_STAGING = UINT64_MAX;
+
+        // state and mesh are only touched by the render thread, the rest by whoever currently holds the asset
+        struct Asset {
+            Handle handle;
+            std::filesystem::path path;
+            State state = State::LOADING;
+            Mesh mesh;
+            std::optional<EngineError> error;
+            // device local, created while decoding so record() only has to copy into them
+            Buffer vertexBuffer;
+            Buffer indexBuffer;
+            // staging block holding the file contents
+            uint64_t stagingOffset = NO_STAGING;
+            uint64_t size = 0;
+        };
+
+        struct StagingBlock {
+            uint64_t offset;
+            uint64_t size;
+            bool released;
+        };
+
+        VkDevice mDevice;
+        MemoryType mDeviceMemoryType;
+        VkBuffer mStagingBuffer;
+        VkDeviceMemory mStagingMemory;
+        char* mStagingData;
+        uint64_t mStagingSize;
+        bool mStagingCoherent;
+        uint64_t mFrameBudget;
+
+        // owned by the render thread
+        std::deque<Asset> mAssets;
+        std::vector<Handle> mFinished;
+        // staging blocks copied from by each frame in flight, released once that frame finished
+        std::vector<std::vector<uint64_t>> mFrameReleases;
+
+        // mesh buffers are suballocated from shared blocks, the last block fills front to back
+        std::mutex mDeviceMutex;
+        std::vector<VkBuffer> mBuffers;
+        std::vector<VkDeviceMemory> mMemoryAllocations;
+        VkDeviceMemory mDeviceBlock;
+        uint64_t mDeviceBlockUsed;
+
+        // blocks in allocation order, space between the last and first block is free
+        std::mutex mStagingMutex;
+        std::condition_variable mStagingFreed;
+        std::deque<StagingBlock> mBlocks;
+
+        std::mutex mQueueMutex;
+        std::condition_variable mRequestsChanged;
+        std::condition_variable mJobsChanged;
+        // files waiting to be opened and read
+        std::deque<Asset*> mRequests;
+        // validated (or failed), waiting for record() to upload them
+        std::deque<Asset*> mDecoded;
+        std::deque<std::function<void()>> mJobs;
+        bool mStopping;
+
+        std::thread mIoThread;
+        std::vector<std::thread> mWorkers;
+        std::atomic<bool> mIoRing;
+
+        std::atomic<uint64_t> mBytesRead;
+        Stats mStats;
+
+        void runIo();
+        void runWorker();
+        void schedule(std::function<void()> job);
+        // Validates file contents in staging memory, creates the asset's buffers and hands it over to record()
+        void decode(Asset* asset);
+        void fail(Asset* asset, EngineError&& error);
+        // wait blocks until the ring has room, nullopt when it does not or streamer is stopping
+        std::optional<uint64_t> allocateStaging(uint64_t size, bool wait);
+        void releaseStaging(uint64_t offset);
+        void readBlocking(Asset* asset);
+        // Safe to call from any thread
+        EngineResult<Buffer> createBuffer(VkBufferUsageFlags usage, uint64_t size);
+        // Records copies from the asset's staging block into its device local buffers
+        void upload(VkCommandBuffer cmdBuffer, Asset* asset);
+
+    public:
+        AssetStreamer();
+
+        // stagingMemoryType must be host visible, frameCount is the number of frames in flight. workerCount 0 picks
+        // hardware concurrency minus one for the render thread.
+        EngineResult<void> init(VkDevice device, MemoryType stagingMemoryType, MemoryType deviceMemoryType, uint64_t stagingSize, size_t frameCount, uint32_t workerCount = 0);
+        // Device must be idle
+        void cleanup();
+
+        // Upload bytes per frame, an asset larger than this still goes through alone
+        void setFrameBudget(uint64_t bytes);
+
+        // Binary mesh file, see MeshFile
+        Handle loadMesh(std::filesystem::path path);
+
+        State getState(Handle handle) const;
+        // nullptr until the handle is READY
+        Mesh* getMesh(Handle handle);
+        // Set when the handle FAILED
+        const EngineError* getError(Handle handle) const;
+        // Handles that became READY or FAILED since the last call
+        std::vector<Handle> takeFinished();
+
+        // Call at the start of a frame outside of rendering, after the frame's fence was waited on. Records copies of
+        // decoded assets followed by a barrier making them visible to vertex input, assets are READY right after.
+        EngineResult<void> record(VkCommandBuffer cmdBuffer, size_t frame);
+
+        const Stats& getStats();
+    };
+
+    std::ostream& operator<<(std::ostream& stream, const AssetStreamer::Stats& stats);
+}
+
+#endif
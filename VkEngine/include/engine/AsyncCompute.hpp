@@ -0,0 +1,79 @@
+#ifndef ASYNCCOMPUTE_HPP
+#define ASYNCCOMPUTE_HPP
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <functional>
+#include "engine/EngineResult.hpp"
+
+namespace vke {
+
+    // Runs compute work on a dedicated compute queue so it overlaps with graphics, results are handed over to the
+    // graphics queue with semaphores and queue family ownership transfers. Without a dedicated queue the same work
+    // is recorded inline at the start of the graphics command buffer.
+    class AsyncCompute {
+    public:
+        // frame is the frame in flight the work is submitted with, use it to pick per-frame resources
+        using Job = std::function<void(VkCommandBuffer cmdBuffer, size_t frame)>;
+
+    private:
+        struct Release {
+            std::vector<VkBuffer> buffers;
+            VkPipelineStageFlags2 dstStage;
+            VkAccessFlags2 dstAccess;
+        };
+
+        struct FrameRelease {
+            VkBuffer buffer;
+            VkPipelineStageFlags2 dstStage;
+            VkAccessFlags2 dstAccess;
+        };
+
+        struct Frame {
+            VkCommandBuffer cmdBuffer = VK_NULL_HANDLE;
+            VkSemaphore finishedSemaphore = VK_NULL_HANDLE;
+            // releases submitted with this frame, graphics side has to acquire exactly these
+            std::vector<FrameRelease> releases;
+            // jobs waiting to be recorded into graphics command buffer when there is no dedicated queue
+            std::vector<Job> inlineJobs;
+            VkPipelineStageFlags2 waitStage = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+            bool submitted = false;
+        };
+
+        VkDevice mDevice;
+        VkQueue mQueue;
+        uint32_t mComputeFamily;
+        uint32_t mGraphicsFamily;
+        VkCommandPool mCommandPool;
+        std::vector<Frame> mFrames;
+        std::vector<Job> mJobs;
+        std::vector<Release> mReleases;
+
+        void recordJobs(VkCommandBuffer cmdBuffer, std::vector<Job>& jobs, size_t frame);
+
+    public:
+        AsyncCompute();
+
+        // Pass VK_NULL_HANDLE queue to run everything inline on graphics queue
+        EngineResult<void> init(VkDevice device, VkQueue queue, uint32_t computeFamily, uint32_t graphicsFamily, size_t frameCount);
+        void cleanup();
+        bool isAsync() const;
+
+        // Jobs are submitted at the start of the next frame, ahead of its graphics work
+        void schedule(Job job);
+        // Buffers written by scheduled jobs and read by graphics at dstStage, one per frame in flight (or a single one
+        // when graphics is done with it before compute runs again). Jobs must rewrite them completely, previous
+        // contents are not transferred back to compute.
+        void release(std::vector<VkBuffer> buffers, VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess);
+
+        // Records and submits pending jobs, on the async path graphics submit has to wait for getWaitSemaphore()
+        EngineResult<void> submit(size_t frame);
+        // Records ownership acquire barriers (or the inline jobs) at the start of frame's graphics command buffer
+        void acquire(VkCommandBuffer cmdBuffer, size_t frame);
+
+        VkSemaphore getWaitSemaphore(size_t frame) const;
+        VkPipelineStageFlags2 getWaitStage(size_t frame) const;
+    };
+}
+
+#endif
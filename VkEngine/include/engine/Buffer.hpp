@@ -12,6 +12,8 @@ namespace vke {
         VkDeviceMemory mBackingMemory;
         VkDeviceSize mSize;
         bool mNeedsFlushing;
+        // nonCoherentAtomSize of the device when flushing is needed
+        VkDeviceSize mFlushAlignment;
 
     public:
         class MappedScope {
@@ -21,8 +23,11 @@ namespace vke {
             VkMappedMemoryRange mMappedRange;
             char* mData;
             VkDeviceSize mCursor;
+            VkDeviceSize mSize;
+            bool mNeedsFlushing;
+            VkDeviceSize mFlushAlignment;
 
-            MappedScope(VkDevice device, VkMappedMemoryRange mappedRange, char* data);
+            MappedScope(VkDevice device, VkMappedMemoryRange mappedRange, char* data, VkDeviceSize size, bool needsFlushing, VkDeviceSize flushAlignment);
         public:
             MappedScope();
             ~MappedScope();
@@ -31,13 +36,18 @@ namespace vke {
             MappedScope(MappedScope&& other) noexcept;
 
             MappedScope& operator=(const MappedScope& other) = delete;
+            MappedScope& operator=(MappedScope&& other) noexcept;
 
             char& operator[](size_t index);
 
             void put(float* data, size_t size);
+            void write(const void* data, size_t bytes);
+            // Makes host writes to the range visible to the device, does nothing for host coherent memory
+            EngineResult<void> flush(VkDeviceSize offset, VkDeviceSize bytes);
         };
 
-        Buffer(VkDevice device, VkBuffer buffer, VkDeviceMemory backingMemory, VkDeviceSize mSize, bool needsFlushing);
+        // needsFlushing is set for memory that is not host coherent, flushAlignment is then the device's nonCoherentAtomSize
+        Buffer(VkDevice device, VkBuffer buffer, VkDeviceMemory backingMemory, VkDeviceSize mSize, bool needsFlushing, VkDeviceSize flushAlignment = 1);
         Buffer();
 
         Buffer(const Buffer& other) = delete;
@@ -48,6 +58,7 @@ namespace vke {
         Buffer& operator=(Buffer&& other) noexcept;
 
         VkBuffer& getHandle();
+        VkDeviceMemory getMemory() const;
         EngineResult<MappedScope> map();
     };
 }
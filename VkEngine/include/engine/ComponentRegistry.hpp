@@ -0,0 +1,45 @@
+#ifndef COMPONENTREGISTRY_HPP
+#define COMPONENTREGISTRY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace vke {
+
+    using ComponentId = uint32_t;
+    // One bit per component id
+    using Signature = uint64_t;
+
+    // Hands out dense ids to component types, components are moved around with memcpy so they must be trivially copyable
+    class ComponentRegistry {
+    public:
+        static constexpr ComponentId MAX_COMPONENTS = 64;
+
+        struct Info {
+            size_t size;
+            size_t alignment;
+        };
+
+        template<typename T>
+        static ComponentId id() {
+            static_assert(std::is_trivially_copyable_v<T>, "Components must be trivially copyable");
+            static_assert(alignof(T) <= alignof(std::max_align_t), "Component alignment exceeds chunk alignment");
+
+            static const ComponentId id = registerComponent(sizeof(T), alignof(T));
+            return id;
+        }
+
+        template<typename... Ts>
+        static Signature signature() {
+            return (Signature{0} | ... | (Signature{1} << id<Ts>()));
+        }
+
+        static const Info& getInfo(ComponentId id);
+
+    private:
+        static ComponentId registerComponent(size_t size, size_t alignment);
+    };
+}
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef COMPONENTS_HPP
+#define COMPONENTS_HPP
+
+#include "engine/Mesh.hpp"
+#include "engine/TransformHierarchy.hpp"
+
+namespace vke {
+
+    // Components understood by RenderSystem, apps are free to register their own next to these
+
+    struct Renderable {
+        Mesh* mesh;
+    };
+
+    struct Transform {
+        TransformHierarchy::Node node;
+    };
+
+    // Bounding sphere in mesh local space
+    struct Bounds {
+        float center[3];
+        float radius;
+    };
+}
+
+#endif
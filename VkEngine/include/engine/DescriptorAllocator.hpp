@@ -0,0 +1,67 @@
+#ifndef DESCRIPTORALLOCATOR_HPP
+#define DESCRIPTORALLOCATOR_HPP
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include "engine/EngineResult.hpp"
+
+namespace vke {
+
+    // Hands out descriptor sets from per-frame pools. Sets are never freed one by one,
+    // instead all pools of a frame are reset at once after that frame's fence signals.
+    // Persistent sets come from pools of their own that live until cleanup.
+    class DescriptorAllocator {
+        struct PoolRatio {
+            VkDescriptorType type;
+            float ratio;
+        };
+
+        struct FramePools {
+            std::vector<VkDescriptorPool> usedPools;
+            std::vector<VkDescriptorPool> freePools;
+            VkDescriptorPool currentPool;
+            uint32_t setsPerPool;
+        };
+
+        static constexpr uint32_t INITIAL_SETS_PER_POOL = 64;
+        static constexpr uint32_t MAX_SETS_PER_POOL = 4096;
+        static constexpr PoolRatio POOL_RATIOS[] = {
+                { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2.0f },
+                { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.0f },
+                { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2.0f },
+                { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1.0f },
+                { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4.0f },
+                { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1.0f },
+                { VK_DESCRIPTOR_TYPE_SAMPLER, 0.5f },
+                { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.0f },
+        };
+
+        VkDevice mDevice;
+        std::vector<FramePools> mFrames;
+        FramePools mPersistent;
+        size_t mCurrentFrame;
+
+        EngineResult<VkDescriptorSet> allocate(FramePools& frame, VkDescriptorSetLayout layout);
+        EngineResult<VkDescriptorPool> grabPool(FramePools& frame);
+        EngineResult<VkDescriptorPool> createPool(uint32_t setCount);
+        void destroyPools(FramePools& frame);
+
+    public:
+        DescriptorAllocator();
+
+        DescriptorAllocator(const DescriptorAllocator& other) = delete;
+        DescriptorAllocator& operator=(const DescriptorAllocator& other) = delete;
+
+        void init(VkDevice device, size_t frameCount);
+        void cleanup();
+
+        // Must only be called once the fence guarding the frame has signaled
+        EngineResult<void> resetFrame(size_t frame);
+        // Valid until the current frame is reset again
+        EngineResult<VkDescriptorSet> allocate(VkDescriptorSetLayout layout);
+        // Valid until cleanup, for sets written once and used by every frame
+        EngineResult<VkDescriptorSet> allocatePersistent(VkDescriptorSetLayout layout);
+    };
+}
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef DESCRIPTORLAYOUTCACHE_HPP
+#define DESCRIPTORLAYOUTCACHE_HPP
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <unordered_map>
+#include "engine/EngineResult.hpp"
+
+namespace vke {
+
+    class DescriptorLayoutCache {
+    public:
+        struct LayoutInfo {
+            std::vector<VkDescriptorSetLayoutBinding> bindings;
+            // immutable samplers of all bindings in binding order, pImmutableSamplers point in here
+            std::vector<VkSampler> samplers;
+
+            bool operator==(const LayoutInfo& other) const;
+            size_t hash() const;
+        };
+
+    private:
+        struct LayoutInfoHash {
+            size_t operator()(const LayoutInfo& info) const {
+                return info.hash();
+            }
+        };
+
+        VkDevice mDevice;
+        std::unordered_map<LayoutInfo, VkDescriptorSetLayout, LayoutInfoHash> mLayouts;
+
+    public:
+        DescriptorLayoutCache();
+
+        DescriptorLayoutCache(const DescriptorLayoutCache& other) = delete;
+        DescriptorLayoutCache& operator=(const DescriptorLayoutCache& other) = delete;
+
+        void init(VkDevice device);
+        void cleanup();
+
+        // Returns a layout matching the bindings, creating it only if no equal layout was requested before
+        EngineResult<VkDescriptorSetLayout> getLayout(std::vector<VkDescriptorSetLayoutBinding> bindings);
+    };
+}
+
+#endif
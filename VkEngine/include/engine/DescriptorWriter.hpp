@@ -0,0 +1,29 @@
+#ifndef DESCRIPTORWRITER_HPP
+#define DESCRIPTORWRITER_HPP
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <deque>
+
+namespace vke {
+
+    // Collects descriptor writes and submits all of them with a single vkUpdateDescriptorSets call
+    class DescriptorWriter {
+        // deques keep element addresses stable, so writes can point into them while more are queued
+        std::deque<VkDescriptorBufferInfo> mBufferInfos;
+        std::deque<VkDescriptorImageInfo> mImageInfos;
+        std::vector<VkWriteDescriptorSet> mWrites;
+
+    public:
+        DescriptorWriter();
+
+        DescriptorWriter& writeBuffer(VkDescriptorSet set, uint32_t binding, VkDescriptorType type, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range);
+        DescriptorWriter& writeImage(VkDescriptorSet set, uint32_t binding, VkDescriptorType type, VkImageView view, VkSampler sampler, VkImageLayout layout);
+
+        void update(VkDevice device);
+        void clear();
+        size_t getWriteCount() const;
+    };
+}
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef DRAWCOMMAND_HPP
+#define DRAWCOMMAND_HPP
+
+#include <vulkan/vulkan.h>
+#include <array>
+#include <cstring>
+#include <type_traits>
+#include "engine/PipelineDescription.hpp"
+
+namespace vke {
+
+    struct DrawCommand {
+        // lowest pass is recorded first, only the low 4 bits are used
+        uint8_t pass = 0;
+        // engine pipeline when not set, other pipelines must be created with the engine pipeline layout
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        // bound at materialSetIndex when set, draws sharing it are recorded together
+        VkDescriptorSet materialSet = VK_NULL_HANDLE;
+        uint32_t materialSetIndex = 0;
+        VkBuffer vertexBuffer = VK_NULL_HANDLE;
+        VkDeviceSize vertexOffset = 0;
+        uint32_t vertexCount = 0;
+        uint32_t firstVertex = 0;
+        uint32_t instanceCount = 1;
+        uint32_t firstInstance = 0;
+        // per-instance vertex stream, bound to PipelineDescription::INSTANCE_BINDING when set
+        VkBuffer instanceBuffer = VK_NULL_HANDLE;
+        // indexed when set, vertexCount and firstVertex are then ignored
+        VkBuffer indexBuffer = VK_NULL_HANDLE;
+        VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+        uint32_t indexCount = 0;
+        uint32_t firstIndex = 0;
+        int32_t baseVertex = 0;
+        // view space distance from the camera, draws with the same pass, pipeline and material are recorded nearest first
+        float depth = 0.0f;
+        VkShaderStageFlags pushConstantStages = 0;
+        uint32_t pushConstantSize = 0;
+        std::array<char, PipelineDescription::GUARANTEED_PUSH_CONSTANTS_SIZE> pushConstants{};
+
+        template<typename T>
+        DrawCommand& setPushConstants(VkShaderStageFlags stages, const T& value) {
+            static_assert(std::is_trivially_copyable_v<T>, "Push constant type must be trivially copyable");
+            static_assert(sizeof(T) % 4 == 0, "Push constant size must be a multiple of 4");
+            static_assert(sizeof(T) <= PipelineDescription::GUARANTEED_PUSH_CONSTANTS_SIZE, "Push constant type does not fit in guaranteed push constant space");
+
+            pushConstantStages = stages;
+            pushConstantSize = sizeof(T);
+            std::memcpy(pushConstants.data(), &value, sizeof(T));
+            return *this;
+        }
+    };
+}
+
+#endif
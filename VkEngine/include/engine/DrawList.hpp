@@ -0,0 +1,91 @@
+#ifndef DRAWLIST_HPP
+#define DRAWLIST_HPP
+
+#include <vulkan/vulkan.h>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+#include "engine/DrawCommand.hpp"
+
+namespace vke {
+
+    // Render queue, every draw gets a 64-bit sort key and the list is radix sorted before recording,
+    // so draws sharing state end up next to each other and their binds are issued once
+    class DrawList {
+    public:
+        // key layout from most to least significant bits
+        static constexpr uint32_t PASS_BITS = 4;
+        static constexpr uint32_t PIPELINE_BITS = 12;
+        static constexpr uint32_t MATERIAL_BITS = 16;
+        static constexpr uint32_t DEPTH_BITS = 32;
+
+        struct BindCounts {
+            uint32_t pipelines;
+            uint32_t materials;
+            uint32_t vertexBuffers;
+            uint32_t indexBuffers;
+
+            uint32_t total() const;
+        };
+
+        // Binds recorded by the last record() call next to the binds the same draws would need in submission order
+        struct Stats {
+            uint32_t draws;
+            BindCounts sorted;
+            BindCounts unsorted;
+
+            uint32_t getSaved() const;
+        };
+
+    private:
+        // State a command buffer has bound at some point of the list
+        struct BoundState {
+            VkPipeline pipeline = VK_NULL_HANDLE;
+            VkDescriptorSet material = VK_NULL_HANDLE;
+            uint32_t materialIndex = 0;
+            VkBuffer vertexBuffer = VK_NULL_HANDLE;
+            VkDeviceSize vertexOffset = 0;
+            VkBuffer instanceBuffer = VK_NULL_HANDLE;
+            VkBuffer indexBuffer = VK_NULL_HANDLE;
+            VkIndexType indexType = VK_INDEX_TYPE_UINT16;
+        };
+
+        std::vector<DrawCommand> mDraws;
+        std::vector<uint64_t> mKeys;
+        // draw indices, permuted together with the keys
+        std::vector<uint32_t> mOrder;
+        std::vector<uint64_t> mScratchKeys;
+        std::vector<uint32_t> mScratchOrder;
+        // dense ids handed out in order of first use within a frame
+        std::unordered_map<VkPipeline, uint32_t> mPipelineIds;
+        std::unordered_map<VkDescriptorSet, uint32_t> mMaterialIds;
+        // binds the draws need in submission order, counted as they come in with a null pipeline standing for the default one
+        BoundState mSubmitted;
+        BindCounts mUnsorted;
+        Stats mStats;
+
+        // Moves bound to the state draw needs, returns the BIND_* bits of what changed and adds them to counts
+        static uint32_t bind(BoundState& bound, const DrawCommand& draw, VkPipeline pipeline, BindCounts& counts);
+        uint64_t makeKey(const DrawCommand& draw);
+        void radixSort();
+        // order null means submission order
+        BindCounts replay(VkCommandBuffer cmdBuffer, VkPipelineLayout layout, VkPipeline defaultPipeline, const uint32_t* order) const;
+
+    public:
+        DrawList();
+
+        void submit(const DrawCommand& draw);
+        // Orders draws by pass, pipeline, material and finally depth, nearest first
+        void sort();
+        // Skips binds of state that is already bound and leaves defaultPipeline bound when done,
+        // defaultPipeline is expected to be bound when called
+        void record(VkCommandBuffer cmdBuffer, VkPipelineLayout layout, VkPipeline defaultPipeline);
+        void clear();
+        size_t size() const;
+        const Stats& getStats() const;
+    };
+
+    std::ostream& operator<<(std::ostream& stream, const DrawList::Stats& stats);
+}
+
+#endif
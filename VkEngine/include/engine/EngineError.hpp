@@ -1,57 +1,82 @@
 #ifndef ENGINE_ERROR_HPP
 #define ENGINE_ERROR_HPP
 
-#include <string>
+#include <cstdint>
 #include <ostream>
+#include <system_error>
 #include <vector>
 #include <vulkan/vulkan.h>
 
 namespace vke {
 
+    // A kind plus a code, small and trivially copyable so results carrying it cost no more than the value they hold.
+    // Text belonging to an error is either a string literal or lives out of line in a process wide pool, identical
+    // texts are stored once. Only texts drawn from a small set go to the pool, per call detail like a file path is left
+    // to the caller, which knows what it asked for.
     class EngineError {
     public:
-        enum class Kind {
+        enum class Kind : uint8_t {
             NONE,
             SDL,
             VULKAN,
             OS_ERROR,
             EXTENSIONS_NOT_PRESENT,
             NO_DEVICE,
-            MISSING_VERTEX_SHADER
+            MISSING_VERTEX_SHADER,
+            PUSH_CONSTANTS_TOO_LARGE,
+            FEATURE_NOT_SUPPORTED,
+            INVALID_FILE
         };
 
-        EngineError();
-        EngineError(const EngineError& other);
-        EngineError(EngineError&& other) noexcept;
-        EngineError& operator=(const EngineError&);
-        EngineError& operator=(EngineError&&) noexcept;
-        ~EngineError() noexcept;
+        constexpr EngineError() : mMessage{nullptr}, mCode{0}, mKind{Kind::NONE} {
+        }
 
-        friend std::ostream& operator<<(std::ostream& stream, EngineError& error);
+        constexpr Kind getKind() const {
+            return mKind;
+        }
+
+        friend std::ostream& operator<<(std::ostream& stream, const EngineError& error);
 
         static EngineError fromSdlError(const char* error);
-        static EngineError fromVkError(VkResult result);
+
+        static constexpr EngineError fromVkError(VkResult result) {
+            return EngineError(Kind::VULKAN, result);
+        }
+
         static EngineError extensionsNotPresent(std::vector<const char*> extensions);
-        static EngineError noDevice();
+
+        static constexpr EngineError noDevice() {
+            return EngineError(Kind::NO_DEVICE, 0);
+        }
+
         static EngineError fromOsError(std::error_code code);
-        static EngineError missingVertexShader();
+
+        static constexpr EngineError missingVertexShader() {
+            return EngineError(Kind::MISSING_VERTEX_SHADER, 0);
+        }
+
+        static constexpr EngineError pushConstantsTooLarge() {
+            return EngineError(Kind::PUSH_CONSTANTS_TOO_LARGE, 0);
+        }
+
+        // feature must be a string literal
+        static EngineError featureNotSupported(const char* feature);
+        // File exists but its contents can not be used, reason says why and must be a string literal
+        static EngineError invalidFile(const char* reason);
     private:
-        EngineError(std::string&& str, Kind kind);
-        EngineError(VkResult result, Kind kind);
-        EngineError(std::vector<const char*>&& extensions, Kind kind);
-        EngineError(std::error_code code, Kind kind);
-        EngineError(Kind kind);
+        constexpr EngineError(Kind kind, int32_t code) : mMessage{nullptr}, mCode{code}, mKind{kind} {
+        }
 
-        void swap(EngineError&& other) noexcept;
-        void copy(const EngineError& other);
-        void clear() noexcept;
+        // message must come from the pool or be a string literal
+        EngineError(Kind kind, const char* message);
 
         union {
-            std::string mMessage;
-            VkResult mResult;
-            std::vector<const char*> mExtensions;
-            std::error_code mErrorCode;
+            // pooled text of SDL and EXTENSIONS_NOT_PRESENT errors, literal of FEATURE_NOT_SUPPORTED and INVALID_FILE ones
+            const char* mMessage;
+            const std::error_category* mCategory;
         };
+        // VkResult or OS error value
+        int32_t mCode;
         Kind mKind;
     };
 }
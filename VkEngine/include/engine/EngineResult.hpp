@@ -1,6 +1,7 @@
 #ifndef ENGINERESULT_HPP
 #define ENGINERESULT_HPP
 
+#include <type_traits>
 #include "engine/utils/Result.hpp"
 #include "engine/EngineError.hpp"
 
@@ -8,6 +9,8 @@ namespace vke {
 
     template<typename T>
     using EngineResult = utils::Result<T, EngineError>;
+
+    static_assert(std::is_trivially_copyable_v<EngineResult<void>>, "Results of plain types must stay trivially copyable");
 }
 
 #endif
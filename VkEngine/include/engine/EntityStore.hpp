@@ -0,0 +1,187 @@
+#ifndef ENTITYSTORE_HPP
+#define ENTITYSTORE_HPP
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "engine/Archetype.hpp"
+#include "engine/ComponentRegistry.hpp"
+#include "engine/WorkerPool.hpp"
+
+namespace vke {
+
+    class EntityStore;
+
+    // Structural changes recorded while entities are being iterated (possibly from several threads),
+    // applied in order by EntityStore::applyCommands() at the frame boundary
+    class EntityCommands {
+        std::mutex mMutex;
+        std::vector<std::function<void(EntityStore&)>> mCommands;
+
+        void push(std::function<void(EntityStore&)> command);
+
+    public:
+        template<typename... Ts>
+        void create(const Ts&... components);
+        void destroy(Entity entity);
+        template<typename T>
+        void add(Entity entity, const T& component);
+        template<typename T>
+        void remove(Entity entity);
+
+        void apply(EntityStore& store);
+        bool empty();
+    };
+
+    // Archetype based entity component storage
+    class EntityStore {
+        struct Record {
+            uint32_t archetype;
+            Archetype::Location location;
+            uint32_t generation;
+            bool alive;
+        };
+
+        // archetypes are never destroyed, so indexes into this stay valid
+        std::vector<std::unique_ptr<Archetype>> mArchetypes;
+        std::unordered_map<Signature, uint32_t> mArchetypeIndexes;
+        std::vector<Record> mRecords;
+        std::vector<uint32_t> mFreeIndexes;
+        EntityCommands mCommands;
+        size_t mSize;
+
+        uint32_t getArchetype(Signature signature);
+        Entity allocate(uint32_t archetype);
+        // Moves entity into archetype, copying components both have in common
+        void move(Entity entity, uint32_t archetype);
+        void* addComponent(Entity entity, ComponentId id);
+        void removeComponent(Entity entity, ComponentId id);
+        void* getComponent(Entity entity, ComponentId id);
+
+        template<typename... Ts, typename F>
+        void collectChunks(F&& f) {
+            Signature required = ComponentRegistry::signature<Ts...>();
+
+            for (const std::unique_ptr<Archetype>& archetype : mArchetypes) {
+                if ((archetype->getSignature() & required) != required)
+                    continue;
+
+                for (size_t chunk = 0, count = archetype->getChunkCount(); chunk < count; chunk++) {
+                    f(*archetype, chunk);
+                }
+            }
+        }
+
+    public:
+        EntityStore();
+
+        Entity create();
+        template<typename... Ts>
+        Entity create(const Ts&... components) {
+            Entity entity = allocate(getArchetype(ComponentRegistry::signature<Ts...>()));
+            ((*static_cast<Ts*>(getComponent(entity, ComponentRegistry::id<Ts>())) = components), ...);
+            return entity;
+        }
+
+        // False when entity is no longer alive
+        bool destroy(Entity entity);
+        bool isAlive(Entity entity) const;
+        size_t size() const;
+
+        // Does nothing when entity is no longer alive
+        template<typename T>
+        void add(Entity entity, const T& component) {
+            if (void* data = addComponent(entity, ComponentRegistry::id<T>())) {
+                *static_cast<T*>(data) = component;
+            }
+        }
+
+        template<typename T>
+        void remove(Entity entity) {
+            removeComponent(entity, ComponentRegistry::id<T>());
+        }
+
+        // Pointer is invalidated by any structural change, nullptr when entity is no longer alive or lacks T
+        template<typename T>
+        T* get(Entity entity) {
+            return static_cast<T*>(getComponent(entity, ComponentRegistry::id<T>()));
+        }
+
+        template<typename T>
+        bool has(Entity entity) const {
+            return isAlive(entity) && mArchetypes[mRecords[entity.index].archetype]->hasComponent(ComponentRegistry::id<T>());
+        }
+
+        // f(uint32_t count, const Entity* entities, Ts*... columns) once per chunk having all of Ts
+        template<typename... Ts, typename F>
+        void forEachChunk(F&& f) {
+            collectChunks<Ts...>([&f](Archetype& archetype, size_t chunk) {
+                f(archetype.getCount(chunk), static_cast<const Entity*>(archetype.getEntities(chunk)), archetype.getColumn<Ts>(chunk)...);
+            });
+        }
+
+        // f(Entity, Ts&...) for every entity having all of Ts
+        template<typename... Ts, typename F>
+        void forEach(F&& f) {
+            forEachChunk<Ts...>([&f](uint32_t count, const Entity* entities, Ts*... columns) {
+                for (uint32_t i = 0; i < count; i++) {
+                    f(entities[i], columns[i]...);
+                }
+            });
+        }
+
+        // Same as forEachChunk() with chunks spread over the shared worker pool, threads limits how many take part
+        // (0 for all). Structural changes must go through getCommands().
+        template<typename... Ts, typename F>
+        void parallelForEachChunk(F&& f, uint32_t threads = 0) {
+            struct Task {
+                Archetype* archetype;
+                size_t chunk;
+            };
+
+            std::vector<Task> tasks;
+            collectChunks<Ts...>([&tasks](Archetype& archetype, size_t chunk) {
+                tasks.push_back({ &archetype, chunk });
+            });
+
+            WorkerPool::getShared().run(tasks.size(), [&f, &tasks](size_t i) {
+                Archetype& archetype = *tasks[i].archetype;
+                size_t chunk = tasks[i].chunk;
+                f(archetype.getCount(chunk), static_cast<const Entity*>(archetype.getEntities(chunk)), archetype.getColumn<Ts>(chunk)...);
+            }, threads);
+        }
+
+        EntityCommands& getCommands();
+        // Call at frame boundary, when nothing iterates the store
+        void applyCommands();
+    };
+
+    template<typename... Ts>
+    void EntityCommands::create(const Ts&... components) {
+        push([=](EntityStore& store) {
+            store.create(components...);
+        });
+    }
+
+    template<typename T>
+    void EntityCommands::add(Entity entity, const T& component) {
+        push([=](EntityStore& store) {
+            if (store.isAlive(entity)) {
+                store.add(entity, component);
+            }
+        });
+    }
+
+    template<typename T>
+    void EntityCommands::remove(Entity entity) {
+        push([=](EntityStore& store) {
+            if (store.isAlive(entity)) {
+                store.template remove<T>(entity);
+            }
+        });
+    }
+}
+
+#endif
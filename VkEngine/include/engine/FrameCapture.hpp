@@ -0,0 +1,116 @@
+#ifndef FRAMECAPTURE_HPP
+#define FRAMECAPTURE_HPP
+
+#include <vulkan/vulkan.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+#include "engine/EngineResult.hpp"
+#include "engine/MemoryType.hpp"
+
+namespace vke {
+
+    // Copies rendered images into a ring of host visible buffers and hands them to a worker thread once the frame that
+    // copied them finished, so neither the queue nor the render thread ever waits for a capture. One request is
+    // served per frame, so consecutive requests capture consecutive frames.
+    //
+    // capture() and record() belong to the render thread, encoding and callbacks run on the worker.
+    class FrameCapture {
+    public:
+        enum class Encoding {
+            // 8-bit RGB, stored uncompressed so encoding is little more than a copy
+            PNG,
+            // Tightly packed RGBA8 rows without any header, top row first
+            RAW
+        };
+
+        // Tightly packed RGBA8 rows, top row first
+        using Callback = std::function<void(const uint8_t* pixels, VkExtent2D extent)>;
+
+        struct Stats {
+            uint64_t requested;
+            uint64_t copied;
+            uint64_t delivered;
+            uint64_t failed;
+        };
+
+    private:
+        struct Request {
+            std::filesystem::path path;
+            Encoding encoding;
+            Callback callback;
+        };
+
+        enum class SlotState {
+            FREE,
+            // copy recorded, waiting for its frame to finish
+            RECORDED,
+            // owned by the worker
+            ENCODING
+        };
+
+        struct Slot {
+            VkBuffer buffer = VK_NULL_HANDLE;
+            VkDeviceMemory memory = VK_NULL_HANDLE;
+            char* data = nullptr;
+            uint64_t size = 0;
+            SlotState state = SlotState::FREE;
+            size_t frame = 0;
+            VkFormat format = VK_FORMAT_UNDEFINED;
+            VkExtent2D extent{};
+            Request request;
+        };
+
+        VkDevice mDevice;
+        MemoryType mMemoryType;
+        std::deque<Request> mRequests;
+
+        // slot states are shared with the worker, everything else in a slot belongs to whoever owns it by state
+        std::vector<Slot> mSlots;
+        std::mutex mMutex;
+        std::condition_variable mChanged;
+        std::deque<size_t> mJobs;
+        bool mStopping;
+        std::thread mWorker;
+
+        Stats mStats;
+        std::atomic<uint64_t> mDelivered;
+        std::atomic<uint64_t> mFailed;
+
+        void run();
+        void encode(Slot& slot);
+        EngineResult<void> resize(Slot& slot, uint64_t size);
+
+    public:
+        FrameCapture();
+
+        // memoryType must be host visible, slotCount limits captures on their way back at once
+        EngineResult<void> init(VkDevice device, MemoryType memoryType, uint32_t slotCount);
+        // Device must be idle, captures already copied are still delivered
+        void cleanup();
+
+        void capture(std::filesystem::path path, Encoding encoding = Encoding::PNG);
+        void capture(Callback callback);
+        // Only 8-bit RGBA and BGRA images can be captured
+        static bool isSupported(VkFormat format);
+
+        // Call every frame after the frame's fence was waited on and after the last write to image, outside of
+        // rendering. Hands captures of the frame's previous use to the worker and copies image when a request waits.
+        // Image is returned to layout afterwards and has to support VK_IMAGE_USAGE_TRANSFER_SRC_BIT.
+        EngineResult<void> record(VkCommandBuffer cmdBuffer, size_t frame, VkImage image, VkImageLayout layout, VkFormat format, VkExtent2D extent);
+        // Blocks until the worker has delivered everything handed to it so far
+        void flush();
+
+        const Stats& getStats();
+    };
+
+    std::ostream& operator<<(std::ostream& stream, const FrameCapture::Stats& stats);
+}
+
+#endif
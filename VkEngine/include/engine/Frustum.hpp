@@ -0,0 +1,15 @@
+#ifndef FRUSTUM_HPP
+#define FRUSTUM_HPP
+
+namespace vke {
+
+    // Six normalized planes (nx, ny, nz, d) facing inwards: left, right, bottom, top, near, far
+    struct Frustum {
+        float planes[6][4];
+
+        // Expects column major matrix with 0..1 clip depth
+        static Frustum fromViewProjection(const float* matrix);
+    };
+}
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef FRUSTUMCULLER_HPP
+#define FRUSTUMCULLER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "engine/Frustum.hpp"
+
+namespace vke {
+
+    // CPU frustum culling over bounding volumes kept in structure of arrays layout, so one SIMD iteration tests
+    // 8 (AVX2) or 4 (SSE) objects against a plane. Spheres and boxes are separate sets with their own indices.
+    class FrustumCuller {
+        // boxes are stored as center + half extents, so both sets run through the same kernel
+        struct Volumes {
+            std::vector<float> centerX;
+            std::vector<float> centerY;
+            std::vector<float> centerZ;
+            std::vector<float> extentX;
+            std::vector<float> extentY;
+            std::vector<float> extentZ;
+        };
+
+        Volumes mSpheres;
+        Volumes mBoxes;
+        // per chunk output of parallel runs, kept around to avoid reallocating each frame
+        std::vector<std::vector<uint32_t>> mChunkResults;
+        uint32_t mThreadCount;
+        bool mSimdEnabled;
+
+        void cull(const Volumes& volumes, bool boxes, const Frustum& frustum, std::vector<uint32_t>& visible);
+
+    public:
+        // Sets smaller than this are culled on the calling thread only
+        static constexpr size_t PARALLEL_THRESHOLD = 32768;
+
+        FrustumCuller();
+
+        uint32_t addSphere(const float center[3], float radius);
+        void setSphere(uint32_t index, const float center[3], float radius);
+        uint32_t addBox(const float min[3], const float max[3]);
+        void setBox(uint32_t index, const float min[3], const float max[3]);
+        void clear();
+
+        size_t getSphereCount() const;
+        size_t getBoxCount() const;
+
+        // Threads of the shared worker pool taking part, calling thread included, 0 for all of them
+        void setThreadCount(uint32_t threads);
+        // Scalar path is kept for comparison and for targets without SSE
+        void setSimdEnabled(bool enabled);
+        // Lanes processed per iteration by the compiled in SIMD path, 1 when scalar only
+        static uint32_t getSimdWidth();
+
+        // Replaces contents of visible with ascending indices of volumes intersecting the frustum
+        void cullSpheres(const Frustum& frustum, std::vector<uint32_t>& visible);
+        void cullBoxes(const Frustum& frustum, std::vector<uint32_t>& visible);
+    };
+}
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef GPUCULLING_HPP
+#define GPUCULLING_HPP
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include "engine/Buffer.hpp"
+#include "engine/Mesh.hpp"
+#include "engine/EngineResult.hpp"
+#include "engine/Frustum.hpp"
+
+namespace vke {
+
+    // Layout matches CullObject in shaders/cull.comp (std430)
+    struct GpuCullObject {
+        float center[3];
+        float radius;
+        uint32_t indexCount;
+        uint32_t firstIndex;
+        int32_t vertexOffset;
+        // forwarded as gl_InstanceIndex, so vertex shader can fetch per-object data with it
+        uint32_t firstInstance;
+    };
+
+    // Frustum culling and draw compaction on the GPU, CPU only records a dispatch and one indirect draw per frame
+    // no matter how many objects there are
+    class GpuCulling {
+        struct CullParams {
+            Frustum frustum;
+            uint32_t objectCount;
+            uint32_t padding[3];
+        };
+
+        VkDevice mDevice;
+        VkDescriptorSetLayout mSetLayout;
+        VkPipelineLayout mPipelineLayout;
+        VkPipeline mPipeline;
+        VkDescriptorPool mDescriptorPool;
+        // host copy of the objects, a frame's buffer is refreshed from it once that frame's fence signaled
+        std::vector<GpuCullObject> mObjects;
+        uint64_t mVersion;
+        // one of each per frame in flight, object buffers are read by compute, draw and count buffers written by it
+        // and consumed by indirect draw
+        std::vector<Buffer> mObjectBuffers;
+        std::vector<Buffer::MappedScope> mObjectMappings;
+        std::vector<uint64_t> mUploadedVersions;
+        std::vector<Buffer> mDrawBuffers;
+        std::vector<Buffer> mCountBuffers;
+        // written once in init(), buffers never change
+        std::vector<VkDescriptorSet> mSets;
+        DrawCommand mGeometry;
+        CullParams mParams;
+        uint32_t mMaxObjects;
+
+    public:
+        static constexpr uint32_t WORKGROUP_SIZE = 64;
+
+        GpuCulling();
+
+        // Takes one host visible object buffer and one draw and count buffer per frame in flight
+        EngineResult<void> init(VkDevice device, VkShaderModule shader, VkDescriptorSetLayout setLayout, std::vector<Buffer>&& objectBuffers, std::vector<Buffer>&& drawBuffers, std::vector<Buffer>&& countBuffers, uint32_t maxObjects);
+        // Device must be idle
+        void cleanup();
+        bool isEnabled() const;
+
+        // All culled objects draw from this mesh's buffers, merge geometry into one mesh and use firstIndex/vertexOffset to draw different shapes
+        void setGeometry(Mesh& mesh);
+        // Returns index of the object, or UINT32_MAX when capacity is exhausted
+        uint32_t add(const GpuCullObject& object);
+        void set(uint32_t index, const GpuCullObject& object);
+        void clear();
+        uint32_t getObjectCount() const;
+
+        void setFrustum(const Frustum& frustum);
+
+        // Must be recorded outside of render pass, after frame's fence was waited on
+        EngineResult<void> dispatch(VkCommandBuffer cmdBuffer, size_t frame);
+        void draw(VkCommandBuffer cmdBuffer, size_t frame);
+
+        VkDeviceSize getObjectBufferSize() const;
+        VkDeviceSize getDrawBufferSize() const;
+    };
+}
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef IMAGE_HPP
+#define IMAGE_HPP
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+
+namespace vke {
+
+    // Sampled 2D image with a view over all of its mip levels. Handles are owned by VkEngineApp, same as Buffer.
+    class Image {
+        VkImage mImage;
+        VkImageView mView;
+        VkDeviceMemory mMemory;
+        VkFormat mFormat;
+        VkExtent2D mExtent;
+        uint32_t mMipLevels;
+
+    public:
+        Image(VkImage image, VkImageView view, VkDeviceMemory memory, VkFormat format, VkExtent2D extent, uint32_t mipLevels);
+        Image();
+
+        Image(const Image& other) = delete;
+        Image(Image&& other) noexcept;
+
+        Image& operator=(const Image& other) = delete;
+        Image& operator=(Image&& other) noexcept;
+
+        // Levels of a full chain down to 1x1
+        static uint32_t getMipLevelCount(VkExtent2D extent);
+        static VkExtent2D getMipExtent(VkExtent2D extent, uint32_t level);
+
+        // Copies tightly packed level 0 from source, then fills every further level by blitting the previous one down.
+        // All levels end up in SHADER_READ_ONLY_OPTIMAL, visible to fragment shaders.
+        void recordUpload(VkCommandBuffer cmdBuffer, VkBuffer source, VkDeviceSize offset) const;
+
+        VkImage getHandle() const;
+        VkImageView getView() const;
+        VkDeviceMemory getMemory() const;
+        VkFormat getFormat() const;
+        VkExtent2D getExtent() const;
+        uint32_t getMipLevels() const;
+    };
+}
+
+#endif
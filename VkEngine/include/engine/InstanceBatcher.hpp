@@ -0,0 +1,66 @@
+#ifndef INSTANCEBATCHER_HPP
+#define INSTANCEBATCHER_HPP
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <unordered_map>
+#include <type_traits>
+#include "engine/Mesh.hpp"
+#include "engine/DrawList.hpp"
+
+namespace vke {
+
+    // Gathers per-instance data of identical meshes during a frame, so every mesh ends up as a single instanced draw
+    class InstanceBatcher {
+        // handles of destroyed meshes can come back for new ones, so a batch matches on everything its draw binds
+        struct BatchKey {
+            VkBuffer vertexBuffer;
+            VkBuffer indexBuffer;
+            VkIndexType indexType;
+
+            bool operator==(const BatchKey& other) const = default;
+        };
+
+        struct BatchKeyHash {
+            size_t operator()(const BatchKey& key) const;
+        };
+
+        struct Batch {
+            BatchKey key;
+            // refreshed from the mesh by the first add() of every frame
+            DrawCommand draw;
+            std::vector<char> instances;
+            uint32_t instanceCount;
+        };
+
+        uint32_t mInstanceStride;
+        std::vector<Batch> mBatches;
+        // batches are kept between frames so their instance storage does not have to be reallocated, flush() drops
+        // the ones nothing was added to
+        std::unordered_map<BatchKey, size_t, BatchKeyHash> mBatchIndexes;
+        uint64_t mTotalInstances;
+
+    public:
+        InstanceBatcher();
+
+        void setInstanceStride(uint32_t stride);
+        uint32_t getInstanceStride() const;
+
+        // size must equal the instance stride
+        void add(Mesh& mesh, const void* data, size_t size);
+
+        template<typename T>
+        void add(Mesh& mesh, const T& instance) {
+            static_assert(std::is_trivially_copyable_v<T>, "Instance data must be trivially copyable");
+            add(mesh, &instance, sizeof(T));
+        }
+
+        uint64_t getRequiredBytes() const;
+        // Copies all instance data to mapped memory back to back and queues one draw per non-empty batch, batches that
+        // stayed empty this frame are released
+        void flush(char* mapped, VkBuffer instanceBuffer, DrawList& drawList);
+        void clear();
+    };
+}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef KTX2FILE_HPP
+#define KTX2FILE_HPP
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <filesystem>
+#include "engine/EngineResult.hpp"
+
+namespace vke {
+
+    // Read only memory mapping of a KTX2 texture. Only what maps straight onto a single 2D VkImage is accepted: one
+    // layer, one face, a concrete vkFormat and no supercompression, so levels can be copied to the GPU as they are.
+    class Ktx2File {
+    public:
+        static constexpr uint8_t IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+        struct Header {
+            uint8_t identifier[12];
+            uint32_t vkFormat;
+            uint32_t typeSize;
+            uint32_t pixelWidth;
+            uint32_t pixelHeight;
+            uint32_t pixelDepth;
+            uint32_t layerCount;
+            uint32_t faceCount;
+            // 0 asks the loader to generate mips, the file then holds level 0 only
+            uint32_t levelCount;
+            uint32_t supercompressionScheme;
+            uint32_t dfdByteOffset;
+            uint32_t dfdByteLength;
+            uint32_t kvdByteOffset;
+            uint32_t kvdByteLength;
+            uint64_t sgdByteOffset;
+            uint64_t sgdByteLength;
+        };
+
+        // Level index follows the header, level 0 (the largest) first
+        struct Level {
+            uint64_t byteOffset;
+            uint64_t byteLength;
+            uint64_t uncompressedByteLength;
+        };
+
+    private:
+        const char* mData;
+        size_t mSize;
+
+        Ktx2File(const char* data, size_t size);
+
+    public:
+        Ktx2File();
+        ~Ktx2File();
+
+        Ktx2File(const Ktx2File& other) = delete;
+        Ktx2File(Ktx2File&& other) noexcept;
+
+        Ktx2File& operator=(const Ktx2File& other) = delete;
+        Ktx2File& operator=(Ktx2File&& other) noexcept;
+
+        // Validates header and level index, level contents are trusted
+        static EngineResult<Ktx2File> open(const std::filesystem::path& path);
+        // Checks file contents already in memory, returns why they can not be used or nullptr when they can
+        static const char* validate(const void* data, size_t size);
+
+        const Header& getHeader() const;
+        VkFormat getFormat() const;
+        VkExtent2D getExtent() const;
+        uint32_t getLevelCount() const;
+        const void* getLevelData(uint32_t level) const;
+        uint64_t getLevelBytes(uint32_t level) const;
+    };
+}
+
+#endif
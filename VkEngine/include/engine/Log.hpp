@@ -0,0 +1,97 @@
+#ifndef LOG_HPP
+#define LOG_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <utility>
+
+// Engine log, messages are formatted on the calling thread into a bounded ring and written to stdout by a background
+// thread, so logging never blocks on the console. Messages filtered out by level are never formatted, and when the
+// ring is full messages are dropped and counted instead of waiting for the writer.
+namespace vke::log {
+
+    enum class Level : uint8_t {
+        DEBUG,
+        INFO,
+        WARN,
+        ERROR
+    };
+
+    // Debug messenger output is split by message type so validation noise can be muted on its own
+    enum class Category : uint8_t {
+        ENGINE,
+        VULKAN,
+        VALIDATION,
+        PERFORMANCE
+    };
+
+    inline constexpr size_t CATEGORY_COUNT = 4;
+    // Longer messages are cut off
+    inline constexpr size_t MAX_MESSAGE = 1000;
+
+    struct Stats {
+        uint64_t written;
+        uint64_t dropped;
+        uint64_t suppressed;
+    };
+
+    namespace detail {
+        extern std::atomic<Level> gLevels[CATEGORY_COUNT];
+
+        // Thread local stream writing into a fixed buffer, commit() copies its contents into the ring
+        std::ostream& begin();
+        void commit(Level level, Category category);
+    }
+
+    // Messages of category below level are discarded, DEBUG for the engine and WARN for Vulkan categories by default
+    void setLevel(Category category, Level level);
+
+    inline bool isEnabled(Level level, Category category) {
+        return level >= detail::gLevels[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+    }
+
+    template<typename... Args>
+    void write(Level level, Category category, Args&&... args) {
+        if (!isEnabled(level, category))
+            return;
+
+        std::ostream& stream = detail::begin();
+        (stream << ... << args);
+        detail::commit(level, category);
+    }
+
+    template<typename... Args>
+    void debug(Category category, Args&&... args) {
+        write(Level::DEBUG, category, std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    void info(Category category, Args&&... args) {
+        write(Level::INFO, category, std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    void warn(Category category, Args&&... args) {
+        write(Level::WARN, category, std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    void error(Category category, Args&&... args) {
+        write(Level::ERROR, category, std::forward<Args>(args)...);
+    }
+
+    // Lets through at most limit messages with the same key per second. The first message let through after some were
+    // held back gets their count in suppressed. Keys sharing a table entry may reset each other's count.
+    bool throttle(uint64_t key, uint32_t limit, uint64_t& suppressed);
+
+    // Blocks until every message logged before the call is written
+    void flush();
+
+    Stats getStats();
+
+    std::ostream& operator<<(std::ostream& stream, const Stats& stats);
+}
+
+#endif
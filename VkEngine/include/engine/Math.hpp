@@ -0,0 +1,138 @@
+#ifndef MATH_HPP
+#define MATH_HPP
+
+#include <cmath>
+#include <cstddef>
+
+namespace vke {
+
+    // Vector types laid out like their GLSL counterparts in std140 and std430 blocks, so arrays of them can be
+    // copied into mapped buffers as they are. Vec3 is padded to 16 bytes, which is the vec3 array stride in both
+    // layouts; a lone vec3 member followed by a float packs tighter on the GPU side and needs a Vec4 here instead.
+    struct alignas(16) Vec3 {
+        float x;
+        float y;
+        float z;
+    };
+
+    struct alignas(16) Vec4 {
+        float x;
+        float y;
+        float z;
+        float w;
+    };
+
+    // Unit quaternion, w is the scalar part
+    struct alignas(16) Quat {
+        float x;
+        float y;
+        float z;
+        float w;
+
+        static Quat identity();
+        static Quat fromAxisAngle(Vec3 axis, float radians);
+    };
+
+    // Column major, same as a column_major mat4 in std140 and std430
+    struct alignas(16) Mat4 {
+        Vec4 columns[4];
+
+        static Mat4 identity();
+        static Mat4 translation(Vec3 offset);
+        // Scale first, then rotation, then translation
+        static Mat4 compose(Vec3 position, Quat rotation, Vec3 scale);
+        // 0..1 clip depth with Y flipped for Vulkan, right handed view space looking down -Z
+        static Mat4 perspective(float fovY, float aspect, float near, float far);
+        static Mat4 lookAt(Vec3 eye, Vec3 center, Vec3 up);
+
+        const float* data() const { return &columns[0].x; }
+        float* data() { return &columns[0].x; }
+    };
+
+    struct Aabb {
+        Vec3 min;
+        Vec3 max;
+    };
+
+    static_assert(sizeof(Vec3) == 16 && alignof(Vec3) == 16);
+    static_assert(sizeof(Vec4) == 16 && alignof(Vec4) == 16);
+    static_assert(sizeof(Quat) == 16);
+    static_assert(sizeof(Mat4) == 64);
+    static_assert(sizeof(Aabb) == 32);
+
+    inline Vec3 operator+(Vec3 a, Vec3 b) { return { a.x + b.x, a.y + b.y, a.z + b.z }; }
+    inline Vec3 operator-(Vec3 a, Vec3 b) { return { a.x - b.x, a.y - b.y, a.z - b.z }; }
+    inline Vec3 operator-(Vec3 a) { return { -a.x, -a.y, -a.z }; }
+    inline Vec3 operator*(Vec3 a, float s) { return { a.x * s, a.y * s, a.z * s }; }
+    inline Vec3 operator*(float s, Vec3 a) { return a * s; }
+
+    inline float dot(Vec3 a, Vec3 b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    inline Vec3 cross(Vec3 a, Vec3 b) { return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x }; }
+    inline float length(Vec3 a) { return std::sqrt(dot(a, a)); }
+
+    inline Vec3 normalize(Vec3 a) {
+        float l = length(a);
+        return l > 0.0f ? a * (1.0f / l) : a;
+    }
+
+    inline Vec4 operator+(Vec4 a, Vec4 b) { return { a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w }; }
+    inline Vec4 operator-(Vec4 a, Vec4 b) { return { a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w }; }
+    inline Vec4 operator*(Vec4 a, float s) { return { a.x * s, a.y * s, a.z * s, a.w * s }; }
+    inline float dot(Vec4 a, Vec4 b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+
+    // Applies b first, then a
+    inline Quat operator*(Quat a, Quat b) {
+        return {
+            a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+            a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+            a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+            a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z
+        };
+    }
+
+    inline Quat normalize(Quat q) {
+        float l = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+        return l > 0.0f ? Quat{ q.x / l, q.y / l, q.z / l, q.w / l } : Quat::identity();
+    }
+
+    inline Vec3 rotate(Quat q, Vec3 v) {
+        // v + 2w(u x v) + 2u x (u x v), avoids building the matrix
+        Vec3 u{ q.x, q.y, q.z };
+        Vec3 t = cross(u, v) * 2.0f;
+        return v + t * q.w + cross(u, t);
+    }
+
+    inline Quat Quat::identity() {
+        return { 0.0f, 0.0f, 0.0f, 1.0f };
+    }
+
+    inline Quat Quat::fromAxisAngle(Vec3 axis, float radians) {
+        Vec3 a = normalize(axis) * std::sin(radians * 0.5f);
+        return { a.x, a.y, a.z, std::cos(radians * 0.5f) };
+    }
+
+    Mat4 operator*(const Mat4& a, const Mat4& b);
+    Vec4 operator*(const Mat4& m, Vec4 v);
+    // w = 1, no perspective divide
+    Vec3 transformPoint(const Mat4& m, Vec3 point);
+    // w = 0, translation is ignored
+    Vec3 transformDirection(const Mat4& m, Vec3 direction);
+    // Bounds of the transformed box, not the tightest box around the transformed mesh
+    Aabb transformAabb(const Mat4& m, const Aabb& box);
+
+    // Batched versions, out may be the same array as the input but must not partially overlap it
+    void transformPoints(const Mat4& m, const Vec3* points, Vec3* out, size_t count);
+    // out[i] = a[i] * b[i]
+    void multiplyMatrices(const Mat4* a, const Mat4* b, Mat4* out, size_t count);
+    // out[i] = a * b[i], view projection times model matrices for example
+    void multiplyMatrices(const Mat4& a, const Mat4* b, Mat4* out, size_t count);
+    void transformAabbs(const Mat4& m, const Aabb* boxes, Aabb* out, size_t count);
+
+    // out = a * b on raw column major floats for code keeping matrices in its own arrays, out must not alias a or b
+    void multiply(const float* a, const float* b, float* out);
+
+    // Floats processed per instruction by the batched functions, 1 for the scalar fallback
+    unsigned getMathSimdWidth();
+}
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef MESH_HPP
+#define MESH_HPP
+
+#include <vulkan/vulkan.h>
+#include "engine/Buffer.hpp"
+#include "engine/DrawCommand.hpp"
+
+namespace vke {
+
+    class Mesh {
+        Buffer mVertexBuffer;
+        Buffer mIndexBuffer;
+        VkIndexType mIndexType;
+        uint32_t mIndexCount;
+        uint32_t mVertexCount;
+
+    public:
+        Mesh(Buffer&& vertexBuffer, Buffer&& indexBuffer, VkIndexType indexType, uint32_t indexCount, uint32_t vertexCount);
+        Mesh();
+
+        Mesh(const Mesh& other) = delete;
+        Mesh(Mesh&& other) noexcept = default;
+
+        Mesh& operator=(const Mesh& other) = delete;
+        Mesh& operator=(Mesh&& other) noexcept = default;
+
+        void bind(VkCommandBuffer cmdBuffer);
+        void draw(VkCommandBuffer cmdBuffer, uint32_t instanceCount = 1);
+        DrawCommand makeDraw(float depth = 0.0f);
+
+        VkIndexType getIndexType() const;
+        uint32_t getIndexCount() const;
+        uint32_t getVertexCount() const;
+    };
+}
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef MESHDATA_HPP
+#define MESHDATA_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace vke {
+
+    // CPU side mesh, interleaved float vertices with position in the first three floats of each vertex
+    struct MeshData {
+        std::vector<float> vertices;
+        std::vector<uint32_t> indices;
+        uint32_t vertexStride = 0;
+
+        uint32_t getVertexCount() const {
+            return vertexStride ? static_cast<uint32_t>(vertices.size() / vertexStride) : 0;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef MESHFILE_HPP
+#define MESHFILE_HPP
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <filesystem>
+#include "engine/EngineResult.hpp"
+#include "engine/MeshData.hpp"
+
+namespace vke {
+
+    // Read only memory mapping of a binary mesh file. Vertex and index streams are stored exactly as they go into
+    // the GPU buffers, so loading is a mapping plus one copy per stream with nothing parsed in between.
+    //
+    // Layout, little endian: Header, then the vertex stream, then the index stream, each stream starting at a
+    // multiple of STREAM_ALIGNMENT.
+    class MeshFile {
+    public:
+        static constexpr char MAGIC[4] = { 'V', 'K', 'E', 'M' };
+        // Bump whenever Header or the stream layout changes, files of other versions are rejected
+        static constexpr uint32_t VERSION = 1;
+        static constexpr uint64_t STREAM_ALIGNMENT = 256;
+
+        struct Header {
+            char magic[4];
+            uint32_t version;
+            // floats per vertex
+            uint32_t vertexStride;
+            uint32_t vertexCount;
+            uint32_t indexCount;
+            // 2 or 4 bytes
+            uint32_t indexSize;
+            uint64_t vertexOffset;
+            uint64_t indexOffset;
+            // bounding sphere in mesh space
+            float center[3];
+            float radius;
+        };
+
+    private:
+        const char* mData;
+        size_t mSize;
+
+        MeshFile(const char* data, size_t size);
+
+    public:
+        MeshFile();
+        ~MeshFile();
+
+        MeshFile(const MeshFile& other) = delete;
+        MeshFile(MeshFile&& other) noexcept;
+
+        MeshFile& operator=(const MeshFile& other) = delete;
+        MeshFile& operator=(MeshFile&& other) noexcept;
+
+        // Validates header and stream bounds, contents of the streams are trusted
+        static EngineResult<MeshFile> open(const std::filesystem::path& path);
+        // Picks 16-bit indices whenever vertex count allows it, same as VkEngineApp::createMesh()
+        static EngineResult<void> write(const std::filesystem::path& path, const MeshData& data);
+        // Checks file contents already in memory, returns why they can not be used or nullptr when they can
+        static const char* validate(const void* data, size_t size);
+        static uint64_t getVertexBytes(const Header& header);
+        static uint64_t getIndexBytes(const Header& header);
+        static VkIndexType getIndexType(const Header& header);
+
+        const Header& getHeader() const;
+        const void* getVertices() const;
+        uint64_t getVertexBytes() const;
+        const void* getIndices() const;
+        uint64_t getIndexBytes() const;
+        VkIndexType getIndexType() const;
+    };
+}
+
+#endif
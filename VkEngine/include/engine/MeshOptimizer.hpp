@@ -0,0 +1,38 @@
+#ifndef MESHOPTIMIZER_HPP
+#define MESHOPTIMIZER_HPP
+
+#include <ostream>
+#include "engine/MeshData.hpp"
+
+namespace vke {
+
+    // Import time mesh optimizations, run once before upload
+    class MeshOptimizer {
+    public:
+        static constexpr uint32_t DEFAULT_CACHE_SIZE = 16;
+
+        struct Stats {
+            uint32_t verticesBefore;
+            uint32_t verticesAfter;
+            uint32_t triangles;
+            float acmrBefore;
+            float acmrAfter;
+
+            friend std::ostream& operator<<(std::ostream& stream, const Stats& stats);
+        };
+
+        // Runs every step below in order and reports vertex cache efficiency before and after
+        static Stats optimize(MeshData& mesh, uint32_t cacheSize = DEFAULT_CACHE_SIZE);
+
+        // Merges bitwise identical vertices, builds an index buffer if mesh has none
+        static void deduplicateVertices(MeshData& mesh);
+        // Tipsify (Sander et al. 2007) triangle reordering followed by cluster sort that draws outward facing clusters first
+        static void optimizeVertexCache(MeshData& mesh, uint32_t cacheSize = DEFAULT_CACHE_SIZE);
+        // Reorders vertices by first use so vertex fetch walks memory linearly, drops unreferenced vertices
+        static void optimizeVertexFetch(MeshData& mesh);
+        // Average cache miss ratio, transformed vertices per triangle for FIFO cache of given size
+        static float computeAcmr(const MeshData& mesh, uint32_t cacheSize = DEFAULT_CACHE_SIZE);
+    };
+}
+
+#endif
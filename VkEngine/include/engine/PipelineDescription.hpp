@@ -0,0 +1,64 @@
+#ifndef PIPELINEDESCRIPTION_HPP
+#define PIPELINEDESCRIPTION_HPP
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <type_traits>
+
+namespace vke {
+
+    struct PipelineDescription {
+        // maxPushConstantsSize is at least this big on every conforming device
+        static constexpr uint32_t GUARANTEED_PUSH_CONSTANTS_SIZE = 128;
+        static constexpr uint32_t VERTEX_BINDING = 0;
+        static constexpr uint32_t INSTANCE_BINDING = 1;
+
+        std::vector<std::vector<VkDescriptorSetLayoutBinding>> descriptorSets;
+        std::vector<VkPushConstantRange> pushConstantRanges;
+        // left empty, pipeline falls back to a single binding of position + color
+        std::vector<VkVertexInputBindingDescription> vertexBindings;
+        std::vector<VkVertexInputAttributeDescription> vertexAttributes;
+
+        template<typename T>
+        PipelineDescription& pushConstant(VkShaderStageFlags stages, uint32_t offset = 0) {
+            static_assert(std::is_trivially_copyable_v<T>, "Push constant type must be trivially copyable");
+            static_assert(sizeof(T) % 4 == 0, "Push constant size must be a multiple of 4");
+            static_assert(sizeof(T) <= GUARANTEED_PUSH_CONSTANTS_SIZE, "Push constant type does not fit in guaranteed push constant space");
+
+            pushConstantRanges.push_back({ stages, offset, static_cast<uint32_t>(sizeof(T)) });
+            return *this;
+        }
+
+        PipelineDescription& vertexBinding(uint32_t stride) {
+            vertexBindings.push_back({ VERTEX_BINDING, stride, VK_VERTEX_INPUT_RATE_VERTEX });
+            return *this;
+        }
+
+        // Data in this binding advances once per instance and is fed by the engine's instance batcher
+        PipelineDescription& instanceBinding(uint32_t stride) {
+            vertexBindings.push_back({ INSTANCE_BINDING, stride, VK_VERTEX_INPUT_RATE_INSTANCE });
+            return *this;
+        }
+
+        PipelineDescription& vertexAttribute(uint32_t location, uint32_t binding, VkFormat format, uint32_t offset) {
+            vertexAttributes.push_back({ location, binding, format, offset });
+            return *this;
+        }
+
+        uint32_t getInstanceStride() const {
+            for (const VkVertexInputBindingDescription& binding : vertexBindings) {
+                if (binding.inputRate == VK_VERTEX_INPUT_RATE_INSTANCE)
+                    return binding.stride;
+            }
+
+            return 0;
+        }
+
+        PipelineDescription& descriptorSet(std::vector<VkDescriptorSetLayoutBinding> bindings) {
+            descriptorSets.push_back(std::move(bindings));
+            return *this;
+        }
+    };
+}
+
+#endif
@@ -13,6 +13,8 @@ namespace vke {
             GRAPHICS = 0x1,
             COMPUTE = 0x2,
             PRESENT = 0x4,
+            // compute family without graphics, work submitted there can run alongside rasterization
+            ASYNC_COMPUTE = 0x8,
         };
 
         static QueueFamilyIndexes query(VkPhysicalDevice device, VkSurfaceKHR surface);
@@ -22,18 +24,21 @@ namespace vke {
         bool hasGraphics() const;
         bool hasCompute() const;
         bool hasPresent() const;
+        bool hasAsyncCompute() const;
         uint32_t getIndex(Index index) const;
         uint32_t getGraphics() const;
         uint32_t getCompute() const;
         uint32_t getPresent() const;
+        uint32_t getAsyncCompute() const;
 
     private:
-        QueueFamilyIndexes(uint32_t flags, uint32_t graphics, uint32_t compute, uint32_t present);
+        QueueFamilyIndexes(uint32_t flags, uint32_t graphics, uint32_t compute, uint32_t present, uint32_t asyncCompute);
 
         uint32_t mFlags;
         uint32_t mGraphicsIndex;
         uint32_t mComputeIndex;
         uint32_t mPresentIndex;
+        uint32_t mAsyncComputeIndex;
     };
 }
 
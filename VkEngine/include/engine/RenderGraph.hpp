@@ -0,0 +1,172 @@
+#ifndef RENDERGRAPH_HPP
+#define RENDERGRAPH_HPP
+
+#include <vulkan/vulkan.h>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "engine/EngineResult.hpp"
+#include "engine/MemoryType.hpp"
+
+namespace vke {
+
+    // Frame described as passes declaring which images and buffers they read and write. compile() drops passes
+    // nobody consumes, precomputes barriers as one batch per pass and places transient images with disjoint
+    // lifetimes into the same memory. The graph is compiled once and executed every frame, imported resources
+    // can be swapped between executions.
+    class RenderGraph {
+    public:
+        using Resource = uint32_t;
+        static constexpr Resource NONE = UINT32_MAX;
+
+        // Whether access reads or writes comes from PassBuilder::read() or PassBuilder::write()
+        enum class Access {
+            COLOR_ATTACHMENT,
+            DEPTH_ATTACHMENT,
+            SAMPLED,
+            STORAGE,
+            TRANSFER,
+            INDIRECT,
+            VERTEX,
+            UNIFORM
+        };
+
+        // Layout is ignored for buffers
+        struct State {
+            VkPipelineStageFlags2 stage;
+            VkAccessFlags2 access;
+            VkImageLayout layout;
+        };
+
+        struct ImageDescription {
+            VkFormat format;
+            VkExtent2D extent;
+            VkImageUsageFlags usage;
+            VkImageAspectFlags aspect;
+        };
+
+        using Execute = std::function<EngineResult<void>(VkCommandBuffer cmdBuffer)>;
+
+        class PassBuilder {
+            RenderGraph& mGraph;
+            uint32_t mPass;
+
+        public:
+            PassBuilder(RenderGraph& graph, uint32_t pass);
+
+            PassBuilder& read(Resource resource, Access access);
+            PassBuilder& write(Resource resource, Access access);
+            // Keeps pass alive even when nothing reads what it writes
+            PassBuilder& sideEffect();
+        };
+
+        struct Stats {
+            uint32_t passes;
+            uint32_t culledPasses;
+            uint32_t barrierBatches;
+            uint32_t imageBarriers;
+            uint32_t bufferBarriers;
+            // sum of transient image sizes next to the memory actually allocated for them
+            uint64_t transientBytes;
+            uint64_t allocatedBytes;
+        };
+
+    private:
+        struct ResourceInfo {
+            std::string name;
+            bool isImage;
+            bool imported;
+            ImageDescription description;
+            // state imported resources are in when the graph starts executing
+            State initial;
+            // UNDEFINED leaves imported image in whatever layout its last pass used
+            VkImageLayout finalLayout;
+            VkImage image;
+            VkImageView view;
+            VkBuffer buffer;
+            uint32_t firstPass;
+            uint32_t lastPass;
+        };
+
+        struct Usage {
+            Resource resource;
+            State state;
+            bool read;
+            bool write;
+        };
+
+        struct Pass {
+            std::string name;
+            std::vector<Usage> usages;
+            Execute execute;
+            bool sideEffect;
+            bool culled;
+        };
+
+        struct Barrier {
+            Resource resource;
+            State src;
+            State dst;
+        };
+
+        // transients take turns in the memory of a slot, ordered by first use
+        struct MemorySlot {
+            VkDeviceMemory memory;
+            VkDeviceSize size;
+            uint32_t typeBits;
+            std::vector<Resource> occupants;
+        };
+
+        VkDevice mDevice;
+        MemoryType mMemoryType;
+        std::vector<ResourceInfo> mResources;
+        std::vector<Pass> mPasses;
+        // batch i is recorded before pass i, the extra last batch after all passes
+        std::vector<std::vector<Barrier>> mBatches;
+        std::vector<MemorySlot> mSlots;
+        std::vector<VkImageMemoryBarrier2> mImageBarriers;
+        std::vector<VkBufferMemoryBarrier2> mBufferBarriers;
+        Stats mStats;
+        bool mCompiled;
+
+        static State getState(Access access, bool write, bool image);
+        void addUsage(uint32_t pass, Resource resource, Access access, bool write);
+        void cullPasses();
+        void computeBarriers(std::vector<State>& finalStates);
+        EngineResult<void> allocateTransients(const std::vector<State>& finalStates);
+        void recordBarriers(VkCommandBuffer cmdBuffer, const std::vector<Barrier>& batch);
+        void destroyTransients();
+
+    public:
+        RenderGraph();
+
+        void init(VkDevice device, MemoryType memoryType);
+        void cleanup();
+        // Drops all passes and resources, graph can then be declared again (after swapchain recreation for example)
+        void reset();
+
+        Resource createImage(std::string name, const ImageDescription& description);
+        Resource importImage(std::string name, VkImageAspectFlags aspect, State initial, VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED);
+        // Pending writes to imported buffers must be described by initial, host writes need nothing
+        Resource importBuffer(std::string name, State initial = { VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, VK_IMAGE_LAYOUT_UNDEFINED });
+        void setImage(Resource resource, VkImage image, VkImageView view);
+        void setBuffer(Resource resource, VkBuffer buffer);
+
+        // Passes run in the order they are added
+        PassBuilder addPass(std::string name, Execute execute);
+
+        EngineResult<void> compile();
+        EngineResult<void> execute(VkCommandBuffer cmdBuffer);
+
+        VkImage getImage(Resource resource) const;
+        VkImageView getImageView(Resource resource) const;
+        VkBuffer getBuffer(Resource resource) const;
+        bool isCompiled() const;
+        const Stats& getStats() const;
+    };
+
+    std::ostream& operator<<(std::ostream& stream, const RenderGraph::Stats& stats);
+}
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef RENDERSYSTEM_HPP
+#define RENDERSYSTEM_HPP
+
+#include <vector>
+#include "engine/EntityStore.hpp"
+#include "engine/Components.hpp"
+#include "engine/FrustumCuller.hpp"
+#include "engine/InstanceBatcher.hpp"
+#include "engine/TransformHierarchy.hpp"
+
+namespace vke {
+
+    // Feeds entities with Renderable, Transform and Bounds through CPU frustum culling into instanced draws,
+    // instance data of every visible entity is its world matrix (64 bytes)
+    class RenderSystem {
+        FrustumCuller mCuller;
+        std::vector<Mesh*> mMeshes;
+        std::vector<const float*> mWorlds;
+        std::vector<uint32_t> mVisible;
+
+    public:
+        RenderSystem();
+
+        FrustumCuller& getCuller();
+        // hierarchy must be updated, returns number of visible entities
+        size_t gather(EntityStore& store, const TransformHierarchy& hierarchy, const Frustum& frustum, InstanceBatcher& batcher);
+    };
+}
+
+#endif
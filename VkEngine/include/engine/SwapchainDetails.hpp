@@ -23,6 +23,7 @@ namespace vke {
         VkExtent2D chooseExtent(int winWidth, int winHeight) const;
         uint32_t chooseImageCount() const;
         VkSurfaceTransformFlagBitsKHR getCurrentTransform() const;
+        VkImageUsageFlags getSupportedUsage() const;
     };
 }
 
@@ -0,0 +1,100 @@
+#ifndef TEXTURESTREAMER_HPP
+#define TEXTURESTREAMER_HPP
+
+#include <vulkan/vulkan.h>
+#include <deque>
+#include <filesystem>
+#include <ostream>
+#include <utility>
+#include <vector>
+#include "engine/EngineResult.hpp"
+#include "engine/Ktx2File.hpp"
+#include "engine/MemoryType.hpp"
+
+namespace vke {
+
+    // Streams KTX2 textures into device local images level by level, smallest levels of every texture first, within a
+    // byte budget per frame. A texture's view only covers levels already on the GPU, so sampling is clamped to them
+    // and gets sharper as larger levels arrive.
+    //
+    // Views are replaced whenever a level arrives. Replaced views stay alive until every frame in flight recorded once
+    // more, so descriptor sets written with them stay valid as long as each set is rewritten the next time it is used.
+    class TextureStreamer {
+    public:
+        using Handle = uint32_t;
+
+        struct Stats {
+            uint64_t textures;
+            uint64_t complete;
+            uint64_t bytesUploaded;
+            uint64_t bytesPending;
+        };
+
+    private:
+        struct Texture {
+            Ktx2File file;
+            VkImage image;
+            VkDeviceMemory memory;
+            VkImageView view;
+            VkFormat format;
+            VkExtent2D extent;
+            uint32_t levelCount;
+            // smallest level index with everything on the GPU, levelCount while there is none
+            uint32_t residentLevel;
+            // bytes of level residentLevel - 1 already copied
+            uint64_t levelProgress;
+            VkExtent2D blockExtent;
+            uint64_t copyAlignment;
+        };
+
+        VkDevice mDevice;
+        VkPhysicalDevice mPhysicalDevice;
+        MemoryType mDeviceMemoryType;
+        VkBuffer mStagingBuffer;
+        VkDeviceMemory mStagingMemory;
+        char* mStagingData;
+        bool mStagingCoherent;
+        uint64_t mFrameBudget;
+
+        std::deque<Texture> mTextures;
+        // (bytes of next level, handle) min heap, so small levels of all textures go before any large one
+        std::vector<std::pair<uint64_t, Handle>> mPending;
+        std::vector<Handle> mChanged;
+        // views replaced while recording each frame in flight, destroyed once that frame comes around again
+        std::vector<std::vector<VkImageView>> mRetiredViews;
+        Stats mStats;
+
+        void schedule(Handle handle);
+        EngineResult<VkImageView> createView(const Texture& texture);
+
+    public:
+        TextureStreamer();
+
+        // stagingMemoryType must be host visible, frameBudget bytes are uploaded per frame at most and frameCount is the
+        // number of frames in flight
+        EngineResult<void> init(VkDevice device, VkPhysicalDevice physicalDevice, MemoryType stagingMemoryType, MemoryType deviceMemoryType, uint64_t frameBudget, size_t frameCount);
+        // Device must be idle
+        void cleanup();
+
+        // Maps the file and creates the image with its whole mip chain, levels are uploaded by the following record() calls
+        EngineResult<Handle> load(const std::filesystem::path& path);
+
+        // nullptr until the smallest level arrived, changes whenever another level does
+        VkImageView getView(Handle handle) const;
+        // Largest level currently sampled, 0 once the texture is complete
+        uint32_t getResidentLevel(Handle handle) const;
+        bool isComplete(Handle handle) const;
+        // Handles whose view changed since the last call
+        std::vector<Handle> takeChanged();
+
+        // Call at the start of a frame outside of rendering, after the frame's fence was waited on. Records level copies
+        // within the frame budget, levels that completed are readable by fragment shaders right after.
+        EngineResult<void> record(VkCommandBuffer cmdBuffer, size_t frame);
+
+        const Stats& getStats() const;
+    };
+
+    std::ostream& operator<<(std::ostream& stream, const TextureStreamer::Stats& stats);
+}
+
+#endif
@@ -0,0 +1,146 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <filesystem>
+#include "engine/EngineResult.hpp"
+
+// Scoped CPU and GPU timing exported in Chrome trace format, which chrome://tracing and ui.perfetto.dev both open.
+// Everything below expands to nothing unless the engine is built with VKENGINE_TRACING, so scopes can stay in hot code.
+//
+// Names must outlive the trace, string literals are the intended use.
+#ifdef VKE_TRACING
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+#define VKE_TRACE_CONCAT_INNER(a, b) a##b
+#define VKE_TRACE_CONCAT(a, b) VKE_TRACE_CONCAT_INNER(a, b)
+// Times the rest of the enclosing block on the calling thread
+#define VKE_TRACE_SCOPE(name) ::vke::trace::Scope VKE_TRACE_CONCAT(vkeTraceScope, __LINE__){name}
+// Times commands recorded into cmdBuffer for the rest of the enclosing block, on the GPU track
+#define VKE_TRACE_GPU_SCOPE(cmdBuffer, name) ::vke::trace::GpuScope VKE_TRACE_CONCAT(vkeTraceGpuScope, __LINE__){cmdBuffer, name}
+// Names the calling thread's track
+#define VKE_TRACE_THREAD(name) ::vke::trace::setThreadName(name)
+
+namespace vke::trace {
+
+    // Nanoseconds of the monotonic clock
+    uint64_t now();
+    // Appends to the calling thread's buffer without locking, events past the per thread limit are dropped
+    void record(const char* name, uint64_t begin, uint64_t end);
+    void setThreadName(const char* name);
+
+    struct Track;
+
+    class Scope {
+        const char* mName;
+        uint64_t mBegin;
+
+    public:
+        explicit Scope(const char* name) : mName{name}, mBegin{now()} {
+        }
+
+        ~Scope() {
+            record(mName, mBegin, now());
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+
+    // Timestamp queries of the graphics queue, read back once their frame finished and shifted onto the CPU clock.
+    // GPU starting work no earlier than it was submitted bounds the offset between both clocks, the tightest bound
+    // seen so far is used, which is exact for any frame submitted to an idle queue.
+    //
+    // Scopes recorded while no timeline is initialized are ignored.
+    class GpuTimeline {
+        // queries are relative to the frame's first one
+        struct Pending {
+            const char* name;
+            uint32_t beginQuery;
+            uint32_t endQuery;
+        };
+
+        struct Frame {
+            std::vector<Pending> scopes;
+            uint32_t queryCount = 0;
+            uint64_t submitTime = 0;
+        };
+
+        VkDevice mDevice;
+        VkQueryPool mPool;
+        double mPeriod;
+        uint64_t mMask;
+        uint32_t mFrameQueries;
+        std::vector<Frame> mFrames;
+        size_t mCurrent;
+        bool mRecording;
+        // indexes into the current frame's scopes of scopes still open
+        std::vector<uint32_t> mOpen;
+        std::vector<uint64_t> mResults;
+        int64_t mOffset;
+        bool mCalibrated;
+        Track* mTrack;
+
+        void collect(Frame& frame);
+
+    public:
+        static constexpr uint32_t MAX_FRAME_SCOPES = 256;
+
+        GpuTimeline();
+
+        // Timestamps are not supported by every queue family, the timeline stays inactive then
+        EngineResult<void> init(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t queueFamily, size_t frameCount);
+        // Device must be idle
+        void cleanup();
+
+        // Call at the start of a frame outside of rendering, after the frame's fence was waited on. Emits scopes of
+        // the frame's previous use and makes its queries available again.
+        void record(VkCommandBuffer cmdBuffer, size_t frame);
+        // Call right before the frame is submitted
+        void submitted(size_t frame);
+
+        void begin(VkCommandBuffer cmdBuffer, const char* name);
+        void end(VkCommandBuffer cmdBuffer);
+
+        // Timeline of the engine, nullptr while there is none
+        static GpuTimeline* getActive();
+    };
+
+    class GpuScope {
+        GpuTimeline* mTimeline;
+        VkCommandBuffer mCmdBuffer;
+
+    public:
+        GpuScope(VkCommandBuffer cmdBuffer, const char* name) : mTimeline{GpuTimeline::getActive()}, mCmdBuffer{cmdBuffer} {
+            if (mTimeline)
+                mTimeline->begin(mCmdBuffer, name);
+        }
+
+        ~GpuScope() {
+            if (mTimeline)
+                mTimeline->end(mCmdBuffer);
+        }
+
+        GpuScope(const GpuScope&) = delete;
+        GpuScope& operator=(const GpuScope&) = delete;
+    };
+}
+
+#else
+
+#define VKE_TRACE_SCOPE(name) ((void)0)
+#define VKE_TRACE_GPU_SCOPE(cmdBuffer, name) ((void)0)
+#define VKE_TRACE_THREAD(name) ((void)0)
+
+#endif
+
+namespace vke::trace {
+
+    // Writes every event recorded so far as Chrome trace JSON, safe while other threads keep tracing.
+    // Fails with featureNotSupported when tracing is compiled out.
+    EngineResult<void> exportChromeJson(const std::filesystem::path& path);
+}
+
+#endif
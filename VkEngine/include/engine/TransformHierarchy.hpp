@@ -0,0 +1,88 @@
+#ifndef TRANSFORMHIERARCHY_HPP
+#define TRANSFORMHIERARCHY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vke {
+
+    // Scene transforms as flat arrays ordered so parents always precede their children, world matrices are then
+    // resolved in a single forward pass that only recomputes dirty subtrees
+    class TransformHierarchy {
+    public:
+        // Stable handle, dense storage index of a node changes when hierarchy gets reordered
+        using Node = uint32_t;
+        static constexpr Node NONE = UINT32_MAX;
+        // Column major 4x4 matrix
+        static constexpr size_t MATRIX_SIZE = sizeof(float) * 16;
+
+        // What writeWorld() did, every matrix it copied lies within offset and offset + bytes
+        struct WorldWrite {
+            uint64_t version;
+            size_t offset;
+            size_t bytes;
+        };
+
+    private:
+        // local TRS, one array per component
+        std::vector<float> mPositionX;
+        std::vector<float> mPositionY;
+        std::vector<float> mPositionZ;
+        std::vector<float> mRotationX;
+        std::vector<float> mRotationY;
+        std::vector<float> mRotationZ;
+        std::vector<float> mRotationW;
+        std::vector<float> mScaleX;
+        std::vector<float> mScaleY;
+        std::vector<float> mScaleZ;
+        std::vector<float> mWorld;
+        std::vector<uint32_t> mParents;
+        std::vector<uint8_t> mDirty;
+        // version of the update that last changed node's world matrix, lets writeWorld() skip unchanged nodes
+        std::vector<uint64_t> mChangedAt;
+        std::vector<Node> mNodes;
+        std::vector<uint32_t> mIndexes;
+        uint64_t mId;
+        uint64_t mVersion;
+        bool mNeedsSort;
+        bool mAnyDirty;
+
+        void markDirty(uint32_t index);
+        void sort();
+        uint32_t depth(uint32_t index) const;
+
+    public:
+        TransformHierarchy();
+
+        TransformHierarchy(const TransformHierarchy& other) = delete;
+        TransformHierarchy& operator=(const TransformHierarchy& other) = delete;
+
+        // Parent must already exist
+        Node create(Node parent = NONE);
+        // Leaves node where it is and returns false when parent is node itself or one of its descendants
+        bool setParent(Node node, Node parent);
+        Node getParent(Node node) const;
+        size_t size() const;
+
+        void setPosition(Node node, float x, float y, float z);
+        void setRotation(Node node, float x, float y, float z, float w);
+        void setScale(Node node, float x, float y, float z);
+
+        // Recomputes world matrices of dirty nodes and everything below them
+        void update();
+        const float* getWorld(Node node) const;
+        // Storage index of node, which is also its matrix slot in buffers filled by writeWorld()
+        uint32_t getIndex(Node node) const;
+        uint64_t getVersion() const;
+        // Unique within the process and never reused, tells apart buffers written from different hierarchies
+        uint64_t getId() const;
+
+        // Copies world matrices changed since version into mapped buffer, pass the returned version next time the
+        // same buffer is written (0 copies everything). Buffer needs size() * MATRIX_SIZE bytes. The returned range
+        // is what has to be flushed when the memory is not host coherent.
+        WorldWrite writeWorld(void* mapped, uint64_t version) const;
+    };
+}
+
+#endif
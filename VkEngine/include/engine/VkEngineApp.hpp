@@ -15,27 +15,108 @@
 #include "engine/ShaderFile.hpp"
 #include "engine/EngineResult.hpp"
 #include "engine/Buffer.hpp"
+#include "engine/Image.hpp"
 #include "engine/ShaderModule.hpp"
 #include "engine/MemoryType.hpp"
+#include "engine/DescriptorLayoutCache.hpp"
+#include "engine/DescriptorAllocator.hpp"
+#include "engine/DescriptorWriter.hpp"
+#include "engine/PipelineDescription.hpp"
+#include "engine/DrawList.hpp"
+#include "engine/Mesh.hpp"
+#include "engine/MeshData.hpp"
+#include "engine/MeshFile.hpp"
+#include "engine/InstanceBatcher.hpp"
+#include "engine/GpuCulling.hpp"
+#include "engine/AsyncCompute.hpp"
+#include "engine/AssetStreamer.hpp"
+#include "engine/TextureStreamer.hpp"
+#include "engine/FrameCapture.hpp"
+#include "engine/TransformHierarchy.hpp"
+#include "engine/EntityStore.hpp"
+#include "engine/RenderSystem.hpp"
+#include "engine/RenderGraph.hpp"
+#include "engine/Trace.hpp"
 
 namespace vke {
 
     class VkEngineApp {
+    public:
+        enum class RenderPath {
+            // VkRenderPass + one VkFramebuffer per swapchain image
+            RENDER_PASS,
+            // vkCmdBeginRendering with synchronization2 layout transitions, no framebuffer objects
+            DYNAMIC_RENDERING
+        };
+
+        // What instance and device are created with, from cheapest to most thorough
+        enum class Profile {
+            // No layers and no debug messenger
+            RELEASE,
+            // Validation layer with its default checks
+            DEBUG,
+            // Validation plus shader instrumentation catching out of bounds descriptor and buffer accesses on the GPU
+            GPU_ASSISTED,
+            // Validation plus warnings about usage that is valid but slow
+            BEST_PRACTICES
+        };
+
+    private:
+        // Copy into a texture waiting to be recorded at the start of the next frame
+        struct ImageUpload {
+            Image image;
+            Buffer staging;
+        };
+
+        // Copy of mesh streams from one staging buffer waiting to be recorded at the start of the next frame
+        struct MeshUpload {
+            Buffer staging;
+            VkBuffer vertexBuffer;
+            VkBuffer indexBuffer;
+            uint64_t vertexBytes;
+            uint64_t indexOffset;
+            uint64_t indexBytes;
+        };
+
+        // World matrix buffers of one hierarchy, one per frame in flight
+        struct TransformUploads {
+            std::vector<Buffer> buffers;
+            std::vector<Buffer::MappedScope> mappings;
+            std::vector<uint64_t> sizes;
+            // hierarchy version each buffer was last written at
+            std::vector<uint64_t> versions;
+        };
+
+        // Debug messages with the same ID logged per second at most, the rest is counted
+        static constexpr uint32_t DEBUG_MESSAGE_REPEAT_LIMIT = 10;
+
         SDL_Window* mWindow;
         bool mRunning;
+        bool mSwapchainOutdated;
+        RenderPath mRenderPath;
+        bool mAsyncComputeRequested;
+        bool mWindowHidden;
+        Profile mProfile;
         VkInstance mInstance;
-        VkDebugUtilsMessengerEXT mMessenger;
+        VkDebugUtilsMessengerEXT mMessenger = VK_NULL_HANDLE;
         VkPhysicalDevice mPhysicalDevice;
         VkDevice mDevice;
         VkQueue mGraphicsQueue;
         VkQueue mPresentQueue;
+        VkQueue mAsyncComputeQueue = VK_NULL_HANDLE;
+        uint32_t mAsyncComputeFamily;
         VkSurfaceKHR mSurface;
         VkExtent2D mSwapchainExtent;
         VkFormat mSwapchainImageFormat;
-        VkSwapchainKHR mSwapchain;
+        VkSwapchainKHR mSwapchain = VK_NULL_HANDLE;
+        VkImageUsageFlags mSwapchainUsage = 0;
         std::vector<VkImage> mSwapchainImages;
         std::vector<VkImageView> mSwapchainImageViews;
-        VkRenderPass mRenderPass;
+        VkFormat mDepthFormat;
+        VkImage mDepthImage = VK_NULL_HANDLE;
+        VkDeviceMemory mDepthImageMemory = VK_NULL_HANDLE;
+        VkImageView mDepthImageView = VK_NULL_HANDLE;
+        VkRenderPass mRenderPass = VK_NULL_HANDLE;
         VkPipelineLayout mPipelineLayout;
         VkPipeline mPipeline;
         std::map<VkShaderStageFlagBits, ShaderModule> mShaderModules;
@@ -48,8 +129,43 @@ namespace vke {
         MemoryType mSpeedyMemType;
         MemoryType mStagingMemType;
         MemoryType mUniversalMemType;
+        MemoryType mLazyMemType;
         std::vector<VkBuffer> mBuffers;
         std::vector<VkDeviceMemory> mMemoryAllocations;
+        std::vector<VkImage> mImages;
+        std::vector<VkImageView> mImageViews;
+        std::vector<VkSampler> mSamplers;
+        std::vector<ImageUpload> mImageUploads;
+        std::vector<MeshUpload> mMeshUploads;
+        // staging buffers copied from by each frame in flight, destroyed once that frame finished
+        std::vector<std::vector<Buffer>> mUploadStaging;
+        DescriptorLayoutCache mDescriptorLayoutCache;
+        DescriptorAllocator mDescriptorAllocator;
+        std::vector<VkDescriptorSetLayout> mDescriptorSetLayouts;
+        PipelineDescription mPipelineDescription;
+        DrawList mOpaqueDraws;
+        InstanceBatcher mInstanceBatcher;
+        std::vector<Buffer> mInstanceBuffers;
+        std::vector<Buffer::MappedScope> mInstanceMappings;
+        std::vector<uint64_t> mInstanceBufferSizes;
+        // keyed by TransformHierarchy::getId()
+        std::map<uint64_t, TransformUploads> mTransformUploads;
+        GpuCulling mGpuCulling;
+        VkDescriptorSetLayout mCullingSetLayout = VK_NULL_HANDLE;
+        bool mSupportsIndirectCount = false;
+        AsyncCompute mAsyncCompute;
+        AssetStreamer mAssetStreamer;
+        TextureStreamer mTextureStreamer;
+        FrameCapture mFrameCapture;
+#ifdef VKE_TRACING
+        trace::GpuTimeline mGpuTimeline;
+#endif
+        RenderSystem mRenderSystem;
+        RenderGraph mRenderGraph;
+        RenderGraph::Resource mBackbuffer = RenderGraph::NONE;
+        RenderGraph::Resource mDepth = RenderGraph::NONE;
+        uint32_t mMaxPushConstantsSize;
+        VkDeviceSize mNonCoherentAtomSize;
 
         void handleWindowEvent(SDL_Event& event);
         void cleanup();
@@ -66,17 +182,39 @@ namespace vke {
         EngineResult<std::vector<const char*>> getDeviceExtensions();
         EngineResult<void> createSwapchain();
         EngineResult<void> createImageViews();
+        EngineResult<void> chooseDepthFormat();
+        EngineResult<void> createDepthResources();
+        void destroyDepthResources();
         EngineResult<void> createRenderPass();
         EngineResult<void> createShaderModules();
+        EngineResult<void> createDescriptors();
         EngineResult<void> createPipeline();
         EngineResult<void> createFramebuffers();
         EngineResult<void> createCommandPool();
         EngineResult<void> createCommandBuffers();
         EngineResult<void> createSemaphores();
         EngineResult<void> createFences();
+        EngineResult<void> createAsyncCompute();
+        EngineResult<void> createAssetStreamer();
+        EngineResult<void> createTextureStreamer();
+        EngineResult<void> createFrameCapture();
+        EngineResult<void> createGpuTimeline();
+        void recordUploads(VkCommandBuffer cmdBuffer);
+        EngineResult<void> recreateSwapchain();
+        void destroySwapchain();
+        // framebuffer is used by render pass path, views by dynamic rendering
+        void beginRendering(VkCommandBuffer cmdBuffer, VkFramebuffer framebuffer, VkImageView colorView, VkImageView depthView);
+        void endRendering(VkCommandBuffer cmdBuffer);
+        EngineResult<void> recordScene(VkCommandBuffer cmdBuffer);
+        EngineResult<void> createRenderGraph();
+        EngineResult<void> flushInstances();
         EngineResult<void> renderFrame();
         void setMemoryTypes();
 
+        EngineResult<Mesh> createMesh(const void* vertices, uint64_t vertexBytes, uint32_t vertexCount, const void* indices, VkIndexType indexType, uint32_t indexCount);
+        // out of line so the dispatch table stays private to the engine
+        void pushConstantsData(VkCommandBuffer cmdBuffer, VkShaderStageFlags stages, uint32_t offset, uint32_t size, const void* data);
+
         VKAPI_ATTR static VKAPI_CALL VkBool32 onVulkanDebugMessage(VkDebugUtilsMessageSeverityFlagBitsEXT severity, VkDebugUtilsMessageTypeFlagsEXT type, const VkDebugUtilsMessengerCallbackDataEXT* message, void* data);
 
     protected:
@@ -87,18 +225,114 @@ namespace vke {
         };
 
         static constexpr int MAX_CONCURRENT_FRAMES = 2;
+        // Largest file the asset streamer can load, also how much it can have read ahead of uploads
+        static constexpr uint64_t ASSET_STAGING_SIZE = 64ull << 20;
+        // Texture bytes uploaded per frame at most
+        static constexpr uint64_t TEXTURE_FRAME_BUDGET = 8ull << 20;
+        // Captures on their way back at once, one more than frames in flight keeps every frame capturable
+        static constexpr uint32_t CAPTURE_SLOTS = MAX_CONCURRENT_FRAMES + 1;
 
         virtual int rankPhysicalDevice(VkPhysicalDevice device, VkPhysicalDeviceProperties properties, VkPhysicalDeviceFeatures features);
         virtual EngineResult<std::map<VkShaderStageFlagBits, ShaderFile>> loadShaders() = 0;
         virtual void render(VkCommandBuffer cmdBuffer);
         virtual EngineResult<void> onInit();
+        virtual PipelineDescription describePipeline();
+        // Frame graph of the dynamic rendering path, declared again whenever swapchain is recreated. Default frame is
+        // just the scene pass, overrides can put their own passes around it or render the scene into a transient image.
+        virtual void describeFrame(RenderGraph& graph, RenderGraph::Resource backbuffer, RenderGraph::Resource depth);
+
+        EngineResult<Buffer> allocateBuffer(VkBufferUsageFlags usage, uint64_t size, BufferType type = BufferType::UNIVERSAL);
+        // Uploads mesh with 16-bit indices when vertex count allows it, run MeshOptimizer on data first. Streams go
+        // through staging into device local buffers, the copy is recorded at the start of the next frame and the mesh
+        // can be drawn from then on.
+        EngineResult<Mesh> createMesh(const MeshData& data);
+        // Copies streams from the file mapping into staging with no intermediate vector, uploaded like the MeshData
+        // overload. File can be closed afterwards.
+        EngineResult<Mesh> createMesh(const MeshFile& file);
+        // Device local 2D image with a view over all levels, memory picked like SPEEDY buffers
+        EngineResult<Image> createImage(VkFormat format, VkExtent2D extent, VkImageUsageFlags usage, uint32_t mipLevels = 1);
+        // Tightly packed level 0 goes through staging, the rest of the chain is blitted on the GPU. Copy and blits are
+        // recorded at the start of the next frame, image is ready for sampling in fragment shaders from then on.
+        // Takes 8, 16 and 32 bit per channel color formats, pixels shorter than the extent fail with invalidFile.
+        EngineResult<Image> createTexture(const void* pixels, uint64_t bytes, VkFormat format, VkExtent2D extent, bool mipmapped = true);
+        // Trilinear sampler reaching every mip level
+        EngineResult<VkSampler> createSampler(VkSamplerAddressMode addressMode = VK_SAMPLER_ADDRESS_MODE_REPEAT);
+        // Image must not be used by any frame in flight
+        void destroyImage(Image& image);
+        // Valid for the current frame only, the frame's sets are reset once its fence signals again
+        EngineResult<VkDescriptorSet> allocateDescriptorSet(uint32_t set);
+        // Valid until the engine shuts down, meant for sets created in onInit() and written once
+        EngineResult<VkDescriptorSet> allocatePersistentDescriptorSet(uint32_t set);
+        void updateDescriptorSets(DescriptorWriter& writer);
+        VkPipelineLayout getPipelineLayout() const;
+        // Queued opaque draws are sorted by state and depth and recorded right after render() returns
+        void submitOpaque(const DrawCommand& draw);
+        // Draw and bind counts of the opaque queue as recorded in the last frame
+        const DrawList::Stats& getDrawStats() const;
+        // Instances of the same mesh are merged into one instanced draw per frame, T must match the instance binding stride
+        template<typename T>
+        void submitInstance(Mesh& mesh, const T& instance) {
+            mInstanceBatcher.add(mesh, instance);
+        }
+        void destroyBuffer(Buffer& buffer);
+        // Objects registered through getGpuCulling() are culled by a compute pass and drawn with one indirect count draw,
+        // requires drawIndirectCount, multiDrawIndirect and drawIndirectFirstInstance
+        EngineResult<void> enableGpuCulling(Mesh& geometry, uint32_t maxObjects);
+        GpuCulling& getGpuCulling();
+        // Work runs on the async compute queue when there is one, see AsyncCompute for ordering and ownership rules
+        void scheduleCompute(AsyncCompute::Job job);
+        void releaseToGraphics(std::vector<VkBuffer> buffers, VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess);
+        // Meshes requested here are read and uploaded in the background, uploads are recorded at the start of a frame
+        AssetStreamer& getAssetStreamer();
+        // KTX2 textures streamed in smallest levels first, see TextureStreamer for when views change
+        TextureStreamer& getTextureStreamer();
+        // Swapchain image of a later frame is written to path by a worker, without stalling rendering. Every call
+        // captures the next frame not captured yet.
+        void captureFrame(std::filesystem::path path, FrameCapture::Encoding encoding = FrameCapture::Encoding::PNG);
+        // Same, but pixels go to callback on the worker thread, e.g. to diff them against a reference
+        void captureFrame(FrameCapture::Callback callback);
+        // Captures of offscreen images go through FrameCapture::record() directly
+        FrameCapture& getFrameCapture();
+        VkDevice getDevice() const;
+        VkExtent2D getSwapchainExtent() const;
+        // run() returns after the current frame is finished
+        void stop();
+        VkFormat getSwapchainFormat() const;
+        int getCurrentFrame() const;
+        // Updates hierarchy and copies world matrices changed since this frame's buffer was last written into it,
+        // returns the storage buffer to bind for this frame. Every hierarchy gets buffers of its own, kept until cleanup.
+        EngineResult<VkBuffer> uploadTransforms(TransformHierarchy& hierarchy);
+        // Applies deferred store commands, culls entities with Renderable, Transform and Bounds and submits visible ones
+        // as instances carrying their world matrix, so the instance binding stride must be TransformHierarchy::MATRIX_SIZE
+        size_t drawScene(EntityStore& store, TransformHierarchy& hierarchy, const Frustum& frustum);
+        // Pass recording render() and queued draws with the engine pipeline, target needs the swapchain format.
+        // Add reads of images the scene samples to the returned builder.
+        RenderGraph::PassBuilder addScenePass(RenderGraph& graph, RenderGraph::Resource target, RenderGraph::Resource depth);
 
-        EngineResult<Buffer> allocateBuffer(VkBufferUsageFlagBits usage, uint64_t size, BufferType type = BufferType::UNIVERSAL);
+        // Cheapest way to get per-draw data to shaders, T must match a range declared in describePipeline()
+        template<typename T>
+        void pushConstants(VkCommandBuffer cmdBuffer, VkShaderStageFlags stages, const T& value, uint32_t offset = 0) {
+            static_assert(std::is_trivially_copyable_v<T>, "Push constant type must be trivially copyable");
+            static_assert(sizeof(T) % 4 == 0, "Push constant size must be a multiple of 4");
+            static_assert(sizeof(T) <= PipelineDescription::GUARANTEED_PUSH_CONSTANTS_SIZE, "Push constant type does not fit in guaranteed push constant space");
+
+            pushConstantsData(cmdBuffer, stages, offset, sizeof(T), &value);
+        }
 
     public:
         VkEngineApp();
         ~VkEngineApp();
 
+        // Must be called before create()
+        void setRenderPath(RenderPath path);
+        // Must be called before create(), falls back to graphics queue when device has no dedicated compute family
+        void setAsyncCompute(bool enabled);
+        // Must be called before create(), swapchain still presents to the window, it is just never shown
+        void setWindowHidden(bool hidden);
+        // Must be called before create(), defaults to RELEASE when built with NDEBUG and to DEBUG otherwise
+        void setProfile(Profile profile);
+        Profile getProfile() const;
+
         EngineResult<void> create(int width, int height, const char* title);
         EngineResult<void> run();
     };
@@ -0,0 +1,56 @@
+#ifndef WORKERPOOL_HPP
+#define WORKERPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vke {
+
+    // Threads started once and parked between jobs, for splitting per-frame work without paying thread creation each
+    // frame. One job runs at a time, the calling thread works on it too and returns once every task finished.
+    class WorkerPool {
+        std::vector<std::thread> mThreads;
+        std::mutex mRunMutex;
+        std::mutex mMutex;
+        std::condition_variable mWake;
+        std::condition_variable mDone;
+        // bumped for every job, workers join each job at most once
+        uint64_t mGeneration;
+        const std::function<void(size_t)>* mTask;
+        size_t mCount;
+        std::atomic<size_t> mNext;
+        // workers allowed to join the current job, and how many did
+        uint32_t mHelpers;
+        uint32_t mJoined;
+        uint32_t mActive;
+        bool mStopping;
+
+        void runWorker();
+        void drain();
+
+    public:
+        // 0 starts hardware concurrency minus one, the caller of run() is the remaining thread
+        explicit WorkerPool(uint32_t workers = 0);
+        ~WorkerPool();
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        // Pool shared by the engine's parallel loops, started on first use
+        static WorkerPool& getShared();
+
+        uint32_t getWorkerCount() const;
+
+        // Calls task(i) for every i below count on up to maxThreads threads including the calling one (0 for all) and
+        // waits for them. Must not be called from inside a task.
+        void run(size_t count, const std::function<void(size_t)>& task, uint32_t maxThreads = 0);
+    };
+}
+
+#endif
@@ -2,267 +2,235 @@
 #define RESULT_HPP
 
 #include <memory>
-#include <iostream>
+#include <type_traits>
+#include <utility>
 
-#define TRY(expr) if (auto result = expr; !result) return result; else
+// Returns the error of expr from the calling function, moved out. The checked result stays in scope as `result` for
+// the statement after the macro, take the value with std::move(result).getOk() to avoid copying it.
+#define TRY(expr) if (auto result = expr; !result) [[unlikely]] return result; else
 
 namespace vke::utils {
 
+    namespace detail {
+        // Kept out of line so accessors inline down to a branch
+        [[noreturn]] void fail(const char* message) noexcept;
+    }
+
+    // Either a value or an error. Copies, moves and destruction are trivial whenever they are for both T and E, so
+    // results of plain types are passed around like the plain types themselves.
     template<typename T, typename E>
-    class Result {
+    class [[nodiscard]] Result {
         struct ErrorMarker {};
 
-    public:
-        class Error {
-            E mError;
-
-        public:
-            Error(E&& error) : mError{std::move(error)} {
-            }
-
-            Error(const E& error) : mError{error} {
-            }
-        };
-
-        enum class Kind {
-            NONE,
-            OK,
-            ERROR
-        };
+        static constexpr bool TRIVIALLY_COPYABLE = std::is_trivially_copy_constructible_v<T> && std::is_trivially_copy_constructible_v<E>;
+        static constexpr bool TRIVIALLY_MOVABLE = std::is_trivially_move_constructible_v<T> && std::is_trivially_move_constructible_v<E>;
+        static constexpr bool TRIVIALLY_COPY_ASSIGNABLE = TRIVIALLY_COPYABLE && std::is_trivially_copy_assignable_v<T> && std::is_trivially_copy_assignable_v<E>;
+        static constexpr bool TRIVIALLY_MOVE_ASSIGNABLE = TRIVIALLY_MOVABLE && std::is_trivially_move_assignable_v<T> && std::is_trivially_move_assignable_v<E>;
+        static constexpr bool TRIVIALLY_DESTRUCTIBLE = std::is_trivially_destructible_v<T> && std::is_trivially_destructible_v<E>;
 
-        Result(T&& ok) noexcept : mOk{std::move(ok)}, mKind{Kind::OK} {
+    public:
+        constexpr Result(T&& ok) noexcept : mOk{std::move(ok)}, mIsOk{true} {
         }
 
-        Result(const T& ok) : mOk{ok}, mKind{Kind::OK} {
+        constexpr Result(const T& ok) : mOk{ok}, mIsOk{true} {
         }
 
-        Result(E&& error, ErrorMarker _) : mError{std::move(error)}, mKind{Kind::ERROR} {
+        constexpr Result(E&& error, ErrorMarker) noexcept : mError{std::move(error)}, mIsOk{false} {
         }
 
-        Result(const E& error, ErrorMarker _) : mError{error}, mKind{Kind::ERROR} {
+        constexpr Result(const E& error, ErrorMarker) : mError{error}, mIsOk{false} {
         }
 
-        Result(const Error& wrapped) : mError{wrapped.mError}, mKind{Kind::ERROR} {
-        }
+        constexpr Result(const Result<T, E>& other) requires TRIVIALLY_COPYABLE = default;
 
-        Result(Error&& wrapped) : mError{std::move(wrapped.mError)}, mKind{Kind::ERROR} {
+        constexpr Result(const Result<T, E>& other) : mIsOk{other.mIsOk} {
+            construct(other);
         }
 
-        Result(const Result<T, E>& other) : mKind{other.mKind} {
-            switch(other.mKind) {
-                case Kind::NONE:
-                    break;
-                case Kind::OK:
-                    new (&mOk) T(other.mOk);
-                    break;
-                case Kind::ERROR:
-                    new (&mError) E(other.mError);
-                    break;
-            }
-        }
+        constexpr Result(Result<T, E>&& other) requires TRIVIALLY_MOVABLE = default;
 
-        Result(Result<T, E>&& other) noexcept : mKind{other.mKind} {
-            switch(other.mKind) {
-                case Kind::NONE:
-                    break;
-                case Kind::OK:
-                    new (&mOk) T(std::move(other.mOk));
-                    break;
-                case Kind::ERROR:
-                    new (&mError) E(std::move(other.mError));
-                    break;
-            }
+        constexpr Result(Result<T, E>&& other) noexcept : mIsOk{other.mIsOk} {
+            construct(std::move(other));
         }
 
-        Result& operator=(const Result<T, E>& other) {
+        constexpr Result& operator=(const Result<T, E>& other) requires TRIVIALLY_COPY_ASSIGNABLE = default;
+
+        constexpr Result& operator=(const Result<T, E>& other) {
             if (this != &other) {
-                mKind = other.mKind;
-
-                switch(other.mKind) {
-                    case Kind::NONE:
-                        clear();
-                        break;
-                    case Kind::OK:
-                        mOk = other.mOk;
-                        break;
-                    case Kind::ERROR:
-                        mError = other.mError;
-                        break;
-                }
+                assign(other);
             }
 
             return *this;
         }
 
-        Result& operator=(Result<T, E>&& other) noexcept {
+        constexpr Result& operator=(Result<T, E>&& other) requires TRIVIALLY_MOVE_ASSIGNABLE = default;
+
+        constexpr Result& operator=(Result<T, E>&& other) noexcept {
             if (this != &other) {
-                mKind = other.mKind;
-
-                switch(other.mKind) {
-                    case Kind::NONE:
-                        clear();
-                        break;
-                    case Kind::OK:
-                        mOk = std::move(other.mOk);
-                        break;
-                    case Kind::ERROR:
-                        mError = std::move(other.mError);
-                        break;
-                }
+                assign(std::move(other));
             }
 
             return *this;
         }
 
-        ~Result() noexcept {
+        constexpr ~Result() requires TRIVIALLY_DESTRUCTIBLE = default;
+
+        constexpr ~Result() {
             clear();
         }
 
-        bool isOk() const {
-            return mKind == Kind::OK;
+        constexpr bool isOk() const {
+            return mIsOk;
+        }
+
+        constexpr bool isError() const {
+            return !mIsOk;
+        }
+
+        constexpr T& getOk() & {
+            if (!mIsOk) [[unlikely]]
+                detail::fail("[ENGINE] [FATAL]: ok() called, but Result is not OK\n");
+
+            return mOk;
         }
 
-        bool isError() const {
-            return mKind == Kind::ERROR;
+        constexpr const T& getOk() const& {
+            if (!mIsOk) [[unlikely]]
+                detail::fail("[ENGINE] [FATAL]: ok() called, but Result is not OK\n");
+
+            return mOk;
         }
 
-        T& getOk() {
-            if (isOk())
-                return mOk;
+        constexpr T&& getOk() && {
+            if (!mIsOk) [[unlikely]]
+                detail::fail("[ENGINE] [FATAL]: ok() called, but Result is not OK\n");
 
-            std::cerr << "[ENGINE] [FATAL]: ok() called, but Result is not OK\n";
-            std::terminate();
+            return std::move(mOk);
         }
 
-        const T& getOk() const {
-            return getOk();
+        constexpr E& getError() & {
+            if (mIsOk) [[unlikely]]
+                detail::fail("[ENGINE] [FATAL]: error() called, but Result is not ERROR\n");
+
+            return mError;
         }
 
-        E& getError() {
-            if (isError())
-                return mError;
+        constexpr const E& getError() const& {
+            if (mIsOk) [[unlikely]]
+                detail::fail("[ENGINE] [FATAL]: error() called, but Result is not ERROR\n");
 
-            std::cerr << "[ENGINE] [FATAL]: error() called, but Result is not ERROR\n";
-            std::terminate();
+            return mError;
         }
 
-        const E& getError() const {
-            return getError();
+        constexpr E&& getError() && {
+            if (mIsOk) [[unlikely]]
+                detail::fail("[ENGINE] [FATAL]: error() called, but Result is not ERROR\n");
+
+            return std::move(mError);
         }
 
-        T* operator->() {
-            if (isOk())
-                return &mOk;
+        constexpr T* operator->() {
+            return &getOk();
+        }
 
-            std::cerr << "[ENGINE] [FATAL]: operator->() called, but Result is not OK\n";
-            std::terminate();
+        constexpr const T* operator->() const {
+            return &getOk();
         }
 
-        operator bool() const {
-            return isOk();
+        constexpr explicit operator bool() const {
+            return mIsOk;
         }
 
-        operator Result<void, E>() const& {
-            return isOk() ? Result<void, E>() : Result<void, E>(mError);
+        constexpr operator Result<void, E>() const& {
+            return mIsOk ? Result<void, E>() : Result<void, E>(mError);
         }
 
-        operator Result<void, E>() && {
-            return isOk() ? Result<void, E>() : Result<void, E>(std::move(mError));
+        constexpr operator Result<void, E>() && {
+            return mIsOk ? Result<void, E>() : Result<void, E>(std::move(mError));
         }
 
-        static Result<T, E> ok(T&& ok) {
+        static constexpr Result<T, E> ok(T&& ok) {
             return Result<T, E>(std::move(ok));
         }
 
-        static Result<T, E> ok(const T& ok) {
+        static constexpr Result<T, E> ok(const T& ok) {
             return Result<T, E>(ok);
         }
 
-        static Result<T, E> error(E&& error) {
+        static constexpr Result<T, E> error(E&& error) {
             return Result<T, E>(std::move(error), {});
         }
 
-        static Result<T, E> error(const E& error) {
+        static constexpr Result<T, E> error(const E& error) {
             return Result<T, E>(error, {});
         }
 
     protected:
 
-        void swap(Result<T, E>&& other) noexcept {
-            switch(other.mKind) {
-                case Kind::NONE:
-                    break;
-                case Kind::OK:
-                    new (&mOk) T(std::move(other.mOk));
-//                    mOk = other.mOk;
-                    break;
-                case Kind::ERROR:
-                    new (&mError) E(std::move(other.mError));
-                    break;
+        // Other is a Result<T, E>, expects no member to be alive
+        template<typename Other>
+        constexpr void construct(Other&& other) {
+            if (other.mIsOk) {
+                std::construct_at(&mOk, std::forward<Other>(other).mOk);
+            } else {
+                std::construct_at(&mError, std::forward<Other>(other).mError);
             }
-
-            other.mKind = Kind::NONE;
         }
 
-        void copy(const Result<T, E>& other) {
-            switch (other.mKind) {
-                case Kind::NONE:
-                    break;
-                case Kind::OK:
-                    mOk = other.mOk;
-                    break;
-                case Kind::ERROR:
-                    mError = other.mError;
-                    break;
+        template<typename Other>
+        constexpr void assign(Other&& other) {
+            if (mIsOk == other.mIsOk) {
+                if (mIsOk) {
+                    mOk = std::forward<Other>(other).mOk;
+                } else {
+                    mError = std::forward<Other>(other).mError;
+                }
+            } else {
+                clear();
+                construct(std::forward<Other>(other));
+                mIsOk = other.mIsOk;
             }
         }
 
-        void clear() noexcept {
-            switch (mKind) {
-                case Kind::NONE:
-                    break;
-                case Kind::OK:
-                    mOk.T::~T();
-                    break;
-                case Kind::ERROR:
-                    mError.E::~E();
-                    break;
+        constexpr void clear() noexcept {
+            if (mIsOk) {
+                std::destroy_at(&mOk);
+            } else {
+                std::destroy_at(&mError);
             }
-
-            mKind = Kind::NONE;
         }
 
         union {
             T mOk;
             E mError;
         };
-        Kind mKind;
+        bool mIsOk;
     };
 
     struct OkMarker {};
 
     template<typename E>
-    class Result<void, E> : public Result<OkMarker, E> {
+    class [[nodiscard]] Result<void, E> : public Result<OkMarker, E> {
     public:
-        static Result<void, E> ok() {
+        static constexpr Result<void, E> ok() {
             return Result<void, E>();
         }
 
-        static Result<void, E> error(E&& error) {
+        static constexpr Result<void, E> error(E&& error) {
             return Result<void, E>(std::move(error));
         }
 
-        static Result<void, E> error(const E& error) {
+        static constexpr Result<void, E> error(const E& error) {
             return Result<void, E>(error);
         }
 
-        Result() : Result<OkMarker, E>(OkMarker{}) {
+        constexpr Result() : Result<OkMarker, E>(OkMarker{}) {
         }
 
-        Result(E&& error) : Result<OkMarker, E>(std::move(error), {}) {
+        constexpr Result(E&& error) : Result<OkMarker, E>(std::move(error), {}) {
         }
 
-        Result(const E& error) : Result<OkMarker, E>(error, {}) {
+        constexpr Result(const E& error) : Result<OkMarker, E>(error, {}) {
         }
     };
 }
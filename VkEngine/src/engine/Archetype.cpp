@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include "engine/Archetype.hpp"
+
+namespace vke {
+
+    namespace {
+        size_t alignUp(size_t value, size_t alignment) {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+    }
+
+    Archetype::Archetype(Signature signature) : mSignature{signature}, mComponents{}, mColumnOffsets{}, mCapacity{0}, mChunkBytes{CHUNK_BYTES}, mChunks{}, mSize{0} {
+        mColumnOffsets.fill(NO_COLUMN);
+
+        size_t bytesPerEntity = sizeof(Entity);
+        for (Signature bits = signature; bits != 0; bits &= bits - 1) {
+            ComponentId id = std::countr_zero(bits);
+            mComponents.push_back(id);
+            bytesPerEntity += ComponentRegistry::getInfo(id).size;
+        }
+
+        // start from the unpadded estimate and shrink until aligned columns fit
+        for (mCapacity = std::max<size_t>(CHUNK_BYTES / bytesPerEntity, 1); ; mCapacity--) {
+            size_t offset = sizeof(Entity) * mCapacity;
+            for (ComponentId id : mComponents) {
+                const ComponentRegistry::Info& info = ComponentRegistry::getInfo(id);
+                offset = alignUp(offset, info.alignment);
+                mColumnOffsets[id] = offset;
+                offset += info.size * mCapacity;
+            }
+
+            if (offset <= CHUNK_BYTES)
+                break;
+
+            // components too large for a shared chunk get chunks of one entity sized to fit
+            if (mCapacity == 1) {
+                mChunkBytes = offset;
+                break;
+            }
+        }
+    }
+
+    Signature Archetype::getSignature() const {
+        return mSignature;
+    }
+
+    const std::vector<ComponentId>& Archetype::getComponents() const {
+        return mComponents;
+    }
+
+    bool Archetype::hasComponent(ComponentId id) const {
+        return (mSignature >> id) & 1;
+    }
+
+    uint32_t Archetype::getChunkCapacity() const {
+        return mCapacity;
+    }
+
+    size_t Archetype::getChunkBytes() const {
+        return mChunkBytes;
+    }
+
+    size_t Archetype::getChunkCount() const {
+        return mChunks.size();
+    }
+
+    size_t Archetype::size() const {
+        return mSize;
+    }
+
+    Archetype::Location Archetype::allocate(Entity entity) {
+        if (mChunks.empty() || mChunks.back().count == mCapacity) {
+            mChunks.push_back({ std::make_unique<std::byte[]>(mChunkBytes), 0 });
+        }
+
+        uint32_t chunk = mChunks.size() - 1;
+        uint32_t row = mChunks.back().count++;
+        getEntities(chunk)[row] = entity;
+        mSize++;
+
+        return { chunk, row };
+    }
+
+    Entity Archetype::remove(Location location) {
+        uint32_t lastChunk = mChunks.size() - 1;
+        uint32_t lastRow = mChunks.back().count - 1;
+
+        Entity moved = getEntities(lastChunk)[lastRow];
+        if (location.chunk != lastChunk || location.row != lastRow) {
+            getEntities(location.chunk)[location.row] = moved;
+
+            for (ComponentId id : mComponents) {
+                size_t size = ComponentRegistry::getInfo(id).size;
+                std::memcpy(getComponent(location, id), getComponent({ lastChunk, lastRow }, id), size);
+            }
+        }
+
+        mSize--;
+        if (--mChunks.back().count == 0) {
+            mChunks.pop_back();
+        }
+
+        return moved;
+    }
+
+    uint32_t Archetype::getCount(size_t chunk) const {
+        return mChunks[chunk].count;
+    }
+
+    Entity* Archetype::getEntities(size_t chunk) {
+        return reinterpret_cast<Entity*>(mChunks[chunk].data.get());
+    }
+
+    void* Archetype::getColumn(size_t chunk, ComponentId id) {
+        return mChunks[chunk].data.get() + mColumnOffsets[id];
+    }
+
+    void* Archetype::getComponent(Location location, ComponentId id) {
+        return static_cast<std::byte*>(getColumn(location.chunk, id)) + ComponentRegistry::getInfo(id).size * location.row;
+    }
+}
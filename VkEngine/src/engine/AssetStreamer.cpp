@@ -0,0 +1,678 @@
+#include <algorithm>
+#include <cerrno>
+#include <utility>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "engine/AssetStreamer.hpp"
+#include "engine/IoRing.hpp"
+#include "engine/MeshFile.hpp"
+#include "engine/Trace.hpp"
+#include "engine/vk/dispatch.hpp"
+
+namespace vke {
+
+    namespace {
+        // reads in flight at once, also the io_uring queue depth
+        constexpr unsigned QUEUE_DEPTH = 64;
+        // single read request size, the kernel caps reads just below 2 GB anyway
+        constexpr uint64_t MAX_READ = 1u << 30;
+        // staging blocks start on this boundary so stream offsets from MeshFile stay aligned
+        constexpr uint64_t STAGING_ALIGNMENT = MeshFile::STREAM_ALIGNMENT;
+        constexpr uint64_t DEFAULT_FRAME_BUDGET = 32ull << 20;
+        // buffers larger than this get memory of their own
+        constexpr uint64_t DEVICE_BLOCK_SIZE = 64ull << 20;
+
+        EngineError lastOsError() {
+            return EngineError::fromOsError({ errno, std::generic_category() });
+        }
+
+        EngineError osError(int error) {
+            return EngineError::fromOsError({ error, std::generic_category() });
+        }
+
+        // Opens file for reading and returns its size through size, -1 and errno set on failure
+        int openFile(const std::filesystem::path& path, uint64_t& size) {
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0)
+                return -1;
+
+            struct stat info{};
+            if (fstat(fd, &info) != 0) {
+                int error = errno;
+                close(fd);
+                errno = error;
+                return -1;
+            }
+
+            size = static_cast<uint64_t>(info.st_size);
+            return fd;
+        }
+    }
+
+    std::ostream& operator<<(std::ostream& stream, const AssetStreamer::Stats& stats) {
+        stream << "[StreamStats] requested: " << stats.requested
+               << ", uploaded: " << stats.uploaded
+               << ", failed: " << stats.failed
+               << ", read: " << stats.bytesRead << " B"
+               << ", uploaded: " << stats.bytesUploaded << " B"
+               << ", reader: " << (stats.ioRing ? "io_uring" : "threads");
+        return stream;
+    }
+
+    AssetStreamer::AssetStreamer() : mDevice{VK_NULL_HANDLE}, mDeviceMemoryType{}, mStagingBuffer{VK_NULL_HANDLE}, mStagingMemory{VK_NULL_HANDLE},
+                                     mStagingData{nullptr}, mStagingSize{0}, mStagingCoherent{false}, mFrameBudget{DEFAULT_FRAME_BUDGET},
+                                     mAssets{}, mFinished{}, mFrameReleases{}, mDeviceMutex{}, mBuffers{}, mMemoryAllocations{},
+                                     mDeviceBlock{VK_NULL_HANDLE}, mDeviceBlockUsed{0}, mStagingMutex{}, mStagingFreed{},
+                                     mBlocks{}, mQueueMutex{}, mRequestsChanged{}, mJobsChanged{}, mRequests{}, mDecoded{}, mJobs{}, mStopping{false},
+                                     mIoThread{}, mWorkers{}, mIoRing{false}, mBytesRead{0}, mStats{} {
+    }
+
+    EngineResult<void> AssetStreamer::init(VkDevice device, MemoryType stagingMemoryType, MemoryType deviceMemoryType, uint64_t stagingSize, size_t frameCount, uint32_t workerCount) {
+        mDevice = device;
+        mDeviceMemoryType = deviceMemoryType;
+        mStagingSize = stagingSize;
+        mStagingCoherent = stagingMemoryType.isHostCoherent();
+        mFrameReleases.resize(frameCount);
+
+        VkBufferCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        createInfo.size = stagingSize;
+        createInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (VkResult result = vkCreateBuffer(mDevice, &createInfo, nullptr, &mStagingBuffer)) {
+            return EngineError::fromVkError(result);
+        }
+
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(mDevice, mStagingBuffer, &requirements);
+
+        VkMemoryAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.allocationSize = requirements.size;
+        allocateInfo.memoryTypeIndex = stagingMemoryType.getTypeIndex();
+        if (VkResult result = vkAllocateMemory(mDevice, &allocateInfo, nullptr, &mStagingMemory)) {
+            return EngineError::fromVkError(result);
+        }
+
+        if (VkResult result = vkBindBufferMemory(mDevice, mStagingBuffer, mStagingMemory, 0)) {
+            return EngineError::fromVkError(result);
+        }
+
+        // mapped for the whole lifetime, reads land here directly
+        void* data;
+        if (VkResult result = vkMapMemory(mDevice, mStagingMemory, 0, VK_WHOLE_SIZE, 0, &data)) {
+            return EngineError::fromVkError(result);
+        }
+        mStagingData = static_cast<char*>(data);
+
+        if (workerCount == 0) {
+            workerCount = std::max(1u, std::thread::hardware_concurrency() - 1);
+        }
+
+        mStopping = false;
+        mIoThread = std::thread(&AssetStreamer::runIo, this);
+        for (uint32_t i = 0; i < workerCount; i++) {
+            mWorkers.emplace_back(&AssetStreamer::runWorker, this);
+        }
+
+        return {};
+    }
+
+    void AssetStreamer::cleanup() {
+        if (mDevice == VK_NULL_HANDLE)
+            return;
+
+        {
+            std::scoped_lock lock(mQueueMutex, mStagingMutex);
+            mStopping = true;
+        }
+        mRequestsChanged.notify_all();
+        mJobsChanged.notify_all();
+        mStagingFreed.notify_all();
+
+        if (mIoThread.joinable()) {
+            mIoThread.join();
+        }
+        for (std::thread& worker : mWorkers) {
+            worker.join();
+        }
+        mWorkers.clear();
+
+        for (VkBuffer buffer : mBuffers) {
+            vkDestroyBuffer(mDevice, buffer, nullptr);
+        }
+        for (VkDeviceMemory memory : mMemoryAllocations) {
+            vkFreeMemory(mDevice, memory, nullptr);
+        }
+
+        if (mStagingMemory != VK_NULL_HANDLE) {
+            vkUnmapMemory(mDevice, mStagingMemory);
+        }
+        vkDestroyBuffer(mDevice, mStagingBuffer, nullptr);
+        vkFreeMemory(mDevice, mStagingMemory, nullptr);
+
+        mBuffers.clear();
+        mMemoryAllocations.clear();
+        mDeviceBlock = VK_NULL_HANDLE;
+        mDeviceBlockUsed = 0;
+        mAssets.clear();
+        mFinished.clear();
+        mFrameReleases.clear();
+        mBlocks.clear();
+        mRequests.clear();
+        mDecoded.clear();
+        mJobs.clear();
+        mStagingBuffer = VK_NULL_HANDLE;
+        mStagingMemory = VK_NULL_HANDLE;
+        mStagingData = nullptr;
+        mDevice = VK_NULL_HANDLE;
+    }
+
+    void AssetStreamer::setFrameBudget(uint64_t bytes) {
+        mFrameBudget = bytes;
+    }
+
+    AssetStreamer::Handle AssetStreamer::loadMesh(std::filesystem::path path) {
+        Handle handle = mAssets.size();
+        Asset& asset = mAssets.emplace_back();
+        asset.handle = handle;
+        asset.path = std::move(path);
+        mStats.requested++;
+
+        {
+            std::lock_guard lock(mQueueMutex);
+            mRequests.push_back(&asset);
+        }
+        mRequestsChanged.notify_one();
+
+        return handle;
+    }
+
+    AssetStreamer::State AssetStreamer::getState(Handle handle) const {
+        return mAssets[handle].state;
+    }
+
+    Mesh* AssetStreamer::getMesh(Handle handle) {
+        Asset& asset = mAssets[handle];
+        return asset.state == State::READY ? &asset.mesh : nullptr;
+    }
+
+    const EngineError* AssetStreamer::getError(Handle handle) const {
+        const Asset& asset = mAssets[handle];
+        return asset.state == State::FAILED ? &*asset.error : nullptr;
+    }
+
+    std::vector<AssetStreamer::Handle> AssetStreamer::takeFinished() {
+        return std::exchange(mFinished, {});
+    }
+
+    void AssetStreamer::runIo() {
+        VKE_TRACE_THREAD("Asset IO");
+
+        IoRing ring;
+        mIoRing = static_cast<bool>(ring.init(QUEUE_DEPTH));
+
+        struct Read {
+            Asset* asset;
+            int fd;
+            uint64_t done;
+        };
+
+        std::vector<Read> reads(QUEUE_DEPTH);
+        std::vector<uint32_t> freeSlots;
+        for (uint32_t slot = QUEUE_DEPTH; slot > 0; slot--) {
+            freeSlots.push_back(slot - 1);
+        }
+
+        auto queueNext = [&ring, this](const Read& read, uint32_t slot) {
+            uint64_t size = std::min(read.asset->size - read.done, MAX_READ);
+            ring.queueRead(read.fd, mStagingData + read.asset->stagingOffset + read.done, static_cast<uint32_t>(size), read.done, slot);
+        };
+
+        while (true) {
+            uint32_t inFlight = QUEUE_DEPTH - freeSlots.size();
+            std::deque<Asset*> batch;
+
+            {
+                std::unique_lock lock(mQueueMutex);
+                if (inFlight == 0) {
+                    mRequestsChanged.wait(lock, [this] { return mStopping || !mRequests.empty(); });
+                }
+
+                // reads already handed to the kernel still target staging memory, they have to land before exiting
+                if (mStopping && inFlight == 0)
+                    break;
+
+                if (!mStopping) {
+                    size_t count = mIoRing ? std::min<size_t>(freeSlots.size(), mRequests.size()) : mRequests.size();
+                    batch.assign(mRequests.begin(), mRequests.begin() + count);
+                    mRequests.erase(mRequests.begin(), mRequests.begin() + count);
+                }
+            }
+
+            if (!mIoRing) {
+                // no io_uring, every worker reads with blocking calls instead
+                for (Asset* asset : batch) {
+                    schedule([this, asset] { readBlocking(asset); });
+                }
+                continue;
+            }
+
+            for (size_t i = 0; i < batch.size(); i++) {
+                Asset* asset = batch[i];
+
+                int fd = openFile(asset->path, asset->size);
+                if (fd < 0) {
+                    fail(asset, lastOsError());
+                    continue;
+                }
+
+                if (asset->size > mStagingSize) {
+                    close(fd);
+                    fail(asset, EngineError::invalidFile("larger than the staging buffer"));
+                    continue;
+                }
+
+                // only wait for space when nothing in flight could make some, otherwise completions would never be reaped
+                std::optional<uint64_t> offset = allocateStaging(asset->size, inFlight == 0);
+                if (!offset) {
+                    close(fd);
+
+                    std::lock_guard lock(mQueueMutex);
+                    mRequests.insert(mRequests.begin(), batch.begin() + static_cast<long>(i), batch.end());
+                    break;
+                }
+
+                asset->stagingOffset = *offset;
+
+                uint32_t slot = freeSlots.back();
+                freeSlots.pop_back();
+                reads[slot] = { asset, fd, 0 };
+                queueNext(reads[slot], slot);
+                inFlight++;
+            }
+
+            if (inFlight == 0)
+                continue;
+
+            if (!ring.submit(1)) {
+                // ring broke down, tearing it down waits out anything the kernel still has, then the thread pool
+                // reads everything again from the start
+                ring.cleanup();
+                mIoRing = false;
+
+                std::lock_guard lock(mQueueMutex);
+                for (uint32_t slot = 0; slot < QUEUE_DEPTH; slot++) {
+                    if (std::find(freeSlots.begin(), freeSlots.end(), slot) != freeSlots.end())
+                        continue;
+
+                    close(reads[slot].fd);
+                    releaseStaging(reads[slot].asset->stagingOffset);
+                    reads[slot].asset->stagingOffset = NO_STAGING;
+                    mRequests.push_front(reads[slot].asset);
+                    freeSlots.push_back(slot);
+                }
+                continue;
+            }
+
+            ring.drain([&](uint64_t slot, int result) {
+                Read& read = reads[slot];
+
+                if (result <= 0) {
+                    close(read.fd);
+                    fail(read.asset, result < 0 ? osError(-result) : EngineError::invalidFile("file shrank while reading"));
+                    freeSlots.push_back(slot);
+                    return;
+                }
+
+                read.done += static_cast<uint64_t>(result);
+                if (read.done < read.asset->size) {
+                    // short read, slot keeps its queue entry for the rest
+                    queueNext(read, slot);
+                    return;
+                }
+
+                close(read.fd);
+                mBytesRead += read.asset->size;
+                freeSlots.push_back(slot);
+
+                Asset* asset = read.asset;
+                schedule([this, asset] { decode(asset); });
+            });
+        }
+
+        ring.cleanup();
+    }
+
+    void AssetStreamer::runWorker() {
+        VKE_TRACE_THREAD("Asset worker");
+
+        while (true) {
+            std::function<void()> job;
+
+            {
+                std::unique_lock lock(mQueueMutex);
+                mJobsChanged.wait(lock, [this] { return mStopping || !mJobs.empty(); });
+
+                if (mStopping)
+                    return;
+
+                job = std::move(mJobs.front());
+                mJobs.pop_front();
+            }
+
+            VKE_TRACE_SCOPE("AssetStreamer::job");
+            job();
+        }
+    }
+
+    void AssetStreamer::schedule(std::function<void()> job) {
+        {
+            std::lock_guard lock(mQueueMutex);
+            mJobs.push_back(std::move(job));
+        }
+        mJobsChanged.notify_one();
+    }
+
+    void AssetStreamer::readBlocking(Asset* asset) {
+        int fd = openFile(asset->path, asset->size);
+        if (fd < 0) {
+            fail(asset, lastOsError());
+            return;
+        }
+
+        if (asset->size > mStagingSize) {
+            close(fd);
+            fail(asset, EngineError::invalidFile("larger than the staging buffer"));
+            return;
+        }
+
+        // decode happens on this same worker, so waiting here only depends on uploads already handed to record()
+        std::optional<uint64_t> offset = allocateStaging(asset->size, true);
+        if (!offset) {
+            close(fd);
+            return;
+        }
+
+        asset->stagingOffset = *offset;
+
+        for (uint64_t done = 0; done < asset->size;) {
+            ssize_t result = pread(fd, mStagingData + *offset + done, std::min(asset->size - done, MAX_READ), static_cast<off_t>(done));
+            if (result < 0 && errno == EINTR)
+                continue;
+
+            if (result <= 0) {
+                EngineError error = result < 0 ? lastOsError() : EngineError::invalidFile("file shrank while reading");
+                close(fd);
+                fail(asset, std::move(error));
+                return;
+            }
+
+            done += static_cast<uint64_t>(result);
+        }
+
+        close(fd);
+        mBytesRead += asset->size;
+        decode(asset);
+    }
+
+    void AssetStreamer::decode(Asset* asset) {
+        const char* data = mStagingData + asset->stagingOffset;
+
+        const char* problem = MeshFile::validate(data, asset->size);
+        if (!problem) {
+            const MeshFile::Header& header = *reinterpret_cast<const MeshFile::Header*>(data);
+            if (header.vertexCount == 0 || header.indexCount == 0) {
+                problem = "empty mesh";
+            }
+        }
+
+        if (problem) {
+            fail(asset, EngineError::invalidFile(problem));
+            return;
+        }
+
+        const MeshFile::Header& header = *reinterpret_cast<const MeshFile::Header*>(data);
+
+        auto vertexBuffer = createBuffer(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, MeshFile::getVertexBytes(header));
+        if (!vertexBuffer) {
+            fail(asset, std::move(vertexBuffer.getError()));
+            return;
+        }
+
+        auto indexBuffer = createBuffer(VK_BUFFER_USAGE_INDEX_BUFFER_BIT, MeshFile::getIndexBytes(header));
+        if (!indexBuffer) {
+            fail(asset, std::move(indexBuffer.getError()));
+            return;
+        }
+
+        asset->vertexBuffer = std::move(vertexBuffer.getOk());
+        asset->indexBuffer = std::move(indexBuffer.getOk());
+
+        {
+            std::lock_guard lock(mQueueMutex);
+            mDecoded.push_back(asset);
+        }
+    }
+
+    void AssetStreamer::fail(Asset* asset, EngineError&& error) {
+        asset->error = std::move(error);
+
+        // render thread turns it into FAILED and gives staging back
+        std::lock_guard lock(mQueueMutex);
+        mDecoded.push_back(asset);
+    }
+
+    std::optional<uint64_t> AssetStreamer::allocateStaging(uint64_t size, bool wait) {
+        uint64_t alignedSize = (size + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+        std::unique_lock lock(mStagingMutex);
+
+        while (!mStopping) {
+            std::optional<uint64_t> offset;
+
+            if (mBlocks.empty()) {
+                offset = 0;
+            } else {
+                uint64_t tail = mBlocks.front().offset;
+                uint64_t head = mBlocks.back().offset + mBlocks.back().size;
+
+                if (head > tail) {
+                    // used space does not wrap, free space is after head and before tail
+                    if (mStagingSize - head >= alignedSize) {
+                        offset = head;
+                    } else if (tail >= alignedSize) {
+                        offset = 0;
+                    }
+                } else if (tail - head >= alignedSize) {
+                    offset = head;
+                }
+            }
+
+            if (offset) {
+                mBlocks.push_back({ *offset, alignedSize, false });
+                return offset;
+            }
+
+            if (!wait)
+                return std::nullopt;
+
+            mStagingFreed.wait(lock);
+        }
+
+        return std::nullopt;
+    }
+
+    void AssetStreamer::releaseStaging(uint64_t offset) {
+        {
+            std::lock_guard lock(mStagingMutex);
+
+            for (StagingBlock& block : mBlocks) {
+                if (block.offset == offset) {
+                    block.released = true;
+                    break;
+                }
+            }
+
+            // blocks are released out of order, space is only reclaimed from the oldest one on
+            while (!mBlocks.empty() && mBlocks.front().released) {
+                mBlocks.pop_front();
+            }
+        }
+
+        mStagingFreed.notify_all();
+    }
+
+    EngineResult<Buffer> AssetStreamer::createBuffer(VkBufferUsageFlags usage, uint64_t size) {
+        VkBufferCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        createInfo.size = size;
+        createInfo.usage = usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        VkBuffer buffer;
+        if (VkResult result = vkCreateBuffer(mDevice, &createInfo, nullptr, &buffer)) {
+            return EngineResult<Buffer>::error(EngineError::fromVkError(result));
+        }
+
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(mDevice, buffer, &requirements);
+
+        std::lock_guard lock(mDeviceMutex);
+        mBuffers.push_back(buffer);
+
+        VkDeviceMemory memory = mDeviceBlock;
+        uint64_t offset = (mDeviceBlockUsed + requirements.alignment - 1) / requirements.alignment * requirements.alignment;
+        bool dedicated = requirements.size > DEVICE_BLOCK_SIZE;
+
+        if (dedicated || memory == VK_NULL_HANDLE || offset + requirements.size > DEVICE_BLOCK_SIZE) {
+            VkMemoryAllocateInfo allocateInfo{};
+            allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            allocateInfo.allocationSize = dedicated ? requirements.size : DEVICE_BLOCK_SIZE;
+            allocateInfo.memoryTypeIndex = mDeviceMemoryType.getTypeIndex();
+
+            if (VkResult result = vkAllocateMemory(mDevice, &allocateInfo, nullptr, &memory)) {
+                return EngineResult<Buffer>::error(EngineError::fromVkError(result));
+            }
+            mMemoryAllocations.push_back(memory);
+            offset = 0;
+
+            // a dedicated allocation leaves the current block to the buffers that still fit
+            if (!dedicated) {
+                mDeviceBlock = memory;
+            }
+        }
+
+        if (VkResult result = vkBindBufferMemory(mDevice, buffer, memory, offset)) {
+            return EngineResult<Buffer>::error(EngineError::fromVkError(result));
+        }
+
+        if (!dedicated) {
+            mDeviceBlockUsed = offset + requirements.size;
+        }
+
+        return Buffer(mDevice, buffer, memory, size, false);
+    }
+
+    void AssetStreamer::upload(VkCommandBuffer cmdBuffer, Asset* asset) {
+        const MeshFile::Header& header = *reinterpret_cast<const MeshFile::Header*>(mStagingData + asset->stagingOffset);
+        uint64_t vertexBytes = MeshFile::getVertexBytes(header);
+        uint64_t indexBytes = MeshFile::getIndexBytes(header);
+
+        VkBufferCopy vertexRegion{ asset->stagingOffset + header.vertexOffset, 0, vertexBytes };
+        VkBufferCopy indexRegion{ asset->stagingOffset + header.indexOffset, 0, indexBytes };
+        vkCmdCopyBuffer(cmdBuffer, mStagingBuffer, asset->vertexBuffer.getHandle(), 1, &vertexRegion);
+        vkCmdCopyBuffer(cmdBuffer, mStagingBuffer, asset->indexBuffer.getHandle(), 1, &indexRegion);
+
+        asset->mesh = Mesh(std::move(asset->vertexBuffer), std::move(asset->indexBuffer), MeshFile::getIndexType(header), header.indexCount, header.vertexCount);
+        asset->state = State::READY;
+        mStats.uploaded++;
+        mStats.bytesUploaded += vertexBytes + indexBytes;
+    }
+
+    EngineResult<void> AssetStreamer::record(VkCommandBuffer cmdBuffer, size_t frame) {
+        VKE_TRACE_SCOPE("AssetStreamer::record");
+
+        // copies recorded the last time this frame was in flight have finished
+        for (uint64_t offset : mFrameReleases[frame]) {
+            releaseStaging(offset);
+        }
+        mFrameReleases[frame].clear();
+
+        std::vector<Asset*> assets;
+        uint64_t budget = 0;
+
+        {
+            std::lock_guard lock(mQueueMutex);
+
+            while (!mDecoded.empty()) {
+                Asset* asset = mDecoded.front();
+                uint64_t bytes = asset->error ? 0 : asset->size;
+
+                // the first asset always goes, otherwise one larger than the budget would never make it
+                if (budget > 0 && budget + bytes > mFrameBudget)
+                    break;
+
+                budget += bytes;
+                assets.push_back(asset);
+                mDecoded.pop_front();
+            }
+        }
+
+        if (assets.empty())
+            return {};
+
+        if (!mStagingCoherent) {
+            VkMappedMemoryRange range{};
+            range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+            range.memory = mStagingMemory;
+            range.offset = 0;
+            range.size = VK_WHOLE_SIZE;
+            if (VkResult result = vkFlushMappedMemoryRanges(mDevice, 1, &range)) {
+                return EngineError::fromVkError(result);
+            }
+        }
+
+        bool copied = false;
+
+        for (Asset* asset : assets) {
+            mFinished.push_back(asset->handle);
+
+            if (!asset->error) {
+                upload(cmdBuffer, asset);
+                mFrameReleases[frame].push_back(asset->stagingOffset);
+                copied = true;
+                continue;
+            }
+
+            asset->state = State::FAILED;
+            mStats.failed++;
+            if (asset->stagingOffset != NO_STAGING) {
+                releaseStaging(asset->stagingOffset);
+            }
+        }
+
+        if (copied) {
+            VkMemoryBarrier2 barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+            barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+            barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            barrier.dstStageMask = VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT | VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT;
+            barrier.dstAccessMask = VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_2_INDEX_READ_BIT;
+
+            VkDependencyInfo dependency{};
+            dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+            dependency.memoryBarrierCount = 1;
+            dependency.pMemoryBarriers = &barrier;
+            vkCmdPipelineBarrier2(cmdBuffer, &dependency);
+        }
+
+        return {};
+    }
+
+    const AssetStreamer::Stats& AssetStreamer::getStats() {
+        mStats.bytesRead = mBytesRead;
+        mStats.ioRing = mIoRing;
+        return mStats;
+    }
+}
@@ -0,0 +1,234 @@
+#include "engine/AsyncCompute.hpp"
+#include "engine/vk/dispatch.hpp"
+
+namespace vke {
+
+    AsyncCompute::AsyncCompute() : mDevice{VK_NULL_HANDLE}, mQueue{VK_NULL_HANDLE}, mComputeFamily{0}, mGraphicsFamily{0}, mCommandPool{VK_NULL_HANDLE}, mFrames{}, mJobs{}, mReleases{} {
+    }
+
+    EngineResult<void> AsyncCompute::init(VkDevice device, VkQueue queue, uint32_t computeFamily, uint32_t graphicsFamily, size_t frameCount) {
+        mDevice = device;
+        mQueue = queue;
+        mComputeFamily = computeFamily;
+        mGraphicsFamily = graphicsFamily;
+        mFrames.resize(frameCount);
+
+        if (!isAsync())
+            return {};
+
+        VkCommandPoolCreateInfo poolCreateInfo{};
+        poolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+        poolCreateInfo.queueFamilyIndex = mComputeFamily;
+
+        if (VkResult result = vkCreateCommandPool(mDevice, &poolCreateInfo, nullptr, &mCommandPool)) {
+            return EngineError::fromVkError(result);
+        }
+
+        for (Frame& frame : mFrames) {
+            VkCommandBufferAllocateInfo allocateInfo{};
+            allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            allocateInfo.commandPool = mCommandPool;
+            allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocateInfo.commandBufferCount = 1;
+
+            if (VkResult result = vkAllocateCommandBuffers(mDevice, &allocateInfo, &frame.cmdBuffer)) {
+                return EngineError::fromVkError(result);
+            }
+
+            VkSemaphoreCreateInfo semaphoreCreateInfo{};
+            semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+            if (VkResult result = vkCreateSemaphore(mDevice, &semaphoreCreateInfo, nullptr, &frame.finishedSemaphore)) {
+                return EngineError::fromVkError(result);
+            }
+
+        }
+
+        return {};
+    }
+
+    void AsyncCompute::cleanup() {
+        if (isAsync()) {
+            for (Frame& frame : mFrames) {
+                vkDestroySemaphore(mDevice, frame.finishedSemaphore, nullptr);
+            }
+
+            // frees command buffers with it
+            vkDestroyCommandPool(mDevice, mCommandPool, nullptr);
+        }
+
+        mFrames.clear();
+        mJobs.clear();
+        mReleases.clear();
+        mCommandPool = VK_NULL_HANDLE;
+        mQueue = VK_NULL_HANDLE;
+    }
+
+    bool AsyncCompute::isAsync() const {
+        return mQueue != VK_NULL_HANDLE;
+    }
+
+    void AsyncCompute::schedule(Job job) {
+        mJobs.push_back(std::move(job));
+    }
+
+    void AsyncCompute::release(std::vector<VkBuffer> buffers, VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess) {
+        mReleases.push_back({ std::move(buffers), dstStage, dstAccess });
+    }
+
+    void AsyncCompute::recordJobs(VkCommandBuffer cmdBuffer, std::vector<Job>& jobs, size_t frame) {
+        for (Job& job : jobs) {
+            job(cmdBuffer, frame);
+        }
+
+        jobs.clear();
+    }
+
+    EngineResult<void> AsyncCompute::submit(size_t frameIndex) {
+        Frame& frame = mFrames[frameIndex];
+
+        frame.releases.clear();
+        for (const Release& release : mReleases) {
+            frame.releases.push_back({ release.buffers[frameIndex % release.buffers.size()], release.dstStage, release.dstAccess });
+        }
+        mReleases.clear();
+
+        if (!isAsync()) {
+            frame.inlineJobs = std::move(mJobs);
+            mJobs.clear();
+            return {};
+        }
+
+        VkPipelineStageFlags2 waitStage = VK_PIPELINE_STAGE_2_NONE;
+        for (const FrameRelease& release : frame.releases) {
+            waitStage |= release.dstStage;
+        }
+        frame.waitStage = waitStage != VK_PIPELINE_STAGE_2_NONE ? waitStage : VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+        frame.submitted = !mJobs.empty();
+        if (!frame.submitted) {
+            frame.releases.clear();
+            return {};
+        }
+
+        // graphics fence of this frame covers compute too, graphics waited on its semaphore
+        if (VkResult result = vkResetCommandBuffer(frame.cmdBuffer, 0)) {
+            return EngineError::fromVkError(result);
+        }
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        if (VkResult result = vkBeginCommandBuffer(frame.cmdBuffer, &beginInfo)) {
+            return EngineError::fromVkError(result);
+        }
+
+        recordJobs(frame.cmdBuffer, mJobs, frameIndex);
+
+        // release half of the ownership transfer, destination stage is ignored on this queue
+        std::vector<VkBufferMemoryBarrier2> barriers{frame.releases.size()};
+        for (size_t i = 0; i < barriers.size(); i++) {
+            barriers[i].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+            barriers[i].srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            barriers[i].srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+            barriers[i].dstStageMask = VK_PIPELINE_STAGE_2_NONE;
+            barriers[i].dstAccessMask = VK_ACCESS_2_NONE;
+            barriers[i].srcQueueFamilyIndex = mComputeFamily;
+            barriers[i].dstQueueFamilyIndex = mGraphicsFamily;
+            barriers[i].buffer = frame.releases[i].buffer;
+            barriers[i].offset = 0;
+            barriers[i].size = VK_WHOLE_SIZE;
+        }
+
+        if (!barriers.empty()) {
+            VkDependencyInfo dependencyInfo{};
+            dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+            dependencyInfo.bufferMemoryBarrierCount = barriers.size();
+            dependencyInfo.pBufferMemoryBarriers = barriers.data();
+            vkCmdPipelineBarrier2(frame.cmdBuffer, &dependencyInfo);
+        }
+
+        if (VkResult result = vkEndCommandBuffer(frame.cmdBuffer)) {
+            return EngineError::fromVkError(result);
+        }
+
+        VkSubmitInfo submitInfo{};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &frame.cmdBuffer;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &frame.finishedSemaphore;
+        if (VkResult result = vkQueueSubmit(mQueue, 1, &submitInfo, VK_NULL_HANDLE)) {
+            return EngineError::fromVkError(result);
+        }
+
+        return {};
+    }
+
+    void AsyncCompute::acquire(VkCommandBuffer cmdBuffer, size_t frameIndex) {
+        Frame& frame = mFrames[frameIndex];
+
+        if (!isAsync()) {
+            if (frame.inlineJobs.empty())
+                return;
+
+            recordJobs(cmdBuffer, frame.inlineJobs, frameIndex);
+
+            VkMemoryBarrier2 barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+            barrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+            barrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+            for (const FrameRelease& release : frame.releases) {
+                barrier.dstStageMask |= release.dstStage;
+                barrier.dstAccessMask |= release.dstAccess;
+            }
+
+            if (barrier.dstStageMask != VK_PIPELINE_STAGE_2_NONE) {
+                VkDependencyInfo dependencyInfo{};
+                dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+                dependencyInfo.memoryBarrierCount = 1;
+                dependencyInfo.pMemoryBarriers = &barrier;
+                vkCmdPipelineBarrier2(cmdBuffer, &dependencyInfo);
+            }
+
+            frame.releases.clear();
+            return;
+        }
+
+        if (!frame.submitted || frame.releases.empty())
+            return;
+
+        // acquire half, must match the release exactly apart from the stage and access masks
+        std::vector<VkBufferMemoryBarrier2> barriers{frame.releases.size()};
+        for (size_t i = 0; i < barriers.size(); i++) {
+            barriers[i].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+            barriers[i].srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+            barriers[i].srcAccessMask = VK_ACCESS_2_NONE;
+            barriers[i].dstStageMask = frame.releases[i].dstStage;
+            barriers[i].dstAccessMask = frame.releases[i].dstAccess;
+            barriers[i].srcQueueFamilyIndex = mComputeFamily;
+            barriers[i].dstQueueFamilyIndex = mGraphicsFamily;
+            barriers[i].buffer = frame.releases[i].buffer;
+            barriers[i].offset = 0;
+            barriers[i].size = VK_WHOLE_SIZE;
+        }
+
+        VkDependencyInfo dependencyInfo{};
+        dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependencyInfo.bufferMemoryBarrierCount = barriers.size();
+        dependencyInfo.pBufferMemoryBarriers = barriers.data();
+        vkCmdPipelineBarrier2(cmdBuffer, &dependencyInfo);
+
+        frame.releases.clear();
+    }
+
+    VkSemaphore AsyncCompute::getWaitSemaphore(size_t frameIndex) const {
+        const Frame& frame = mFrames[frameIndex];
+        return isAsync() && frame.submitted ? frame.finishedSemaphore : VK_NULL_HANDLE;
+    }
+
+    VkPipelineStageFlags2 AsyncCompute::getWaitStage(size_t frameIndex) const {
+        return mFrames[frameIndex].waitStage;
+    }
+}
@@ -1,13 +1,15 @@
+#include <cstring>
 #include "engine/Buffer.hpp"
+#include "engine/vk/dispatch.hpp"
 
 namespace vke {
-    Buffer::Buffer(VkDevice device, VkBuffer buffer, VkDeviceMemory backingMemory, VkDeviceSize size, bool needsFlushing) : mDevice{device}, mBuffer{buffer}, mBackingMemory{backingMemory}, mSize{size}, mNeedsFlushing{needsFlushing} {
+    Buffer::Buffer(VkDevice device, VkBuffer buffer, VkDeviceMemory backingMemory, VkDeviceSize size, bool needsFlushing, VkDeviceSize flushAlignment) : mDevice{device}, mBuffer{buffer}, mBackingMemory{backingMemory}, mSize{size}, mNeedsFlushing{needsFlushing}, mFlushAlignment{flushAlignment} {
     }
 
-    Buffer::Buffer() : mDevice{VK_NULL_HANDLE}, mBuffer{VK_NULL_HANDLE}, mBackingMemory{VK_NULL_HANDLE}, mSize{0} {
+    Buffer::Buffer() : mDevice{VK_NULL_HANDLE}, mBuffer{VK_NULL_HANDLE}, mBackingMemory{VK_NULL_HANDLE}, mSize{0}, mNeedsFlushing{false}, mFlushAlignment{1} {
     }
 
-    Buffer::Buffer(Buffer&& other) noexcept : mDevice{other.mDevice}, mBuffer{other.mBuffer}, mBackingMemory{other.mBackingMemory}, mNeedsFlushing{other.mNeedsFlushing} {
+    Buffer::Buffer(Buffer&& other) noexcept : mDevice{other.mDevice}, mBuffer{other.mBuffer}, mBackingMemory{other.mBackingMemory}, mSize{other.mSize}, mNeedsFlushing{other.mNeedsFlushing}, mFlushAlignment{other.mFlushAlignment} {
         other.mDevice = VK_NULL_HANDLE;
         other.mBuffer = VK_NULL_HANDLE;
         other.mBackingMemory = VK_NULL_HANDLE;
@@ -23,6 +25,7 @@ namespace vke {
             mBackingMemory = other.mBackingMemory;
             mSize = other.mSize;
             mNeedsFlushing = other.mNeedsFlushing;
+            mFlushAlignment = other.mFlushAlignment;
 
             other.mDevice = VK_NULL_HANDLE;
             other.mBuffer = VK_NULL_HANDLE;
@@ -36,6 +39,10 @@ namespace vke {
         return mBuffer;
     }
 
+    VkDeviceMemory Buffer::getMemory() const {
+        return mBackingMemory;
+    }
+
     EngineResult<Buffer::MappedScope> Buffer::map() {
         VkMappedMemoryRange range{};
         range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
@@ -48,21 +55,45 @@ namespace vke {
             return EngineResult<Buffer::MappedScope>::error(EngineError::fromVkError(result));
         }
 
-        return Buffer::MappedScope{mDevice, range, reinterpret_cast<char*>(data)};
+        return Buffer::MappedScope{mDevice, range, reinterpret_cast<char*>(data), mSize, mNeedsFlushing, mFlushAlignment};
     }
 
-    Buffer::MappedScope::MappedScope(VkDevice device, VkMappedMemoryRange mappedRange, char* data) : mDevice{device}, mMappedRange{mappedRange}, mData{data}, mCursor{0} {
+    Buffer::MappedScope::MappedScope(VkDevice device, VkMappedMemoryRange mappedRange, char* data, VkDeviceSize size, bool needsFlushing, VkDeviceSize flushAlignment)
+        : mDevice{device}, mMappedRange{mappedRange}, mData{data}, mCursor{0}, mSize{size}, mNeedsFlushing{needsFlushing}, mFlushAlignment{flushAlignment} {
     }
 
-    Buffer::MappedScope::MappedScope() : mDevice{VK_NULL_HANDLE}, mMappedRange{}, mData{nullptr}, mCursor{0} {
+    Buffer::MappedScope::MappedScope() : mDevice{VK_NULL_HANDLE}, mMappedRange{}, mData{nullptr}, mCursor{0}, mSize{0}, mNeedsFlushing{false}, mFlushAlignment{1} {
     }
 
-    Buffer::MappedScope::MappedScope(Buffer::MappedScope&& other) noexcept : mDevice{other.mDevice}, mMappedRange{other.mMappedRange}, mData{other.mData}, mCursor{other.mCursor} {
+    Buffer::MappedScope::MappedScope(Buffer::MappedScope&& other) noexcept : mDevice{other.mDevice}, mMappedRange{other.mMappedRange}, mData{other.mData}, mCursor{other.mCursor},
+                                                                             mSize{other.mSize}, mNeedsFlushing{other.mNeedsFlushing}, mFlushAlignment{other.mFlushAlignment} {
         other.mDevice = VK_NULL_HANDLE;
         other.mData = nullptr;
         other.mCursor = 0;
     }
 
+    Buffer::MappedScope& Buffer::MappedScope::operator=(Buffer::MappedScope&& other) noexcept {
+        if (this != &other) {
+            if (mData) {
+                vkUnmapMemory(mDevice, mMappedRange.memory);
+            }
+
+            mDevice = other.mDevice;
+            mMappedRange = other.mMappedRange;
+            mData = other.mData;
+            mCursor = other.mCursor;
+            mSize = other.mSize;
+            mNeedsFlushing = other.mNeedsFlushing;
+            mFlushAlignment = other.mFlushAlignment;
+
+            other.mDevice = VK_NULL_HANDLE;
+            other.mData = nullptr;
+            other.mCursor = 0;
+        }
+
+        return *this;
+    }
+
     Buffer::MappedScope::~MappedScope() {
         if (mData) {
             vkUnmapMemory(mDevice, mMappedRange.memory);
@@ -78,6 +109,29 @@ namespace vke {
         }
     }
 
+    void Buffer::MappedScope::write(const void* data, size_t bytes) {
+        std::memcpy(mData + mCursor, data, bytes);
+        mCursor += bytes;
+    }
+
+    EngineResult<void> Buffer::MappedScope::flush(VkDeviceSize offset, VkDeviceSize bytes) {
+        if (!mNeedsFlushing || bytes == 0)
+            return {};
+
+        // range has to cover whole atoms, buffer is bound at the start of its memory so offsets carry over
+        VkMappedMemoryRange range = mMappedRange;
+        range.offset = offset / mFlushAlignment * mFlushAlignment;
+        VkDeviceSize end = (offset + bytes + mFlushAlignment - 1) / mFlushAlignment * mFlushAlignment;
+        // rounding up may pass the end of the buffer, the rest of the allocation is flushed along then
+        range.size = end > mSize ? VK_WHOLE_SIZE : end - range.offset;
+
+        if (VkResult result = vkFlushMappedMemoryRanges(mDevice, 1, &range)) {
+            return EngineError::fromVkError(result);
+        }
+
+        return {};
+    }
+
     char& Buffer::MappedScope::operator[](size_t index) {
         return mData[index];
     }
@@ -0,0 +1,32 @@
+#include <array>
+#include <cstdio>
+#include <exception>
+#include <mutex>
+#include "engine/ComponentRegistry.hpp"
+
+namespace vke {
+
+    namespace {
+        std::array<ComponentRegistry::Info, ComponentRegistry::MAX_COMPONENTS> infos{};
+        ComponentId componentCount = 0;
+        std::mutex registryMutex;
+    }
+
+    const ComponentRegistry::Info& ComponentRegistry::getInfo(ComponentId id) {
+        return infos[id];
+    }
+
+    ComponentId ComponentRegistry::registerComponent(size_t size, size_t alignment) {
+        std::lock_guard lock{registryMutex};
+
+        // signatures have no bit left for it, and infos no slot
+        if (componentCount == MAX_COMPONENTS) {
+            std::fputs("[ENGINE] [FATAL]: More than 64 component types registered\n", stderr);
+            std::terminate();
+        }
+
+        ComponentId id = componentCount++;
+        infos[id] = { size, alignment };
+        return id;
+    }
+}
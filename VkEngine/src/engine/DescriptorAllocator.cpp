@@ -0,0 +1,148 @@
+#include <algorithm>
+#include "engine/DescriptorAllocator.hpp"
+#include "engine/vk/dispatch.hpp"
+
+namespace vke {
+
+    DescriptorAllocator::DescriptorAllocator() : mDevice{VK_NULL_HANDLE}, mFrames{}, mPersistent{}, mCurrentFrame{0} {
+    }
+
+    void DescriptorAllocator::init(VkDevice device, size_t frameCount) {
+        mDevice = device;
+        mFrames.resize(frameCount);
+
+        for (FramePools& frame : mFrames) {
+            frame.currentPool = VK_NULL_HANDLE;
+            frame.setsPerPool = INITIAL_SETS_PER_POOL;
+        }
+
+        mPersistent.currentPool = VK_NULL_HANDLE;
+        mPersistent.setsPerPool = INITIAL_SETS_PER_POOL;
+    }
+
+    void DescriptorAllocator::cleanup() {
+        for (FramePools& frame : mFrames) {
+            destroyPools(frame);
+        }
+        mFrames.clear();
+
+        destroyPools(mPersistent);
+        mPersistent = {};
+    }
+
+    void DescriptorAllocator::destroyPools(FramePools& frame) {
+        for (VkDescriptorPool pool : frame.usedPools) {
+            vkDestroyDescriptorPool(mDevice, pool, nullptr);
+        }
+
+        for (VkDescriptorPool pool : frame.freePools) {
+            vkDestroyDescriptorPool(mDevice, pool, nullptr);
+        }
+    }
+
+    EngineResult<void> DescriptorAllocator::resetFrame(size_t frame) {
+        mCurrentFrame = frame;
+        FramePools& pools = mFrames[frame];
+
+        for (VkDescriptorPool pool : pools.usedPools) {
+            if (VkResult result = vkResetDescriptorPool(mDevice, pool, 0)) {
+                return EngineError::fromVkError(result);
+            }
+
+            pools.freePools.push_back(pool);
+        }
+        pools.usedPools.clear();
+        pools.currentPool = VK_NULL_HANDLE;
+
+        return {};
+    }
+
+    EngineResult<VkDescriptorSet> DescriptorAllocator::allocate(VkDescriptorSetLayout layout) {
+        return allocate(mFrames[mCurrentFrame], layout);
+    }
+
+    EngineResult<VkDescriptorSet> DescriptorAllocator::allocatePersistent(VkDescriptorSetLayout layout) {
+        return allocate(mPersistent, layout);
+    }
+
+    EngineResult<VkDescriptorSet> DescriptorAllocator::allocate(FramePools& frame, VkDescriptorSetLayout layout) {
+        if (frame.currentPool == VK_NULL_HANDLE) {
+            if (auto pool = grabPool(frame)) {
+                frame.currentPool = pool.getOk();
+            } else {
+                return EngineResult<VkDescriptorSet>::error(std::move(pool.getError()));
+            }
+        }
+
+        VkDescriptorSetAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocateInfo.descriptorPool = frame.currentPool;
+        allocateInfo.descriptorSetCount = 1;
+        allocateInfo.pSetLayouts = &layout;
+
+        VkDescriptorSet set;
+        VkResult result = vkAllocateDescriptorSets(mDevice, &allocateInfo, &set);
+
+        // current pool is exhausted, move on to a fresh one and try once more
+        if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) {
+            if (auto pool = grabPool(frame)) {
+                frame.currentPool = pool.getOk();
+            } else {
+                return EngineResult<VkDescriptorSet>::error(std::move(pool.getError()));
+            }
+
+            allocateInfo.descriptorPool = frame.currentPool;
+            result = vkAllocateDescriptorSets(mDevice, &allocateInfo, &set);
+        }
+
+        if (result) {
+            return EngineResult<VkDescriptorSet>::error(EngineError::fromVkError(result));
+        }
+
+        return set;
+    }
+
+    EngineResult<VkDescriptorPool> DescriptorAllocator::grabPool(FramePools& frame) {
+        VkDescriptorPool pool;
+
+        if (!frame.freePools.empty()) {
+            pool = frame.freePools.back();
+            frame.freePools.pop_back();
+        } else {
+            auto created = createPool(frame.setsPerPool);
+            if (!created)
+                return created;
+
+            pool = created.getOk();
+            // every new pool is bigger than the last, so busy frames settle on a few large pools
+            frame.setsPerPool = std::min(frame.setsPerPool * 2, MAX_SETS_PER_POOL);
+        }
+
+        frame.usedPools.push_back(pool);
+
+        return pool;
+    }
+
+    EngineResult<VkDescriptorPool> DescriptorAllocator::createPool(uint32_t setCount) {
+        std::vector<VkDescriptorPoolSize> sizes;
+        sizes.reserve(std::size(POOL_RATIOS));
+
+        for (const PoolRatio& ratio : POOL_RATIOS) {
+            sizes.push_back({ ratio.type, static_cast<uint32_t>(ratio.ratio * static_cast<float>(setCount)) });
+        }
+
+        VkDescriptorPoolCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        createInfo.flags = 0;
+        createInfo.maxSets = setCount;
+        createInfo.poolSizeCount = sizes.size();
+        createInfo.pPoolSizes = sizes.data();
+
+        VkDescriptorPool pool;
+        if (VkResult result = vkCreateDescriptorPool(mDevice, &createInfo, nullptr, &pool)) {
+            return EngineResult<VkDescriptorPool>::error(EngineError::fromVkError(result));
+        }
+
+        return pool;
+    }
+}
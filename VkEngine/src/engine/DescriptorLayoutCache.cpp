@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <functional>
+#include "engine/DescriptorLayoutCache.hpp"
+#include "engine/vk/dispatch.hpp"
+
+namespace vke {
+
+    namespace {
+        // pImmutableSamplers is ignored for every other descriptor type
+        bool hasImmutableSamplers(const VkDescriptorSetLayoutBinding& binding) {
+            return binding.pImmutableSamplers != nullptr
+                && (binding.descriptorType == VK_DESCRIPTOR_TYPE_SAMPLER || binding.descriptorType == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+        }
+    }
+
+    bool DescriptorLayoutCache::LayoutInfo::operator==(const LayoutInfo& other) const {
+        if (bindings.size() != other.bindings.size())
+            return false;
+
+        for (size_t i = 0, size = bindings.size(); i < size; i++) {
+            const VkDescriptorSetLayoutBinding& a = bindings[i];
+            const VkDescriptorSetLayoutBinding& b = other.bindings[i];
+
+            if (a.binding != b.binding || a.descriptorType != b.descriptorType || a.descriptorCount != b.descriptorCount || a.stageFlags != b.stageFlags)
+                return false;
+
+            if (hasImmutableSamplers(a) != hasImmutableSamplers(b))
+                return false;
+        }
+
+        return samplers == other.samplers;
+    }
+
+    size_t DescriptorLayoutCache::LayoutInfo::hash() const {
+        size_t hash = std::hash<size_t>()(bindings.size());
+
+        for (const VkDescriptorSetLayoutBinding& binding : bindings) {
+            // pack the whole binding into one word, then mix it into the running hash
+            size_t packed = binding.binding | (binding.descriptorType << 8) | (binding.descriptorCount << 16) | (static_cast<size_t>(binding.stageFlags) << 32);
+            hash ^= std::hash<size_t>()(packed) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        }
+
+        for (VkSampler sampler : samplers) {
+            hash ^= std::hash<VkSampler>()(sampler) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        }
+
+        return hash;
+    }
+
+    DescriptorLayoutCache::DescriptorLayoutCache() : mDevice{VK_NULL_HANDLE}, mLayouts{} {
+    }
+
+    void DescriptorLayoutCache::init(VkDevice device) {
+        mDevice = device;
+    }
+
+    void DescriptorLayoutCache::cleanup() {
+        for (const auto& entry : mLayouts) {
+            vkDestroyDescriptorSetLayout(mDevice, entry.second, nullptr);
+        }
+        mLayouts.clear();
+    }
+
+    EngineResult<VkDescriptorSetLayout> DescriptorLayoutCache::getLayout(std::vector<VkDescriptorSetLayoutBinding> bindings) {
+        LayoutInfo info{std::move(bindings), {}};
+
+        // bindings may come in any order, sort them so equal layouts compare equal
+        std::sort(info.bindings.begin(), info.bindings.end(), [](const VkDescriptorSetLayoutBinding& a, const VkDescriptorSetLayoutBinding& b) {
+            return a.binding < b.binding;
+        });
+
+        // the caller's sampler arrays do not outlive the call, the cached layout keeps its own copy
+        for (const VkDescriptorSetLayoutBinding& binding : info.bindings) {
+            if (hasImmutableSamplers(binding)) {
+                info.samplers.insert(info.samplers.end(), binding.pImmutableSamplers, binding.pImmutableSamplers + binding.descriptorCount);
+            }
+        }
+
+        size_t samplerIndex = 0;
+        for (VkDescriptorSetLayoutBinding& binding : info.bindings) {
+            if (hasImmutableSamplers(binding)) {
+                binding.pImmutableSamplers = info.samplers.data() + samplerIndex;
+                samplerIndex += binding.descriptorCount;
+            } else {
+                binding.pImmutableSamplers = nullptr;
+            }
+        }
+
+        if (auto it = mLayouts.find(info); it != mLayouts.end()) {
+            return it->second;
+        }
+
+        VkDescriptorSetLayoutCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        createInfo.bindingCount = info.bindings.size();
+        createInfo.pBindings = info.bindings.data();
+
+        VkDescriptorSetLayout layout;
+        if (VkResult result = vkCreateDescriptorSetLayout(mDevice, &createInfo, nullptr, &layout)) {
+            return EngineResult<VkDescriptorSetLayout>::error(EngineError::fromVkError(result));
+        }
+
+        mLayouts.emplace(std::move(info), layout);
+
+        return layout;
+    }
+}
@@ -0,0 +1,64 @@
+#include "engine/DescriptorWriter.hpp"
+#include "engine/vk/dispatch.hpp"
+
+namespace vke {
+
+    DescriptorWriter::DescriptorWriter() : mBufferInfos{}, mImageInfos{}, mWrites{} {
+    }
+
+    DescriptorWriter& DescriptorWriter::writeBuffer(VkDescriptorSet set, uint32_t binding, VkDescriptorType type, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) {
+        VkDescriptorBufferInfo& info = mBufferInfos.emplace_back();
+        info.buffer = buffer;
+        info.offset = offset;
+        info.range = range;
+
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = set;
+        write.dstBinding = binding;
+        write.dstArrayElement = 0;
+        write.descriptorCount = 1;
+        write.descriptorType = type;
+        write.pBufferInfo = &info;
+        mWrites.push_back(write);
+
+        return *this;
+    }
+
+    DescriptorWriter& DescriptorWriter::writeImage(VkDescriptorSet set, uint32_t binding, VkDescriptorType type, VkImageView view, VkSampler sampler, VkImageLayout layout) {
+        VkDescriptorImageInfo& info = mImageInfos.emplace_back();
+        info.sampler = sampler;
+        info.imageView = view;
+        info.imageLayout = layout;
+
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = set;
+        write.dstBinding = binding;
+        write.dstArrayElement = 0;
+        write.descriptorCount = 1;
+        write.descriptorType = type;
+        write.pImageInfo = &info;
+        mWrites.push_back(write);
+
+        return *this;
+    }
+
+    void DescriptorWriter::update(VkDevice device) {
+        if (!mWrites.empty()) {
+            vkUpdateDescriptorSets(device, mWrites.size(), mWrites.data(), 0, nullptr);
+        }
+
+        clear();
+    }
+
+    void DescriptorWriter::clear() {
+        mWrites.clear();
+        mBufferInfos.clear();
+        mImageInfos.clear();
+    }
+
+    size_t DescriptorWriter::getWriteCount() const {
+        return mWrites.size();
+    }
+}
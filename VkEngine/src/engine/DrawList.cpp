@@ -0,0 +1,255 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include "engine/DrawList.hpp"
+#include "engine/vk/dispatch.hpp"
+
+namespace vke {
+
+    namespace {
+        constexpr uint32_t RADIX_BITS = 8;
+        constexpr uint32_t RADIX_SIZE = 1 << RADIX_BITS;
+        constexpr uint32_t RADIX_PASSES = 64 / RADIX_BITS;
+
+        constexpr uint32_t BIND_PIPELINE = 1 << 0;
+        constexpr uint32_t BIND_MATERIAL = 1 << 1;
+        constexpr uint32_t BIND_VERTEX_BUFFER = 1 << 2;
+        constexpr uint32_t BIND_INSTANCE_BUFFER = 1 << 3;
+        constexpr uint32_t BIND_INDEX_BUFFER = 1 << 4;
+
+        // 0 is reserved for "not set"
+        template<typename Handle>
+        uint64_t getDenseId(std::unordered_map<Handle, uint32_t>& ids, Handle handle, uint32_t bits) {
+            if (handle == VK_NULL_HANDLE)
+                return 0;
+
+            auto it = ids.try_emplace(handle, static_cast<uint32_t>(ids.size()) + 1).first;
+            // running out of ids only costs sort quality, replay compares the actual handles
+            return std::min(it->second, (1u << bits) - 1);
+        }
+    }
+
+    uint32_t DrawList::BindCounts::total() const {
+        return pipelines + materials + vertexBuffers + indexBuffers;
+    }
+
+    uint32_t DrawList::Stats::getSaved() const {
+        return unsorted.total() - sorted.total();
+    }
+
+    std::ostream& operator<<(std::ostream& stream, const DrawList::Stats& stats) {
+        stream << "[DrawStats] draws: " << stats.draws
+               << ", pipeline binds: " << stats.unsorted.pipelines << " -> " << stats.sorted.pipelines
+               << ", material binds: " << stats.unsorted.materials << " -> " << stats.sorted.materials
+               << ", vertex buffer binds: " << stats.unsorted.vertexBuffers << " -> " << stats.sorted.vertexBuffers
+               << ", index buffer binds: " << stats.unsorted.indexBuffers << " -> " << stats.sorted.indexBuffers
+               << ", saved: " << stats.getSaved();
+        return stream;
+    }
+
+    DrawList::DrawList() : mDraws{}, mKeys{}, mOrder{}, mScratchKeys{}, mScratchOrder{}, mPipelineIds{}, mMaterialIds{},
+                           mSubmitted{}, mUnsorted{}, mStats{} {
+    }
+
+    void DrawList::submit(const DrawCommand& draw) {
+        mDraws.push_back(draw);
+        bind(mSubmitted, draw, draw.pipeline, mUnsorted);
+    }
+
+    uint32_t DrawList::bind(BoundState& bound, const DrawCommand& draw, VkPipeline pipeline, BindCounts& counts) {
+        uint32_t changed = 0;
+
+        if (pipeline != bound.pipeline) {
+            bound.pipeline = pipeline;
+            counts.pipelines++;
+            changed |= BIND_PIPELINE;
+        }
+
+        if (draw.materialSet != VK_NULL_HANDLE && (draw.materialSet != bound.material || draw.materialSetIndex != bound.materialIndex)) {
+            bound.material = draw.materialSet;
+            bound.materialIndex = draw.materialSetIndex;
+            counts.materials++;
+            changed |= BIND_MATERIAL;
+        }
+
+        if (draw.vertexBuffer != bound.vertexBuffer || draw.vertexOffset != bound.vertexOffset) {
+            bound.vertexBuffer = draw.vertexBuffer;
+            bound.vertexOffset = draw.vertexOffset;
+            counts.vertexBuffers++;
+            changed |= BIND_VERTEX_BUFFER;
+        }
+
+        if (draw.instanceBuffer != VK_NULL_HANDLE && draw.instanceBuffer != bound.instanceBuffer) {
+            bound.instanceBuffer = draw.instanceBuffer;
+            counts.vertexBuffers++;
+            changed |= BIND_INSTANCE_BUFFER;
+        }
+
+        if (draw.indexBuffer != VK_NULL_HANDLE && (draw.indexBuffer != bound.indexBuffer || draw.indexType != bound.indexType)) {
+            bound.indexBuffer = draw.indexBuffer;
+            bound.indexType = draw.indexType;
+            counts.indexBuffers++;
+            changed |= BIND_INDEX_BUFFER;
+        }
+
+        return changed;
+    }
+
+    uint64_t DrawList::makeKey(const DrawCommand& draw) {
+        uint64_t pass = draw.pass & ((1u << PASS_BITS) - 1);
+        uint64_t pipeline = getDenseId(mPipelineIds, draw.pipeline, PIPELINE_BITS);
+        uint64_t material = getDenseId(mMaterialIds, draw.materialSet, MATERIAL_BITS);
+        // bit patterns of non-negative floats sort the same way as their values,
+        // draws behind the camera are clamped to the near plane
+        uint64_t depth = std::bit_cast<uint32_t>(std::max(draw.depth, 0.0f));
+
+        return (pass << (PIPELINE_BITS + MATERIAL_BITS + DEPTH_BITS))
+             | (pipeline << (MATERIAL_BITS + DEPTH_BITS))
+             | (material << DEPTH_BITS)
+             | depth;
+    }
+
+    void DrawList::sort() {
+        size_t size = mDraws.size();
+        mKeys.resize(size);
+        mOrder.resize(size);
+
+        for (size_t i = 0; i < size; i++) {
+            mKeys[i] = makeKey(mDraws[i]);
+            mOrder[i] = static_cast<uint32_t>(i);
+        }
+
+        radixSort();
+    }
+
+    void DrawList::radixSort() {
+        size_t size = mKeys.size();
+        if (size < 2)
+            return;
+
+        // histograms of all digits in one sweep over the keys
+        std::array<std::array<uint32_t, RADIX_SIZE>, RADIX_PASSES> histograms{};
+        for (uint64_t key : mKeys) {
+            for (uint32_t pass = 0; pass < RADIX_PASSES; pass++) {
+                histograms[pass][(key >> (pass * RADIX_BITS)) & (RADIX_SIZE - 1)]++;
+            }
+        }
+
+        mScratchKeys.resize(size);
+        mScratchOrder.resize(size);
+
+        // LSD passes are stable, so equal keys keep submission order
+        for (uint32_t pass = 0; pass < RADIX_PASSES; pass++) {
+            std::array<uint32_t, RADIX_SIZE>& histogram = histograms[pass];
+            uint32_t shift = pass * RADIX_BITS;
+
+            // digit is the same for every key (unused pipeline or material bits usually), nothing to reorder
+            if (histogram[(mKeys[0] >> shift) & (RADIX_SIZE - 1)] == size)
+                continue;
+
+            uint32_t offset = 0;
+            for (uint32_t& count : histogram) {
+                uint32_t next = offset + count;
+                count = offset;
+                offset = next;
+            }
+
+            for (size_t i = 0; i < size; i++) {
+                uint32_t destination = histogram[(mKeys[i] >> shift) & (RADIX_SIZE - 1)]++;
+                mScratchKeys[destination] = mKeys[i];
+                mScratchOrder[destination] = mOrder[i];
+            }
+
+            mKeys.swap(mScratchKeys);
+            mOrder.swap(mScratchOrder);
+        }
+    }
+
+    DrawList::BindCounts DrawList::replay(VkCommandBuffer cmdBuffer, VkPipelineLayout layout, VkPipeline defaultPipeline, const uint32_t* order) const {
+        BindCounts counts{};
+        BoundState bound{};
+        bound.pipeline = defaultPipeline;
+
+        for (size_t i = 0, size = mDraws.size(); i < size; i++) {
+            const DrawCommand& draw = mDraws[order != nullptr ? order[i] : i];
+
+            VkPipeline pipeline = draw.pipeline != VK_NULL_HANDLE ? draw.pipeline : defaultPipeline;
+            uint32_t changed = bind(bound, draw, pipeline, counts);
+
+            if (changed & BIND_PIPELINE) {
+                vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+            }
+
+            if (changed & BIND_MATERIAL) {
+                vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, draw.materialSetIndex, 1, &draw.materialSet, 0, nullptr);
+            }
+
+            if (changed & BIND_VERTEX_BUFFER) {
+                vkCmdBindVertexBuffers(cmdBuffer, PipelineDescription::VERTEX_BINDING, 1, &draw.vertexBuffer, &draw.vertexOffset);
+            }
+
+            if (changed & BIND_INSTANCE_BUFFER) {
+                VkDeviceSize offset = 0;
+                vkCmdBindVertexBuffers(cmdBuffer, PipelineDescription::INSTANCE_BINDING, 1, &draw.instanceBuffer, &offset);
+            }
+
+            if (changed & BIND_INDEX_BUFFER) {
+                vkCmdBindIndexBuffer(cmdBuffer, draw.indexBuffer, 0, draw.indexType);
+            }
+
+            if (draw.pushConstantSize > 0) {
+                vkCmdPushConstants(cmdBuffer, layout, draw.pushConstantStages, 0, draw.pushConstantSize, draw.pushConstants.data());
+            }
+
+            if (draw.indexBuffer != VK_NULL_HANDLE) {
+                vkCmdDrawIndexed(cmdBuffer, draw.indexCount, draw.instanceCount, draw.firstIndex, draw.baseVertex, draw.firstInstance);
+            } else {
+                vkCmdDraw(cmdBuffer, draw.vertexCount, draw.instanceCount, draw.firstVertex, draw.firstInstance);
+            }
+        }
+
+        // whatever is recorded after the list expects the engine pipeline
+        if (bound.pipeline != defaultPipeline) {
+            vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, defaultPipeline);
+            counts.pipelines++;
+        }
+
+        return counts;
+    }
+
+    void DrawList::record(VkCommandBuffer cmdBuffer, VkPipelineLayout layout, VkPipeline defaultPipeline) {
+        // recorded in submission order when sort() was not called
+        const uint32_t* order = mOrder.size() == mDraws.size() ? mOrder.data() : nullptr;
+
+        mStats.draws = static_cast<uint32_t>(mDraws.size());
+        mStats.sorted = replay(cmdBuffer, layout, defaultPipeline, order);
+
+        if (order != nullptr) {
+            mStats.unsorted = mUnsorted;
+            // rebinding the default pipeline after the last draw, submit() only knew it as null
+            if (mSubmitted.pipeline != VK_NULL_HANDLE && mSubmitted.pipeline != defaultPipeline) {
+                mStats.unsorted.pipelines++;
+            }
+        } else {
+            mStats.unsorted = mStats.sorted;
+        }
+    }
+
+    void DrawList::clear() {
+        mDraws.clear();
+        mSubmitted = {};
+        mUnsorted = {};
+        mKeys.clear();
+        mOrder.clear();
+        mPipelineIds.clear();
+        mMaterialIds.clear();
+    }
+
+    size_t DrawList::size() const {
+        return mDraws.size();
+    }
+
+    const DrawList::Stats& DrawList::getStats() const {
+        return mStats;
+    }
+}
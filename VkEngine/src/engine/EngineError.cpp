@@ -1,113 +1,24 @@
+#include <mutex>
+#include <string>
+#include <unordered_set>
 #include "engine/EngineError.hpp"
 
 namespace vke {
 
-    EngineError::EngineError() : mKind{Kind::NONE} {
-    }
+    namespace {
+        // Errors only keep a pointer to their text, so it is never freed. Set nodes do not move, which keeps pointers
+        // valid while the pool grows, and repeated failures with the same text do not grow it at all. SDL messages and
+        // missing extension lists come from a small set, anything varying per call must stay out of here.
+        const char* pool(std::string text) {
+            static std::mutex mutex;
+            static auto* texts = new std::unordered_set<std::string>();
 
-    EngineError::EngineError(const EngineError& other) : mKind{other.mKind} {
-        switch (other.mKind) {
-            case Kind::NONE:
-            case Kind::NO_DEVICE:
-            case Kind::MISSING_VERTEX_SHADER:
-                break;
-            case Kind::SDL:
-                new (&mMessage) std::string(other.mMessage);
-                break;
-            case Kind::VULKAN:
-                mResult = other.mResult;
-                break;
-            case Kind::EXTENSIONS_NOT_PRESENT:
-                new (&mExtensions) std::vector<const char*>(other.mExtensions);
-                break;
-            case Kind::OS_ERROR:
-                new (&mErrorCode) std::error_code(other.mErrorCode);
-                break;
+            std::lock_guard lock{mutex};
+            return texts->insert(std::move(text)).first->c_str();
         }
     }
 
-    EngineError::EngineError(EngineError&& other) noexcept : mKind{other.mKind} {
-        switch (other.mKind) {
-            case Kind::NONE:
-            case Kind::NO_DEVICE:
-            case Kind::MISSING_VERTEX_SHADER:
-                break;
-            case Kind::SDL:
-                new (&mMessage) std::string(std::move(other.mMessage));
-                break;
-            case Kind::VULKAN:
-                mResult = other.mResult;
-                break;
-            case Kind::EXTENSIONS_NOT_PRESENT:
-                new (&mExtensions) std::vector<const char*>(std::move(other.mExtensions));
-                break;
-            case Kind::OS_ERROR:
-                new (&mErrorCode) std::error_code(other.mErrorCode);
-                break;
-        }
-    }
-
-    EngineError& EngineError::operator=(const EngineError& other) {
-        if (&other != this) {
-            switch (other.mKind) {
-                case Kind::NONE:
-                case Kind::NO_DEVICE:
-                case Kind::MISSING_VERTEX_SHADER:
-                    clear();
-                    break;
-                case Kind::SDL:
-                    mMessage = other.mMessage;
-                    break;
-                case Kind::VULKAN:
-                    mResult = other.mResult;
-                    break;
-                case Kind::EXTENSIONS_NOT_PRESENT:
-                    mExtensions = other.mExtensions;
-                    break;
-                case Kind::OS_ERROR:
-                    mErrorCode = other.mErrorCode;
-                    break;
-            }
-
-            mKind = other.mKind;
-        }
-
-        return *this;
-    }
-
-    EngineError& EngineError::operator=(EngineError&& other) noexcept {
-        if (&other != this) {
-            switch (other.mKind) {
-                case Kind::NONE:
-                case Kind::NO_DEVICE:
-                case Kind::MISSING_VERTEX_SHADER:
-                    clear();
-                    break;
-                case Kind::SDL:
-                    mMessage = std::move(other.mMessage);
-                    break;
-                case Kind::VULKAN:
-                    mResult = other.mResult;
-                    break;
-                case Kind::EXTENSIONS_NOT_PRESENT:
-                    mExtensions = std::move(other.mExtensions);
-                    break;
-                case Kind::OS_ERROR:
-                    mErrorCode = other.mErrorCode;
-                    break;
-            }
-
-            mKind = other.mKind;
-        }
-
-        return *this;
-    }
-
-    EngineError::~EngineError() noexcept {
-        clear();
-    }
-
-    std::ostream& operator<<(std::ostream& stream, EngineError& error) {
+    std::ostream& operator<<(std::ostream& stream, const EngineError& error) {
         switch (error.mKind) {
             case EngineError::Kind::NONE:
                 stream << "[NoError]";
@@ -116,110 +27,62 @@ namespace vke {
                 stream << "[SdlError] " << error.mMessage;
                 break;
             case EngineError::Kind::VULKAN:
-                stream << "[VulkanError] " << std::hex << error.mResult << std::dec;
+                stream << "[VulkanError] " << std::hex << error.mCode << std::dec;
                 break;
             case EngineError::Kind::EXTENSIONS_NOT_PRESENT:
-                stream << "[ExtensionsNotPresent] [";
-                for (size_t i = 0, size = error.mExtensions.size(); i < size; i++) {
-                    stream << error.mExtensions[i];
-                    if(i < size - 1) stream << ", ";
-                }
-                stream << ']';
+                stream << "[ExtensionsNotPresent] [" << error.mMessage << ']';
                 break;
             case EngineError::Kind::NO_DEVICE:
                 stream << "[NoDevice] No suitable graphics device found";
                 break;
             case EngineError::Kind::OS_ERROR:
-                stream << "[OsError] " << error.mErrorCode.message();
+                stream << "[OsError] " << error.mCategory->message(error.mCode);
                 break;
             case EngineError::Kind::MISSING_VERTEX_SHADER:
                 stream << "[MissingVertexShaderError] Loaded shaders must include a vertex shader";
                 break;
+            case EngineError::Kind::PUSH_CONSTANTS_TOO_LARGE:
+                stream << "[PushConstantsTooLarge] Push constant ranges exceed device's maxPushConstantsSize";
+                break;
+            case EngineError::Kind::FEATURE_NOT_SUPPORTED:
+                stream << "[FeatureNotSupported] Device does not support " << error.mMessage;
+                break;
+            case EngineError::Kind::INVALID_FILE:
+                stream << "[InvalidFile] " << error.mMessage;
+                break;
         }
 
         return stream;
     }
 
     EngineError EngineError::fromSdlError(const char* error) {
-        return EngineError(std::string{error}, Kind::SDL);
-    }
-
-    EngineError EngineError::fromVkError(VkResult result) {
-        return EngineError(result, Kind::VULKAN);
+        return EngineError(Kind::SDL, pool(error));
     }
 
     EngineError EngineError::extensionsNotPresent(std::vector<const char*> extensions) {
-        return EngineError(std::move(extensions), Kind::EXTENSIONS_NOT_PRESENT);
-    }
+        std::string list;
+        for (size_t i = 0, size = extensions.size(); i < size; i++) {
+            list += extensions[i];
+            if (i < size - 1) list += ", ";
+        }
 
-    EngineError EngineError::noDevice() {
-        return EngineError(Kind::NO_DEVICE);
+        return EngineError(Kind::EXTENSIONS_NOT_PRESENT, pool(std::move(list)));
     }
 
     EngineError EngineError::fromOsError(std::error_code code) {
-        return EngineError(code, Kind::OS_ERROR);
-    }
-
-    EngineError EngineError::missingVertexShader() {
-        return EngineError(Kind::MISSING_VERTEX_SHADER);
-    }
-
-    EngineError::EngineError(std::string&& str, Kind kind) : mMessage{str}, mKind{kind} {
+        EngineError error(Kind::OS_ERROR, code.value());
+        error.mCategory = &code.category();
+        return error;
     }
 
-    EngineError::EngineError(VkResult result, Kind kind) : mResult{result}, mKind{kind} {
+    EngineError EngineError::featureNotSupported(const char* feature) {
+        return EngineError(Kind::FEATURE_NOT_SUPPORTED, feature);
     }
 
-    EngineError::EngineError(std::vector<const char*>&& extensions, Kind kind) : mExtensions{std::move(extensions)}, mKind{kind} {
+    EngineError EngineError::invalidFile(const char* reason) {
+        return EngineError(Kind::INVALID_FILE, reason);
     }
 
-    EngineError::EngineError(std::error_code code, Kind kind) : mErrorCode{code}, mKind{kind} {
-    }
-
-    EngineError::EngineError(Kind kind) : mKind{kind} {
-    }
-
-    void EngineError::swap(EngineError&& other) noexcept {
-        switch (other.mKind) {
-            case Kind::NONE:
-                break;
-            case Kind::SDL:
-                new (&mMessage) std::string(std::move(other.mMessage));
-//                mMessage = std::move(other.mMessage);
-                break;
-        }
-
-        other.mKind = Kind::NONE;
-    }
-
-    void EngineError::copy(const EngineError& other) {
-        switch (other.mKind) {
-            case Kind::NONE:
-                break;
-            case Kind::SDL:
-                mMessage = other.mMessage;
-                break;
-        }
-    }
-
-    void EngineError::clear() noexcept {
-        switch (mKind) {
-            case Kind::NONE:
-            case Kind::VULKAN:
-            case Kind::NO_DEVICE:
-            case Kind::MISSING_VERTEX_SHADER:
-                break;
-            case Kind::SDL:
-                mMessage.std::string::~string();
-                break;
-            case Kind::EXTENSIONS_NOT_PRESENT:
-                mExtensions.std::vector<const char*>::~vector();
-                break;
-            case Kind::OS_ERROR:
-                mErrorCode.std::error_code::~error_code();
-                break;
-        }
-
-        mKind = Kind::NONE;
+    EngineError::EngineError(Kind kind, const char* message) : mMessage{message}, mCode{0}, mKind{kind} {
     }
 }
@@ -0,0 +1,170 @@
+#include <cstring>
+#include "engine/EntityStore.hpp"
+
+namespace vke {
+
+    void EntityCommands::push(std::function<void(EntityStore&)> command) {
+        std::lock_guard lock{mMutex};
+        mCommands.push_back(std::move(command));
+    }
+
+    void EntityCommands::destroy(Entity entity) {
+        push([entity](EntityStore& store) {
+            store.destroy(entity);
+        });
+    }
+
+    void EntityCommands::apply(EntityStore& store) {
+        std::vector<std::function<void(EntityStore&)>> commands;
+        {
+            std::lock_guard lock{mMutex};
+            commands.swap(mCommands);
+        }
+
+        for (std::function<void(EntityStore&)>& command : commands) {
+            command(store);
+        }
+    }
+
+    bool EntityCommands::empty() {
+        std::lock_guard lock{mMutex};
+        return mCommands.empty();
+    }
+
+    EntityStore::EntityStore() : mArchetypes{}, mArchetypeIndexes{}, mRecords{}, mFreeIndexes{}, mCommands{}, mSize{0} {
+    }
+
+    uint32_t EntityStore::getArchetype(Signature signature) {
+        if (auto it = mArchetypeIndexes.find(signature); it != mArchetypeIndexes.end()) {
+            return it->second;
+        }
+
+        uint32_t index = mArchetypes.size();
+        mArchetypes.push_back(std::make_unique<Archetype>(signature));
+        mArchetypeIndexes.emplace(signature, index);
+
+        return index;
+    }
+
+    Entity EntityStore::allocate(uint32_t archetype) {
+        uint32_t index;
+        if (!mFreeIndexes.empty()) {
+            index = mFreeIndexes.back();
+            mFreeIndexes.pop_back();
+        } else {
+            index = mRecords.size();
+            mRecords.push_back({ 0, {}, 0, false });
+        }
+
+        Record& record = mRecords[index];
+        Entity entity{ index, record.generation };
+
+        record.archetype = archetype;
+        record.location = mArchetypes[archetype]->allocate(entity);
+        record.alive = true;
+        mSize++;
+
+        return entity;
+    }
+
+    Entity EntityStore::create() {
+        return allocate(getArchetype(0));
+    }
+
+    bool EntityStore::destroy(Entity entity) {
+        // a stale handle would remove the row of whatever entity reuses its index
+        if (!isAlive(entity))
+            return false;
+
+        Record& record = mRecords[entity.index];
+
+        Entity moved = mArchetypes[record.archetype]->remove(record.location);
+        if (moved != entity) {
+            mRecords[moved.index].location = record.location;
+        }
+
+        // bumping generation invalidates every handle still pointing to this index
+        record.generation++;
+        record.alive = false;
+        mFreeIndexes.push_back(entity.index);
+        mSize--;
+
+        return true;
+    }
+
+    bool EntityStore::isAlive(Entity entity) const {
+        return entity.index < mRecords.size() && mRecords[entity.index].alive && mRecords[entity.index].generation == entity.generation;
+    }
+
+    size_t EntityStore::size() const {
+        return mSize;
+    }
+
+    void EntityStore::move(Entity entity, uint32_t archetype) {
+        Record& record = mRecords[entity.index];
+        Archetype& source = *mArchetypes[record.archetype];
+        Archetype& target = *mArchetypes[archetype];
+
+        Archetype::Location from = record.location;
+        Archetype::Location to = target.allocate(entity);
+
+        for (ComponentId id : target.getComponents()) {
+            if (source.hasComponent(id)) {
+                std::memcpy(target.getComponent(to, id), source.getComponent(from, id), ComponentRegistry::getInfo(id).size);
+            }
+        }
+
+        Entity moved = source.remove(from);
+        if (moved != entity) {
+            mRecords[moved.index].location = from;
+        }
+
+        record.archetype = archetype;
+        record.location = to;
+    }
+
+    void* EntityStore::addComponent(Entity entity, ComponentId id) {
+        if (!isAlive(entity))
+            return nullptr;
+
+        Signature signature = mArchetypes[mRecords[entity.index].archetype]->getSignature();
+
+        if (!((signature >> id) & 1)) {
+            move(entity, getArchetype(signature | (Signature{1} << id)));
+        }
+
+        return getComponent(entity, id);
+    }
+
+    void EntityStore::removeComponent(Entity entity, ComponentId id) {
+        if (!isAlive(entity))
+            return;
+
+        Signature signature = mArchetypes[mRecords[entity.index].archetype]->getSignature();
+
+        if ((signature >> id) & 1) {
+            move(entity, getArchetype(signature & ~(Signature{1} << id)));
+        }
+    }
+
+    void* EntityStore::getComponent(Entity entity, ComponentId id) {
+        if (!isAlive(entity))
+            return nullptr;
+
+        const Record& record = mRecords[entity.index];
+        Archetype& archetype = *mArchetypes[record.archetype];
+
+        if (!archetype.hasComponent(id))
+            return nullptr;
+
+        return archetype.getComponent(record.location, id);
+    }
+
+    EntityCommands& EntityStore::getCommands() {
+        return mCommands;
+    }
+
+    void EntityStore::applyCommands() {
+        mCommands.apply(*this);
+    }
+}
@@ -0,0 +1,419 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include "engine/FrameCapture.hpp"
+#include "engine/Log.hpp"
+#include "engine/Trace.hpp"
+#include "engine/vk/dispatch.hpp"
+
+namespace vke {
+
+    namespace {
+        std::array<uint32_t, 256> makeCrcTable() {
+            std::array<uint32_t, 256> table{};
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t value = i;
+                for (int bit = 0; bit < 8; bit++) {
+                    value = value & 1 ? 0xEDB88320u ^ (value >> 1) : value >> 1;
+                }
+                table[i] = value;
+            }
+            return table;
+        }
+
+        uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0) {
+            static const std::array<uint32_t, 256> TABLE = makeCrcTable();
+
+            crc = ~crc;
+            for (size_t i = 0; i < size; i++) {
+                crc = TABLE[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+            }
+            return ~crc;
+        }
+
+        void putBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+            out.push_back(static_cast<uint8_t>(value >> 24));
+            out.push_back(static_cast<uint8_t>(value >> 16));
+            out.push_back(static_cast<uint8_t>(value >> 8));
+            out.push_back(static_cast<uint8_t>(value));
+        }
+
+        void putChunk(std::vector<uint8_t>& out, const char* type, const std::vector<uint8_t>& data) {
+            putBigEndian(out, static_cast<uint32_t>(data.size()));
+            size_t start = out.size();
+            out.insert(out.end(), type, type + 4);
+            out.insert(out.end(), data.begin(), data.end());
+            putBigEndian(out, crc32(out.data() + start, out.size() - start));
+        }
+
+        // zlib stream made of stored deflate blocks, PNG readers handle it like any other
+        std::vector<uint8_t> storeZlib(const std::vector<uint8_t>& data) {
+            constexpr size_t MAX_BLOCK = 65535;
+
+            std::vector<uint8_t> out;
+            out.reserve(data.size() + data.size() / MAX_BLOCK * 5 + 16);
+            out.push_back(0x78);
+            out.push_back(0x01);
+
+            size_t offset = 0;
+            do {
+                size_t length = std::min(MAX_BLOCK, data.size() - offset);
+                out.push_back(offset + length == data.size() ? 1 : 0);
+                out.push_back(static_cast<uint8_t>(length));
+                out.push_back(static_cast<uint8_t>(length >> 8));
+                out.push_back(static_cast<uint8_t>(~length));
+                out.push_back(static_cast<uint8_t>(~length >> 8));
+                out.insert(out.end(), data.begin() + offset, data.begin() + offset + length);
+                offset += length;
+            } while (offset < data.size());
+
+            uint32_t a = 1;
+            uint32_t b = 0;
+            for (uint8_t byte : data) {
+                a = (a + byte) % 65521;
+                b = (b + a) % 65521;
+            }
+            putBigEndian(out, (b << 16) | a);
+
+            return out;
+        }
+
+        std::vector<uint8_t> encodePng(const uint8_t* rgba, VkExtent2D extent) {
+            std::vector<uint8_t> header;
+            putBigEndian(header, extent.width);
+            putBigEndian(header, extent.height);
+            // 8 bits per channel, truecolor, default compression, filtering and no interlacing
+            header.insert(header.end(), { 8, 2, 0, 0, 0 });
+
+            // every row starts with filter type 0 and drops alpha, swapchain alpha is meaningless
+            std::vector<uint8_t> rows;
+            rows.reserve(static_cast<size_t>(extent.height) * (1 + extent.width * 3));
+            for (uint32_t y = 0; y < extent.height; y++) {
+                rows.push_back(0);
+                const uint8_t* row = rgba + static_cast<size_t>(y) * extent.width * 4;
+                for (uint32_t x = 0; x < extent.width; x++) {
+                    rows.insert(rows.end(), row + x * 4, row + x * 4 + 3);
+                }
+            }
+
+            static constexpr uint8_t SIGNATURE[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+            std::vector<uint8_t> png(std::begin(SIGNATURE), std::end(SIGNATURE));
+            putChunk(png, "IHDR", header);
+            putChunk(png, "IDAT", storeZlib(rows));
+            putChunk(png, "IEND", {});
+            return png;
+        }
+    }
+
+    std::ostream& operator<<(std::ostream& stream, const FrameCapture::Stats& stats) {
+        stream << "[CaptureStats] requested: " << stats.requested
+               << ", copied: " << stats.copied
+               << ", delivered: " << stats.delivered
+               << ", failed: " << stats.failed;
+        return stream;
+    }
+
+    FrameCapture::FrameCapture() : mDevice{VK_NULL_HANDLE}, mMemoryType{}, mRequests{}, mSlots{}, mMutex{}, mChanged{}, mJobs{}, mStopping{false},
+                                   mWorker{}, mStats{}, mDelivered{0}, mFailed{0} {
+    }
+
+    EngineResult<void> FrameCapture::init(VkDevice device, MemoryType memoryType, uint32_t slotCount) {
+        mDevice = device;
+        mMemoryType = memoryType;
+        // buffers are created on first use, most runs never capture anything
+        mSlots.resize(slotCount);
+        mStopping = false;
+        mWorker = std::thread(&FrameCapture::run, this);
+
+        return {};
+    }
+
+    void FrameCapture::cleanup() {
+        if (mDevice == VK_NULL_HANDLE)
+            return;
+
+        {
+            // device is idle, so every recorded copy is complete and can still be delivered
+            std::lock_guard lock(mMutex);
+            for (size_t i = 0; i < mSlots.size(); i++) {
+                if (mSlots[i].state == SlotState::RECORDED) {
+                    mSlots[i].state = SlotState::ENCODING;
+                    mJobs.push_back(i);
+                }
+            }
+            mStopping = true;
+        }
+        mChanged.notify_all();
+
+        if (mWorker.joinable()) {
+            mWorker.join();
+        }
+
+        for (Slot& slot : mSlots) {
+            if (slot.memory != VK_NULL_HANDLE) {
+                vkUnmapMemory(mDevice, slot.memory);
+            }
+            vkDestroyBuffer(mDevice, slot.buffer, nullptr);
+            vkFreeMemory(mDevice, slot.memory, nullptr);
+        }
+
+        mSlots.clear();
+        mRequests.clear();
+        mJobs.clear();
+        mDevice = VK_NULL_HANDLE;
+    }
+
+    void FrameCapture::capture(std::filesystem::path path, Encoding encoding) {
+        mRequests.push_back({ std::move(path), encoding, {} });
+        mStats.requested++;
+    }
+
+    void FrameCapture::capture(Callback callback) {
+        mRequests.push_back({ {}, Encoding::RAW, std::move(callback) });
+        mStats.requested++;
+    }
+
+    bool FrameCapture::isSupported(VkFormat format) {
+        switch (format) {
+            case VK_FORMAT_R8G8B8A8_UNORM:
+            case VK_FORMAT_R8G8B8A8_SRGB:
+            case VK_FORMAT_B8G8R8A8_UNORM:
+            case VK_FORMAT_B8G8R8A8_SRGB:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    EngineResult<void> FrameCapture::record(VkCommandBuffer cmdBuffer, size_t frame, VkImage image, VkImageLayout layout, VkFormat format, VkExtent2D extent) {
+        VKE_TRACE_SCOPE("FrameCapture::record");
+
+        Slot* target = nullptr;
+
+        {
+            std::lock_guard lock(mMutex);
+
+            // copies recorded the last time this frame was in flight are done
+            for (size_t i = 0; i < mSlots.size(); i++) {
+                if (mSlots[i].state == SlotState::RECORDED && mSlots[i].frame == frame) {
+                    mSlots[i].state = SlotState::ENCODING;
+                    mJobs.push_back(i);
+                }
+            }
+
+            if (!mRequests.empty()) {
+                for (Slot& slot : mSlots) {
+                    if (slot.state == SlotState::FREE) {
+                        target = &slot;
+                        break;
+                    }
+                }
+            }
+        }
+        mChanged.notify_one();
+
+        // all slots on their way back, request waits for a later frame instead of stalling this one
+        if (!target)
+            return {};
+
+        if (!isSupported(format)) {
+            log::warn(log::Category::ENGINE, "Can not capture image of format ", format);
+            mRequests.pop_front();
+            mFailed++;
+            return {};
+        }
+
+        TRY(resize(*target, static_cast<uint64_t>(extent.width) * extent.height * 4));
+
+        target->request = std::move(mRequests.front());
+        mRequests.pop_front();
+        target->frame = frame;
+        target->format = format;
+        target->extent = extent;
+
+        VkImageMemoryBarrier2 barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+        // whatever wrote the image last, capturing is rare enough for a broad barrier
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_MEMORY_WRITE_BIT;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+        barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
+        barrier.oldLayout = layout;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+        VkDependencyInfo dependency{};
+        dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependency.imageMemoryBarrierCount = 1;
+        dependency.pImageMemoryBarriers = &barrier;
+        vkCmdPipelineBarrier2(cmdBuffer, &dependency);
+
+        VkBufferImageCopy region{};
+        region.bufferOffset = 0;
+        region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+        region.imageExtent = { extent.width, extent.height, 1 };
+        vkCmdCopyImageToBuffer(cmdBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, target->buffer, 1, &region);
+
+        // image goes back to where it was, copy gets visible to the host once the frame's fence signals
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_NONE;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+        barrier.dstAccessMask = VK_ACCESS_2_NONE;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        barrier.newLayout = layout;
+
+        VkMemoryBarrier2 hostBarrier{};
+        hostBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+        hostBarrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+        hostBarrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        hostBarrier.dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT;
+        hostBarrier.dstAccessMask = VK_ACCESS_2_HOST_READ_BIT;
+
+        dependency.memoryBarrierCount = 1;
+        dependency.pMemoryBarriers = &hostBarrier;
+        vkCmdPipelineBarrier2(cmdBuffer, &dependency);
+
+        {
+            std::lock_guard lock(mMutex);
+            target->state = SlotState::RECORDED;
+        }
+        mStats.copied++;
+
+        return {};
+    }
+
+    EngineResult<void> FrameCapture::resize(Slot& slot, uint64_t size) {
+        if (slot.size >= size)
+            return {};
+
+        if (slot.memory != VK_NULL_HANDLE) {
+            vkUnmapMemory(mDevice, slot.memory);
+        }
+        vkDestroyBuffer(mDevice, slot.buffer, nullptr);
+        vkFreeMemory(mDevice, slot.memory, nullptr);
+        slot = Slot{};
+
+        VkBufferCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        createInfo.size = size;
+        createInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (VkResult result = vkCreateBuffer(mDevice, &createInfo, nullptr, &slot.buffer)) {
+            return EngineError::fromVkError(result);
+        }
+
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(mDevice, slot.buffer, &requirements);
+
+        VkMemoryAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.allocationSize = requirements.size;
+        allocateInfo.memoryTypeIndex = mMemoryType.getTypeIndex();
+        if (VkResult result = vkAllocateMemory(mDevice, &allocateInfo, nullptr, &slot.memory)) {
+            return EngineError::fromVkError(result);
+        }
+
+        if (VkResult result = vkBindBufferMemory(mDevice, slot.buffer, slot.memory, 0)) {
+            return EngineError::fromVkError(result);
+        }
+
+        void* data;
+        if (VkResult result = vkMapMemory(mDevice, slot.memory, 0, VK_WHOLE_SIZE, 0, &data)) {
+            return EngineError::fromVkError(result);
+        }
+        slot.data = static_cast<char*>(data);
+        slot.size = size;
+
+        return {};
+    }
+
+    void FrameCapture::run() {
+        VKE_TRACE_THREAD("Frame capture");
+
+        while (true) {
+            size_t index;
+
+            {
+                std::unique_lock lock(mMutex);
+                mChanged.wait(lock, [this] { return mStopping || !mJobs.empty(); });
+
+                // stopping still delivers what is queued
+                if (mJobs.empty())
+                    return;
+
+                index = mJobs.front();
+            }
+
+            encode(mSlots[index]);
+
+            {
+                std::lock_guard lock(mMutex);
+                mJobs.pop_front();
+                mSlots[index].state = SlotState::FREE;
+            }
+            mChanged.notify_all();
+        }
+    }
+
+    void FrameCapture::encode(Slot& slot) {
+        VKE_TRACE_SCOPE("FrameCapture::encode");
+
+        if (!mMemoryType.isHostCoherent()) {
+            VkMappedMemoryRange range{};
+            range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+            range.memory = slot.memory;
+            range.offset = 0;
+            range.size = VK_WHOLE_SIZE;
+            vkInvalidateMappedMemoryRanges(mDevice, 1, &range);
+        }
+
+        size_t pixelCount = static_cast<size_t>(slot.extent.width) * slot.extent.height;
+        std::vector<uint8_t> pixels(pixelCount * 4);
+        std::memcpy(pixels.data(), slot.data, pixels.size());
+
+        if (slot.format == VK_FORMAT_B8G8R8A8_UNORM || slot.format == VK_FORMAT_B8G8R8A8_SRGB) {
+            for (size_t i = 0; i < pixelCount; i++) {
+                std::swap(pixels[i * 4], pixels[i * 4 + 2]);
+            }
+        }
+
+        Request request = std::move(slot.request);
+
+        if (request.callback) {
+            request.callback(pixels.data(), slot.extent);
+            mDelivered++;
+            return;
+        }
+
+        std::ofstream file(request.path, std::ios::binary);
+        if (request.encoding == Encoding::PNG) {
+            std::vector<uint8_t> png = encodePng(pixels.data(), slot.extent);
+            file.write(reinterpret_cast<const char*>(png.data()), static_cast<std::streamsize>(png.size()));
+        } else {
+            file.write(reinterpret_cast<const char*>(pixels.data()), static_cast<std::streamsize>(pixels.size()));
+        }
+
+        if (!file) {
+            log::warn(log::Category::ENGINE, "Writing capture ", request.path, " failed");
+            mFailed++;
+            return;
+        }
+
+        mDelivered++;
+    }
+
+    void FrameCapture::flush() {
+        std::unique_lock lock(mMutex);
+        mChanged.wait(lock, [this] { return mJobs.empty(); });
+    }
+
+    const FrameCapture::Stats& FrameCapture::getStats() {
+        mStats.delivered = mDelivered;
+        mStats.failed = mFailed;
+        return mStats;
+    }
+}
@@ -0,0 +1,33 @@
+#include <cmath>
+#include "engine/Frustum.hpp"
+
+namespace vke {
+
+    Frustum Frustum::fromViewProjection(const float* matrix) {
+        Frustum frustum{};
+
+        // Gribb-Hartmann: planes are sums and differences of the matrix rows
+        auto row = [matrix](int r, int c) { return matrix[c * 4 + r]; };
+
+        for (int c = 0; c < 4; c++) {
+            frustum.planes[0][c] = row(3, c) + row(0, c);
+            frustum.planes[1][c] = row(3, c) - row(0, c);
+            frustum.planes[2][c] = row(3, c) + row(1, c);
+            frustum.planes[3][c] = row(3, c) - row(1, c);
+            frustum.planes[4][c] = row(2, c);
+            frustum.planes[5][c] = row(3, c) - row(2, c);
+        }
+
+        for (float* plane : frustum.planes) {
+            float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+            if (length == 0.0f)
+                continue;
+
+            for (int c = 0; c < 4; c++) {
+                plane[c] /= length;
+            }
+        }
+
+        return frustum;
+    }
+}
@@ -0,0 +1,271 @@
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include "engine/FrustumCuller.hpp"
+#include "engine/WorkerPool.hpp"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define VKE_CULL_AVX2
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define VKE_CULL_SSE
+#endif
+
+namespace vke {
+
+    namespace {
+        struct Range {
+            const float* cx;
+            const float* cy;
+            const float* cz;
+            const float* ex;
+            const float* ey;
+            const float* ez;
+            size_t begin;
+            size_t end;
+        };
+
+        // returns first index that was not processed
+        size_t cullScalar(const Range& range, bool boxes, const Frustum& frustum, size_t begin, std::vector<uint32_t>& visible) {
+            for (size_t i = begin; i < range.end; i++) {
+                bool inside = true;
+
+                for (const float* plane : frustum.planes) {
+                    float distance = plane[0] * range.cx[i] + plane[1] * range.cy[i] + plane[2] * range.cz[i] + plane[3];
+                    // projected radius of the box onto the plane normal, spheres keep radius in extentX
+                    float radius = boxes ? std::abs(plane[0]) * range.ex[i] + std::abs(plane[1]) * range.ey[i] + std::abs(plane[2]) * range.ez[i] : range.ex[i];
+
+                    if (distance < -radius) {
+                        inside = false;
+                        break;
+                    }
+                }
+
+                if (inside) {
+                    visible.push_back(static_cast<uint32_t>(i));
+                }
+            }
+
+            return range.end;
+        }
+
+#if defined(VKE_CULL_AVX2)
+        size_t cullSimd(const Range& range, bool boxes, const Frustum& frustum, std::vector<uint32_t>& visible) {
+            __m256 planes[6][4];
+            __m256 absPlanes[6][3];
+            for (int p = 0; p < 6; p++) {
+                for (int c = 0; c < 4; c++) {
+                    planes[p][c] = _mm256_set1_ps(frustum.planes[p][c]);
+                }
+                for (int c = 0; c < 3; c++) {
+                    absPlanes[p][c] = _mm256_set1_ps(std::abs(frustum.planes[p][c]));
+                }
+            }
+
+            size_t i = range.begin;
+            for (; i + 8 <= range.end; i += 8) {
+                __m256 cx = _mm256_loadu_ps(range.cx + i);
+                __m256 cy = _mm256_loadu_ps(range.cy + i);
+                __m256 cz = _mm256_loadu_ps(range.cz + i);
+                __m256 ex = _mm256_loadu_ps(range.ex + i);
+                __m256 ey = boxes ? _mm256_loadu_ps(range.ey + i) : _mm256_setzero_ps();
+                __m256 ez = boxes ? _mm256_loadu_ps(range.ez + i) : _mm256_setzero_ps();
+
+                __m256 outside = _mm256_setzero_ps();
+                for (int p = 0; p < 6; p++) {
+                    __m256 distance = _mm256_fmadd_ps(planes[p][0], cx, _mm256_fmadd_ps(planes[p][1], cy, _mm256_fmadd_ps(planes[p][2], cz, planes[p][3])));
+                    __m256 radius = boxes ? _mm256_fmadd_ps(absPlanes[p][0], ex, _mm256_fmadd_ps(absPlanes[p][1], ey, _mm256_mul_ps(absPlanes[p][2], ez))) : ex;
+                    // distance < -radius  <=>  distance + radius < 0
+                    outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_LT_OQ));
+                }
+
+                uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_ps(outside)) & 0xFF;
+                while (mask) {
+                    visible.push_back(static_cast<uint32_t>(i) + std::countr_zero(mask));
+                    mask &= mask - 1;
+                }
+            }
+
+            return i;
+        }
+#elif defined(VKE_CULL_SSE)
+        size_t cullSimd(const Range& range, bool boxes, const Frustum& frustum, std::vector<uint32_t>& visible) {
+            __m128 planes[6][4];
+            __m128 absPlanes[6][3];
+            for (int p = 0; p < 6; p++) {
+                for (int c = 0; c < 4; c++) {
+                    planes[p][c] = _mm_set1_ps(frustum.planes[p][c]);
+                }
+                for (int c = 0; c < 3; c++) {
+                    absPlanes[p][c] = _mm_set1_ps(std::abs(frustum.planes[p][c]));
+                }
+            }
+
+            size_t i = range.begin;
+            for (; i + 4 <= range.end; i += 4) {
+                __m128 cx = _mm_loadu_ps(range.cx + i);
+                __m128 cy = _mm_loadu_ps(range.cy + i);
+                __m128 cz = _mm_loadu_ps(range.cz + i);
+                __m128 ex = _mm_loadu_ps(range.ex + i);
+                __m128 ey = boxes ? _mm_loadu_ps(range.ey + i) : _mm_setzero_ps();
+                __m128 ez = boxes ? _mm_loadu_ps(range.ez + i) : _mm_setzero_ps();
+
+                __m128 outside = _mm_setzero_ps();
+                for (int p = 0; p < 6; p++) {
+                    __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(planes[p][0], cx), _mm_mul_ps(planes[p][1], cy)), _mm_add_ps(_mm_mul_ps(planes[p][2], cz), planes[p][3]));
+                    __m128 radius = boxes ? _mm_add_ps(_mm_add_ps(_mm_mul_ps(absPlanes[p][0], ex), _mm_mul_ps(absPlanes[p][1], ey)), _mm_mul_ps(absPlanes[p][2], ez)) : ex;
+                    outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+                }
+
+                uint32_t mask = ~static_cast<uint32_t>(_mm_movemask_ps(outside)) & 0xF;
+                while (mask) {
+                    visible.push_back(static_cast<uint32_t>(i) + std::countr_zero(mask));
+                    mask &= mask - 1;
+                }
+            }
+
+            return i;
+        }
+#endif
+
+        void cullRange(const Range& range, bool boxes, bool simd, const Frustum& frustum, std::vector<uint32_t>& visible) {
+            size_t next = range.begin;
+
+#if defined(VKE_CULL_AVX2) || defined(VKE_CULL_SSE)
+            if (simd) {
+                next = cullSimd(range, boxes, frustum, visible);
+            }
+#endif
+
+            // tail that does not fill a whole register
+            cullScalar(range, boxes, frustum, next, visible);
+        }
+
+        void push(std::vector<float>& column, uint32_t index, float value) {
+            if (index == column.size()) {
+                column.push_back(value);
+            } else {
+                column[index] = value;
+            }
+        }
+    }
+
+    FrustumCuller::FrustumCuller() : mSpheres{}, mBoxes{}, mChunkResults{}, mThreadCount{0}, mSimdEnabled{true} {
+    }
+
+    uint32_t FrustumCuller::addSphere(const float center[3], float radius) {
+        uint32_t index = mSpheres.centerX.size();
+        setSphere(index, center, radius);
+        return index;
+    }
+
+    void FrustumCuller::setSphere(uint32_t index, const float center[3], float radius) {
+        push(mSpheres.centerX, index, center[0]);
+        push(mSpheres.centerY, index, center[1]);
+        push(mSpheres.centerZ, index, center[2]);
+        push(mSpheres.extentX, index, radius);
+    }
+
+    uint32_t FrustumCuller::addBox(const float min[3], const float max[3]) {
+        uint32_t index = mBoxes.centerX.size();
+        setBox(index, min, max);
+        return index;
+    }
+
+    void FrustumCuller::setBox(uint32_t index, const float min[3], const float max[3]) {
+        push(mBoxes.centerX, index, (min[0] + max[0]) * 0.5f);
+        push(mBoxes.centerY, index, (min[1] + max[1]) * 0.5f);
+        push(mBoxes.centerZ, index, (min[2] + max[2]) * 0.5f);
+        push(mBoxes.extentX, index, (max[0] - min[0]) * 0.5f);
+        push(mBoxes.extentY, index, (max[1] - min[1]) * 0.5f);
+        push(mBoxes.extentZ, index, (max[2] - min[2]) * 0.5f);
+    }
+
+    void FrustumCuller::clear() {
+        // keep capacity, sets are usually refilled every frame
+        for (Volumes* volumes : { &mSpheres, &mBoxes }) {
+            volumes->centerX.clear();
+            volumes->centerY.clear();
+            volumes->centerZ.clear();
+            volumes->extentX.clear();
+            volumes->extentY.clear();
+            volumes->extentZ.clear();
+        }
+    }
+
+    size_t FrustumCuller::getSphereCount() const {
+        return mSpheres.centerX.size();
+    }
+
+    size_t FrustumCuller::getBoxCount() const {
+        return mBoxes.centerX.size();
+    }
+
+    void FrustumCuller::setThreadCount(uint32_t threads) {
+        mThreadCount = threads;
+    }
+
+    void FrustumCuller::setSimdEnabled(bool enabled) {
+        mSimdEnabled = enabled;
+    }
+
+    uint32_t FrustumCuller::getSimdWidth() {
+#if defined(VKE_CULL_AVX2)
+        return 8;
+#elif defined(VKE_CULL_SSE)
+        return 4;
+#else
+        return 1;
+#endif
+    }
+
+    void FrustumCuller::cullSpheres(const Frustum& frustum, std::vector<uint32_t>& visible) {
+        cull(mSpheres, false, frustum, visible);
+    }
+
+    void FrustumCuller::cullBoxes(const Frustum& frustum, std::vector<uint32_t>& visible) {
+        cull(mBoxes, true, frustum, visible);
+    }
+
+    void FrustumCuller::cull(const Volumes& volumes, bool boxes, const Frustum& frustum, std::vector<uint32_t>& visible) {
+        size_t count = volumes.centerX.size();
+        visible.clear();
+        visible.reserve(count);
+
+        Range range{
+            volumes.centerX.data(), volumes.centerY.data(), volumes.centerZ.data(),
+            volumes.extentX.data(), volumes.extentY.data(), volumes.extentZ.data(),
+            0, count
+        };
+
+        WorkerPool& pool = WorkerPool::getShared();
+        uint32_t threads = mThreadCount != 0 ? mThreadCount : pool.getWorkerCount() + 1;
+        size_t chunks = std::min<size_t>(threads, count / (PARALLEL_THRESHOLD / 2));
+
+        if (count < PARALLEL_THRESHOLD || chunks < 2) {
+            cullRange(range, boxes, mSimdEnabled, frustum, visible);
+            return;
+        }
+
+        // chunk borders stay multiples of 8, so only the very last chunk has a scalar tail
+        size_t chunkSize = ((count + chunks - 1) / chunks + 7) & ~size_t{7};
+        mChunkResults.resize(chunks);
+
+        pool.run(chunks, [&](size_t c) {
+            Range chunk = range;
+            chunk.begin = std::min(count, c * chunkSize);
+            chunk.end = std::min(count, chunk.begin + chunkSize);
+
+            std::vector<uint32_t>& results = mChunkResults[c];
+            results.clear();
+            results.reserve(chunk.end - chunk.begin);
+            cullRange(chunk, boxes, mSimdEnabled, frustum, results);
+        }, threads);
+
+        // chunks are in index order, so concatenation keeps the output sorted
+        for (const std::vector<uint32_t>& results : mChunkResults) {
+            visible.insert(visible.end(), results.begin(), results.end());
+        }
+    }
+}
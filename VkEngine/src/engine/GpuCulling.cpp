@@ -0,0 +1,219 @@
+#include <cstring>
+#include "engine/GpuCulling.hpp"
+#include "engine/DescriptorWriter.hpp"
+#include "engine/vk/dispatch.hpp"
+
+namespace vke {
+
+    GpuCulling::GpuCulling() : mDevice{VK_NULL_HANDLE}, mSetLayout{VK_NULL_HANDLE}, mPipelineLayout{VK_NULL_HANDLE}, mPipeline{VK_NULL_HANDLE}, mDescriptorPool{VK_NULL_HANDLE}, mObjects{}, mVersion{0}, mObjectBuffers{}, mObjectMappings{}, mUploadedVersions{}, mDrawBuffers{}, mCountBuffers{}, mSets{}, mGeometry{}, mParams{}, mMaxObjects{0} {
+    }
+
+    EngineResult<void> GpuCulling::init(VkDevice device, VkShaderModule shader, VkDescriptorSetLayout setLayout, std::vector<Buffer>&& objectBuffers, std::vector<Buffer>&& drawBuffers, std::vector<Buffer>&& countBuffers, uint32_t maxObjects) {
+        mDevice = device;
+        mSetLayout = setLayout;
+        mObjectBuffers = std::move(objectBuffers);
+        mDrawBuffers = std::move(drawBuffers);
+        mCountBuffers = std::move(countBuffers);
+        mMaxObjects = maxObjects;
+        mObjects.reserve(maxObjects);
+
+        uint32_t frameCount = mObjectBuffers.size();
+
+        // refreshed every frame the objects changed, so the buffers stay mapped
+        for (Buffer& buffer : mObjectBuffers) {
+            if (auto mapped = buffer.map()) {
+                mObjectMappings.push_back(std::move(mapped).getOk());
+            } else {
+                return mapped;
+            }
+        }
+        mUploadedVersions.assign(frameCount, UINT64_MAX);
+
+        VkDescriptorPoolSize poolSize{};
+        poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        poolSize.descriptorCount = 3 * frameCount;
+
+        VkDescriptorPoolCreateInfo poolCreateInfo{};
+        poolCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolCreateInfo.maxSets = frameCount;
+        poolCreateInfo.poolSizeCount = 1;
+        poolCreateInfo.pPoolSizes = &poolSize;
+
+        if (VkResult result = vkCreateDescriptorPool(mDevice, &poolCreateInfo, nullptr, &mDescriptorPool)) {
+            return EngineError::fromVkError(result);
+        }
+
+        std::vector<VkDescriptorSetLayout> layouts{frameCount, mSetLayout};
+        mSets.resize(frameCount);
+
+        VkDescriptorSetAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocateInfo.descriptorPool = mDescriptorPool;
+        allocateInfo.descriptorSetCount = frameCount;
+        allocateInfo.pSetLayouts = layouts.data();
+
+        if (VkResult result = vkAllocateDescriptorSets(mDevice, &allocateInfo, mSets.data())) {
+            return EngineError::fromVkError(result);
+        }
+
+        DescriptorWriter writer;
+        for (uint32_t frame = 0; frame < frameCount; frame++) {
+            writer.writeBuffer(mSets[frame], 0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, mObjectBuffers[frame].getHandle(), 0, getObjectBufferSize())
+                  .writeBuffer(mSets[frame], 1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, mDrawBuffers[frame].getHandle(), 0, getDrawBufferSize())
+                  .writeBuffer(mSets[frame], 2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, mCountBuffers[frame].getHandle(), 0, sizeof(uint32_t));
+        }
+        writer.update(mDevice);
+
+        VkPushConstantRange pushConstantRange{};
+        pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstantRange.offset = 0;
+        pushConstantRange.size = sizeof(CullParams);
+
+        VkPipelineLayoutCreateInfo layoutCreateInfo{};
+        layoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        layoutCreateInfo.setLayoutCount = 1;
+        layoutCreateInfo.pSetLayouts = &mSetLayout;
+        layoutCreateInfo.pushConstantRangeCount = 1;
+        layoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+
+        if (VkResult result = vkCreatePipelineLayout(mDevice, &layoutCreateInfo, nullptr, &mPipelineLayout)) {
+            return EngineError::fromVkError(result);
+        }
+
+        VkComputePipelineCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+        createInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        createInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        createInfo.stage.module = shader;
+        createInfo.stage.pName = "main";
+        createInfo.layout = mPipelineLayout;
+
+        if (VkResult result = vkCreateComputePipelines(mDevice, VK_NULL_HANDLE, 1, &createInfo, nullptr, &mPipeline)) {
+            return EngineError::fromVkError(result);
+        }
+
+        return {};
+    }
+
+    void GpuCulling::cleanup() {
+        if (mDevice == VK_NULL_HANDLE)
+            return;
+
+        mObjectMappings.clear();
+        mObjectBuffers.clear();
+        mDrawBuffers.clear();
+        mCountBuffers.clear();
+        mSets.clear();
+
+        vkDestroyDescriptorPool(mDevice, mDescriptorPool, nullptr);
+        vkDestroyPipeline(mDevice, mPipeline, nullptr);
+        vkDestroyPipelineLayout(mDevice, mPipelineLayout, nullptr);
+
+        mDescriptorPool = VK_NULL_HANDLE;
+        mPipeline = VK_NULL_HANDLE;
+        mPipelineLayout = VK_NULL_HANDLE;
+        mDevice = VK_NULL_HANDLE;
+    }
+
+    bool GpuCulling::isEnabled() const {
+        return mPipeline != VK_NULL_HANDLE;
+    }
+
+    void GpuCulling::setGeometry(Mesh& mesh) {
+        mGeometry = mesh.makeDraw();
+    }
+
+    uint32_t GpuCulling::add(const GpuCullObject& object) {
+        if (mParams.objectCount >= mMaxObjects)
+            return UINT32_MAX;
+
+        uint32_t index = mParams.objectCount++;
+        mObjects.push_back(object);
+        mVersion++;
+
+        return index;
+    }
+
+    void GpuCulling::set(uint32_t index, const GpuCullObject& object) {
+        mObjects[index] = object;
+        mVersion++;
+    }
+
+    void GpuCulling::clear() {
+        mParams.objectCount = 0;
+        mObjects.clear();
+        mVersion++;
+    }
+
+    uint32_t GpuCulling::getObjectCount() const {
+        return mParams.objectCount;
+    }
+
+    void GpuCulling::setFrustum(const Frustum& frustum) {
+        mParams.frustum = frustum;
+    }
+
+    EngineResult<void> GpuCulling::dispatch(VkCommandBuffer cmdBuffer, size_t frame) {
+        // previous dispatch reading this buffer is done, its frame's fence was waited on
+        if (mUploadedVersions[frame] != mVersion) {
+            uint64_t bytes = mObjects.size() * sizeof(GpuCullObject);
+            std::memcpy(&mObjectMappings[frame][0], mObjects.data(), bytes);
+            TRY(mObjectMappings[frame].flush(0, bytes));
+            mUploadedVersions[frame] = mVersion;
+        }
+
+        vkCmdFillBuffer(cmdBuffer, mCountBuffers[frame].getHandle(), 0, sizeof(uint32_t), 0);
+
+        VkMemoryBarrier2 clearBarrier{};
+        clearBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+        clearBarrier.srcStageMask = VK_PIPELINE_STAGE_2_CLEAR_BIT;
+        clearBarrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        clearBarrier.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        clearBarrier.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+
+        VkDependencyInfo clearDependency{};
+        clearDependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        clearDependency.memoryBarrierCount = 1;
+        clearDependency.pMemoryBarriers = &clearBarrier;
+        vkCmdPipelineBarrier2(cmdBuffer, &clearDependency);
+
+        vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mPipeline);
+        vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, mPipelineLayout, 0, 1, &mSets[frame], 0, nullptr);
+        vkCmdPushConstants(cmdBuffer, mPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullParams), &mParams);
+        vkCmdDispatch(cmdBuffer, (mParams.objectCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+
+        VkMemoryBarrier2 drawBarrier{};
+        drawBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+        drawBarrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        drawBarrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+        drawBarrier.dstStageMask = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT;
+        drawBarrier.dstAccessMask = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT;
+
+        VkDependencyInfo drawDependency{};
+        drawDependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        drawDependency.memoryBarrierCount = 1;
+        drawDependency.pMemoryBarriers = &drawBarrier;
+        vkCmdPipelineBarrier2(cmdBuffer, &drawDependency);
+
+        return {};
+    }
+
+    void GpuCulling::draw(VkCommandBuffer cmdBuffer, size_t frame) {
+        if (mParams.objectCount == 0 || mGeometry.vertexBuffer == VK_NULL_HANDLE)
+            return;
+
+        VkDeviceSize offset = 0;
+        vkCmdBindVertexBuffers(cmdBuffer, 0, 1, &mGeometry.vertexBuffer, &offset);
+        vkCmdBindIndexBuffer(cmdBuffer, mGeometry.indexBuffer, 0, mGeometry.indexType);
+
+        vkCmdDrawIndexedIndirectCount(cmdBuffer, mDrawBuffers[frame].getHandle(), 0, mCountBuffers[frame].getHandle(), 0, mParams.objectCount, sizeof(VkDrawIndexedIndirectCommand));
+    }
+
+    VkDeviceSize GpuCulling::getObjectBufferSize() const {
+        return static_cast<VkDeviceSize>(mMaxObjects) * sizeof(GpuCullObject);
+    }
+
+    VkDeviceSize GpuCulling::getDrawBufferSize() const {
+        return static_cast<VkDeviceSize>(mMaxObjects) * sizeof(VkDrawIndexedIndirectCommand);
+    }
+}
@@ -0,0 +1,161 @@
+#include <algorithm>
+#include <bit>
+#include "engine/Image.hpp"
+#include "engine/vk/dispatch.hpp"
+
+namespace vke {
+
+    namespace {
+        VkImageMemoryBarrier2 makeBarrier(VkImage image, uint32_t baseLevel, uint32_t levelCount) {
+            VkImageMemoryBarrier2 barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = image;
+            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            barrier.subresourceRange.baseMipLevel = baseLevel;
+            barrier.subresourceRange.levelCount = levelCount;
+            barrier.subresourceRange.baseArrayLayer = 0;
+            barrier.subresourceRange.layerCount = 1;
+            return barrier;
+        }
+
+        void pipelineBarrier(VkCommandBuffer cmdBuffer, const VkImageMemoryBarrier2* barriers, uint32_t count) {
+            VkDependencyInfo dependency{};
+            dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+            dependency.imageMemoryBarrierCount = count;
+            dependency.pImageMemoryBarriers = barriers;
+            vkCmdPipelineBarrier2(cmdBuffer, &dependency);
+        }
+    }
+
+    Image::Image(VkImage image, VkImageView view, VkDeviceMemory memory, VkFormat format, VkExtent2D extent, uint32_t mipLevels) : mImage{image}, mView{view}, mMemory{memory}, mFormat{format}, mExtent{extent}, mMipLevels{mipLevels} {
+    }
+
+    Image::Image() : mImage{VK_NULL_HANDLE}, mView{VK_NULL_HANDLE}, mMemory{VK_NULL_HANDLE}, mFormat{VK_FORMAT_UNDEFINED}, mExtent{}, mMipLevels{0} {
+    }
+
+    Image::Image(Image&& other) noexcept : mImage{other.mImage}, mView{other.mView}, mMemory{other.mMemory}, mFormat{other.mFormat}, mExtent{other.mExtent}, mMipLevels{other.mMipLevels} {
+        other.mImage = VK_NULL_HANDLE;
+        other.mView = VK_NULL_HANDLE;
+        other.mMemory = VK_NULL_HANDLE;
+    }
+
+    Image& Image::operator=(Image&& other) noexcept {
+        if (this != &other) {
+            mImage = other.mImage;
+            mView = other.mView;
+            mMemory = other.mMemory;
+            mFormat = other.mFormat;
+            mExtent = other.mExtent;
+            mMipLevels = other.mMipLevels;
+
+            other.mImage = VK_NULL_HANDLE;
+            other.mView = VK_NULL_HANDLE;
+            other.mMemory = VK_NULL_HANDLE;
+        }
+
+        return *this;
+    }
+
+    uint32_t Image::getMipLevelCount(VkExtent2D extent) {
+        return std::bit_width(std::max({ extent.width, extent.height, 1u }));
+    }
+
+    VkExtent2D Image::getMipExtent(VkExtent2D extent, uint32_t level) {
+        return { std::max(extent.width >> level, 1u), std::max(extent.height >> level, 1u) };
+    }
+
+    void Image::recordUpload(VkCommandBuffer cmdBuffer, VkBuffer source, VkDeviceSize offset) const {
+        // whole chain goes to TRANSFER_DST at once, contents are overwritten anyway
+        VkImageMemoryBarrier2 barrier = makeBarrier(mImage, 0, mMipLevels);
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+        barrier.srcAccessMask = VK_ACCESS_2_NONE;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT | VK_PIPELINE_STAGE_2_BLIT_BIT;
+        barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        pipelineBarrier(cmdBuffer, &barrier, 1);
+
+        VkBufferImageCopy region{};
+        region.bufferOffset = offset;
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = 0;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageExtent = { mExtent.width, mExtent.height, 1 };
+        vkCmdCopyBufferToImage(cmdBuffer, source, mImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+        // every level is read by the blit right after it was written, so the chain is serial by nature
+        for (uint32_t level = 1; level < mMipLevels; level++) {
+            VkImageMemoryBarrier2 previous = makeBarrier(mImage, level - 1, 1);
+            previous.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT | VK_PIPELINE_STAGE_2_BLIT_BIT;
+            previous.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            previous.dstStageMask = VK_PIPELINE_STAGE_2_BLIT_BIT;
+            previous.dstAccessMask = VK_ACCESS_2_TRANSFER_READ_BIT;
+            previous.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            previous.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            pipelineBarrier(cmdBuffer, &previous, 1);
+
+            VkExtent2D sourceExtent = getMipExtent(mExtent, level - 1);
+            VkExtent2D targetExtent = getMipExtent(mExtent, level);
+
+            VkImageBlit blit{};
+            blit.srcSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level - 1, 0, 1 };
+            blit.srcOffsets[1] = { static_cast<int32_t>(sourceExtent.width), static_cast<int32_t>(sourceExtent.height), 1 };
+            blit.dstSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1 };
+            blit.dstOffsets[1] = { static_cast<int32_t>(targetExtent.width), static_cast<int32_t>(targetExtent.height), 1 };
+            vkCmdBlitImage(cmdBuffer, mImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, mImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+        }
+
+        // levels that were blitted from are in TRANSFER_SRC, the last one is still TRANSFER_DST
+        VkImageMemoryBarrier2 barriers[2];
+        uint32_t barrierCount = 0;
+
+        if (mMipLevels > 1) {
+            VkImageMemoryBarrier2& sources = barriers[barrierCount++];
+            sources = makeBarrier(mImage, 0, mMipLevels - 1);
+            sources.srcStageMask = VK_PIPELINE_STAGE_2_BLIT_BIT;
+            sources.srcAccessMask = VK_ACCESS_2_NONE;
+            sources.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+        }
+
+        VkImageMemoryBarrier2& last = barriers[barrierCount++];
+        last = makeBarrier(mImage, mMipLevels - 1, 1);
+        last.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT | VK_PIPELINE_STAGE_2_BLIT_BIT;
+        last.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+        last.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+
+        for (uint32_t i = 0; i < barrierCount; i++) {
+            barriers[i].dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+            barriers[i].dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
+            barriers[i].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        }
+
+        pipelineBarrier(cmdBuffer, barriers, barrierCount);
+    }
+
+    VkImage Image::getHandle() const {
+        return mImage;
+    }
+
+    VkImageView Image::getView() const {
+        return mView;
+    }
+
+    VkDeviceMemory Image::getMemory() const {
+        return mMemory;
+    }
+
+    VkFormat Image::getFormat() const {
+        return mFormat;
+    }
+
+    VkExtent2D Image::getExtent() const {
+        return mExtent;
+    }
+
+    uint32_t Image::getMipLevels() const {
+        return mMipLevels;
+    }
+}
@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <functional>
+#include "engine/InstanceBatcher.hpp"
+
+namespace vke {
+
+    size_t InstanceBatcher::BatchKeyHash::operator()(const BatchKey& key) const {
+        size_t hash = std::hash<VkBuffer>()(key.vertexBuffer);
+        hash ^= std::hash<VkBuffer>()(key.indexBuffer) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        hash ^= std::hash<uint32_t>()(static_cast<uint32_t>(key.indexType)) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+        return hash;
+    }
+
+    InstanceBatcher::InstanceBatcher() : mInstanceStride{0}, mBatches{}, mBatchIndexes{}, mTotalInstances{0} {
+    }
+
+    void InstanceBatcher::setInstanceStride(uint32_t stride) {
+        mInstanceStride = stride;
+    }
+
+    uint32_t InstanceBatcher::getInstanceStride() const {
+        return mInstanceStride;
+    }
+
+    void InstanceBatcher::add(Mesh& mesh, const void* data, size_t size) {
+        assert(size == mInstanceStride && "Instance data size must match the instance binding stride");
+
+        DrawCommand draw = mesh.makeDraw();
+        BatchKey key{ draw.vertexBuffer, draw.indexBuffer, draw.indexType };
+
+        size_t index;
+        if (auto it = mBatchIndexes.find(key); it != mBatchIndexes.end()) {
+            index = it->second;
+        } else {
+            index = mBatches.size();
+            mBatches.push_back({ key, draw, {}, 0 });
+            mBatchIndexes.emplace(key, index);
+        }
+
+        Batch& batch = mBatches[index];
+        if (batch.instanceCount == 0) {
+            // mesh behind the key may have changed since the batch was last used, index count included
+            batch.draw = draw;
+        }
+
+        size_t offset = static_cast<size_t>(batch.instanceCount) * mInstanceStride;
+        batch.instances.resize(offset + mInstanceStride, 0);
+        std::memcpy(batch.instances.data() + offset, data, std::min<size_t>(size, mInstanceStride));
+
+        batch.instanceCount++;
+        mTotalInstances++;
+    }
+
+    uint64_t InstanceBatcher::getRequiredBytes() const {
+        return mTotalInstances * mInstanceStride;
+    }
+
+    void InstanceBatcher::flush(char* mapped, VkBuffer instanceBuffer, DrawList& drawList) {
+        // a batch nothing was added to may belong to a destroyed mesh, keeping it would only grow the list
+        for (size_t i = 0; i < mBatches.size();) {
+            if (mBatches[i].instanceCount > 0) {
+                i++;
+                continue;
+            }
+
+            mBatchIndexes.erase(mBatches[i].key);
+            if (i != mBatches.size() - 1) {
+                mBatches[i] = std::move(mBatches.back());
+                mBatchIndexes[mBatches[i].key] = i;
+            }
+            mBatches.pop_back();
+        }
+
+        uint32_t firstInstance = 0;
+
+        for (Batch& batch : mBatches) {
+            size_t bytes = static_cast<size_t>(batch.instanceCount) * mInstanceStride;
+            std::memcpy(mapped + static_cast<size_t>(firstInstance) * mInstanceStride, batch.instances.data(), bytes);
+
+            DrawCommand draw = batch.draw;
+            draw.instanceBuffer = instanceBuffer;
+            draw.instanceCount = batch.instanceCount;
+            draw.firstInstance = firstInstance;
+            drawList.submit(draw);
+
+            firstInstance += batch.instanceCount;
+        }
+
+        clear();
+    }
+
+    void InstanceBatcher::clear() {
+        for (Batch& batch : mBatches) {
+            batch.instances.clear();
+            batch.instanceCount = 0;
+        }
+
+        mTotalInstances = 0;
+    }
+}
@@ -0,0 +1,165 @@
+#include "engine/IoRing.hpp"
+
+#if defined(VKE_IO_URING)
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace vke {
+
+#if defined(VKE_IO_URING)
+    namespace {
+        EngineError lastOsError() {
+            return EngineError::fromOsError({ errno, std::generic_category() });
+        }
+    }
+
+    IoRing::IoRing() : mFd{-1}, mSqHead{nullptr}, mSqTail{nullptr}, mSqMask{0}, mSqArray{nullptr}, mSqes{nullptr}, mSqEntries{0},
+                       mCqHead{nullptr}, mCqTail{nullptr}, mCqMask{0}, mCqes{nullptr}, mSqRing{MAP_FAILED}, mSqRingSize{0},
+                       mCqRing{MAP_FAILED}, mCqRingSize{0}, mSqesSize{0}, mPending{0} {
+    }
+
+    EngineResult<void> IoRing::init(unsigned entries) {
+        io_uring_params params{};
+        int fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd < 0)
+            return EngineResult<void>::error(lastOsError());
+
+        mFd = fd;
+        mSqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        mCqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+        // newer kernels put both rings in one mapping
+        bool singleMapping = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (singleMapping) {
+            mSqRingSize = mCqRingSize = std::max(mSqRingSize, mCqRingSize);
+        }
+
+        mSqRing = mmap(nullptr, mSqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (mSqRing == MAP_FAILED) {
+            EngineError error = lastOsError();
+            cleanup();
+            return EngineResult<void>::error(std::move(error));
+        }
+
+        if (singleMapping) {
+            mCqRing = mSqRing;
+        } else {
+            mCqRing = mmap(nullptr, mCqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            if (mCqRing == MAP_FAILED) {
+                EngineError error = lastOsError();
+                cleanup();
+                return EngineResult<void>::error(std::move(error));
+            }
+        }
+
+        mSqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = mmap(nullptr, mSqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            EngineError error = lastOsError();
+            cleanup();
+            return EngineResult<void>::error(std::move(error));
+        }
+
+        char* sqRing = static_cast<char*>(mSqRing);
+        char* cqRing = static_cast<char*>(mCqRing);
+        mSqHead = reinterpret_cast<unsigned*>(sqRing + params.sq_off.head);
+        mSqTail = reinterpret_cast<unsigned*>(sqRing + params.sq_off.tail);
+        mSqMask = *reinterpret_cast<unsigned*>(sqRing + params.sq_off.ring_mask);
+        mSqArray = reinterpret_cast<unsigned*>(sqRing + params.sq_off.array);
+        mSqEntries = params.sq_entries;
+        mSqes = static_cast<io_uring_sqe*>(sqes);
+        mCqHead = reinterpret_cast<unsigned*>(cqRing + params.cq_off.head);
+        mCqTail = reinterpret_cast<unsigned*>(cqRing + params.cq_off.tail);
+        mCqMask = *reinterpret_cast<unsigned*>(cqRing + params.cq_off.ring_mask);
+        mCqes = reinterpret_cast<io_uring_cqe*>(cqRing + params.cq_off.cqes);
+
+        return {};
+    }
+
+    void IoRing::cleanup() {
+        if (mSqes) {
+            munmap(mSqes, mSqesSize);
+        }
+        if (mCqRing != MAP_FAILED && mCqRing != mSqRing) {
+            munmap(mCqRing, mCqRingSize);
+        }
+        if (mSqRing != MAP_FAILED) {
+            munmap(mSqRing, mSqRingSize);
+        }
+        if (mFd >= 0) {
+            close(mFd);
+        }
+
+        *this = IoRing();
+    }
+
+    bool IoRing::isValid() const {
+        return mFd >= 0;
+    }
+
+    bool IoRing::queueRead(int fd, void* buffer, uint32_t size, uint64_t offset, uint64_t userData) {
+        unsigned tail = *mSqTail;
+        if (tail - __atomic_load_n(mSqHead, __ATOMIC_ACQUIRE) >= mSqEntries)
+            return false;
+
+        unsigned index = tail & mSqMask;
+        io_uring_sqe& sqe = mSqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = fd;
+        sqe.addr = reinterpret_cast<uint64_t>(buffer);
+        sqe.len = size;
+        sqe.off = offset;
+        sqe.user_data = userData;
+
+        mSqArray[index] = index;
+        // entry has to be visible before the kernel sees the new tail
+        __atomic_store_n(mSqTail, tail + 1, __ATOMIC_RELEASE);
+        mPending++;
+
+        return true;
+    }
+
+    EngineResult<void> IoRing::submit(unsigned waitFor) {
+        unsigned flags = waitFor > 0 ? IORING_ENTER_GETEVENTS : 0;
+
+        while (true) {
+            int result = static_cast<int>(syscall(__NR_io_uring_enter, mFd, mPending, waitFor, flags, nullptr, 0));
+            if (result >= 0) {
+                mPending -= std::min(mPending, static_cast<unsigned>(result));
+                return {};
+            }
+
+            if (errno != EINTR)
+                return EngineResult<void>::error(lastOsError());
+        }
+    }
+#else
+    IoRing::IoRing() {
+    }
+
+    EngineResult<void> IoRing::init(unsigned) {
+        return EngineResult<void>::error(EngineError::fromOsError(std::make_error_code(std::errc::function_not_supported)));
+    }
+
+    void IoRing::cleanup() {
+    }
+
+    bool IoRing::isValid() const {
+        return false;
+    }
+
+    bool IoRing::queueRead(int, void*, uint32_t, uint64_t, uint64_t) {
+        return false;
+    }
+
+    EngineResult<void> IoRing::submit(unsigned) {
+        return {};
+    }
+#endif
+}
@@ -0,0 +1,82 @@
+#ifndef IORING_HPP
+#define IORING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "engine/EngineResult.hpp"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define VKE_IO_URING
+#endif
+
+namespace vke {
+
+    // Minimal io_uring wrapper for batched file reads, talks to the kernel directly so there is no liburing
+    // dependency. Only one thread may use a ring.
+    class IoRing {
+#if defined(VKE_IO_URING)
+        int mFd;
+        unsigned* mSqHead;
+        unsigned* mSqTail;
+        unsigned mSqMask;
+        unsigned* mSqArray;
+        io_uring_sqe* mSqes;
+        unsigned mSqEntries;
+        unsigned* mCqHead;
+        unsigned* mCqTail;
+        unsigned mCqMask;
+        io_uring_cqe* mCqes;
+        void* mSqRing;
+        size_t mSqRingSize;
+        void* mCqRing;
+        size_t mCqRingSize;
+        size_t mSqesSize;
+        // queued but not yet handed to the kernel
+        unsigned mPending;
+#endif
+
+    public:
+        IoRing();
+
+        // Fails when kernel has no io_uring or it is blocked (seccomp, containers), callers fall back to blocking reads
+        EngineResult<void> init(unsigned entries);
+        void cleanup();
+        bool isValid() const;
+
+        // False when submission queue is full, submit() first
+        bool queueRead(int fd, void* buffer, uint32_t size, uint64_t offset, uint64_t userData);
+        // Hands queued reads to the kernel and blocks until at least waitFor completions are available
+        EngineResult<void> submit(unsigned waitFor);
+
+        // Calls f(userData, result) for every available completion, result is bytes read or -errno
+        template<typename F>
+        size_t drain(F&& f);
+    };
+
+#if defined(VKE_IO_URING)
+    template<typename F>
+    size_t IoRing::drain(F&& f) {
+        size_t count = 0;
+        unsigned head = *mCqHead;
+
+        // kernel publishes the tail with release semantics, entries before it are complete
+        while (head != __atomic_load_n(mCqTail, __ATOMIC_ACQUIRE)) {
+            const io_uring_cqe& cqe = mCqes[head & mCqMask];
+            f(cqe.user_data, cqe.res);
+            head++;
+            count++;
+        }
+
+        __atomic_store_n(mCqHead, head, __ATOMIC_RELEASE);
+        return count;
+    }
+#else
+    template<typename F>
+    size_t IoRing::drain(F&&) {
+        return 0;
+    }
+#endif
+}
+
+#endif
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "engine/Ktx2File.hpp"
+
+namespace vke {
+
+    namespace {
+        EngineError lastOsError() {
+            return EngineError::fromOsError({ errno, std::generic_category() });
+        }
+
+        const Ktx2File::Level* getLevels(const void* data) {
+            return reinterpret_cast<const Ktx2File::Level*>(static_cast<const char*>(data) + sizeof(Ktx2File::Header));
+        }
+    }
+
+    Ktx2File::Ktx2File(const char* data, size_t size) : mData{data}, mSize{size} {
+    }
+
+    Ktx2File::Ktx2File() : mData{nullptr}, mSize{0} {
+    }
+
+    Ktx2File::~Ktx2File() {
+        if (mData) {
+            munmap(const_cast<char*>(mData), mSize);
+        }
+    }
+
+    Ktx2File::Ktx2File(Ktx2File&& other) noexcept : mData{std::exchange(other.mData, nullptr)}, mSize{std::exchange(other.mSize, 0)} {
+    }
+
+    Ktx2File& Ktx2File::operator=(Ktx2File&& other) noexcept {
+        if (this != &other) {
+            this->Ktx2File::~Ktx2File();
+
+            mData = std::exchange(other.mData, nullptr);
+            mSize = std::exchange(other.mSize, 0);
+        }
+
+        return *this;
+    }
+
+    EngineResult<Ktx2File> Ktx2File::open(const std::filesystem::path& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return EngineResult<Ktx2File>::error(lastOsError());
+
+        struct stat info{};
+        if (fstat(fd, &info) != 0) {
+            EngineError error = lastOsError();
+            close(fd);
+            return EngineResult<Ktx2File>::error(std::move(error));
+        }
+
+        size_t size = static_cast<size_t>(info.st_size);
+        if (size < sizeof(Header)) {
+            close(fd);
+            return EngineResult<Ktx2File>::error(EngineError::invalidFile("too small for a KTX2 header"));
+        }
+
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        // mapping keeps the file referenced on its own
+        close(fd);
+
+        if (mapping == MAP_FAILED)
+            return EngineResult<Ktx2File>::error(lastOsError());
+
+        // levels are streamed smallest first over several frames, so no sequential hint, but start reading them now
+        madvise(mapping, size, MADV_WILLNEED);
+
+        Ktx2File file(static_cast<const char*>(mapping), size);
+
+        if (const char* problem = validate(mapping, size))
+            return EngineResult<Ktx2File>::error(EngineError::invalidFile(problem));
+
+        return file;
+    }
+
+    const char* Ktx2File::validate(const void* data, size_t size) {
+        if (size < sizeof(Header))
+            return "too small for a KTX2 header";
+
+        const Header& header = *static_cast<const Header*>(data);
+        if (std::memcmp(header.identifier, IDENTIFIER, sizeof(IDENTIFIER)) != 0)
+            return "not a KTX2 file";
+        if (header.vkFormat == VK_FORMAT_UNDEFINED)
+            return "formats needing transcoding are not supported";
+        if (header.supercompressionScheme != 0)
+            return "supercompression is not supported";
+        if (header.pixelWidth == 0 || header.pixelHeight == 0 || header.pixelDepth != 0)
+            return "only 2D textures are supported";
+        if (header.layerCount > 1 || header.faceCount != 1)
+            return "array and cube textures are not supported";
+
+        uint32_t levelCount = std::max(header.levelCount, 1u);
+        if (levelCount > std::bit_width(std::max(header.pixelWidth, header.pixelHeight)))
+            return "more levels than the extent allows";
+        if ((size - sizeof(Header)) / sizeof(Level) < levelCount)
+            return "level index extends past end of file";
+
+        const Level* levels = getLevels(data);
+        for (uint32_t i = 0; i < levelCount; i++) {
+            if (levels[i].byteLength == 0 || levels[i].byteOffset > size || levels[i].byteLength > size - levels[i].byteOffset)
+                return "level extends past end of file";
+        }
+
+        return nullptr;
+    }
+
+    const Ktx2File::Header& Ktx2File::getHeader() const {
+        return *reinterpret_cast<const Header*>(mData);
+    }
+
+    VkFormat Ktx2File::getFormat() const {
+        return static_cast<VkFormat>(getHeader().vkFormat);
+    }
+
+    VkExtent2D Ktx2File::getExtent() const {
+        return { getHeader().pixelWidth, getHeader().pixelHeight };
+    }
+
+    uint32_t Ktx2File::getLevelCount() const {
+        return std::max(getHeader().levelCount, 1u);
+    }
+
+    const void* Ktx2File::getLevelData(uint32_t level) const {
+        return mData + getLevels(mData)[level].byteOffset;
+    }
+
+    uint64_t Ktx2File::getLevelBytes(uint32_t level) const {
+        return getLevels(mData)[level].byteLength;
+    }
+}
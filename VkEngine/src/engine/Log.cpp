@@ -0,0 +1,296 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include "engine/Log.hpp"
+
+namespace vke::log {
+
+    namespace detail {
+        std::atomic<Level> gLevels[CATEGORY_COUNT] = { Level::DEBUG, Level::WARN, Level::WARN, Level::WARN };
+    }
+
+    namespace {
+        constexpr size_t RING_SLOTS = 1024;
+        constexpr size_t THROTTLE_ENTRIES = 256;
+
+        // Slot sequence equals its position while free for that position, position + 1 once the message is in
+        // (bounded MPMC queue by Dmitry Vyukov, with a single consumer)
+        struct Slot {
+            std::atomic<uint64_t> sequence;
+            Level level;
+            Category category;
+            uint16_t length;
+            char text[MAX_MESSAGE];
+        };
+
+        struct ThrottleEntry {
+            std::atomic<uint64_t> key{0};
+            // window second in the upper half, messages seen in it in the lower half
+            std::atomic<uint64_t> state{0};
+        };
+
+        class Writer {
+            Slot mSlots[RING_SLOTS];
+            alignas(64) std::atomic<uint64_t> mEnqueue{0};
+            // bumped after every message and on stop, the writer sleeps on it
+            alignas(64) std::atomic<uint64_t> mPublished{0};
+            // position up to which messages are written, flush() sleeps on it
+            alignas(64) std::atomic<uint64_t> mConsumed{0};
+            std::atomic<uint64_t> mWritten{0};
+            std::atomic<uint64_t> mDropped{0};
+            std::atomic<uint64_t> mSuppressed{0};
+            std::atomic<bool> mStopping{false};
+            ThrottleEntry mThrottle[THROTTLE_ENTRIES];
+            std::thread mThread;
+
+            void run() {
+                uint64_t position = 0;
+                uint64_t reportedDrops = 0;
+                std::string batch;
+
+                while (true) {
+                    uint64_t published = mPublished.load(std::memory_order_acquire);
+
+                    batch.clear();
+                    uint64_t written = 0;
+                    while (true) {
+                        Slot& slot = mSlots[position % RING_SLOTS];
+                        if (slot.sequence.load(std::memory_order_acquire) != position + 1)
+                            break;
+
+                        append(batch, slot.level, slot.category);
+                        batch.append(slot.text, slot.length);
+                        batch += '\n';
+
+                        slot.sequence.store(position + RING_SLOTS, std::memory_order_release);
+                        position++;
+                        written++;
+                    }
+
+                    uint64_t dropped = mDropped.load(std::memory_order_relaxed);
+                    if (dropped != reportedDrops) {
+                        append(batch, Level::WARN, Category::ENGINE);
+                        batch += std::to_string(dropped - reportedDrops) + " log messages dropped, ring was full\n";
+                        reportedDrops = dropped;
+                    }
+
+                    // one write per batch, however many messages piled up while the last one was written
+                    if (!batch.empty()) {
+                        std::cout.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+                        std::cout.flush();
+                        mWritten.fetch_add(written, std::memory_order_relaxed);
+                        mConsumed.store(position, std::memory_order_release);
+                        mConsumed.notify_all();
+                    }
+
+                    if (mStopping.load(std::memory_order_acquire) && position == mEnqueue.load(std::memory_order_acquire))
+                        return;
+
+                    mPublished.wait(published, std::memory_order_acquire);
+                }
+            }
+
+            static void append(std::string& batch, Level level, Category category) {
+                switch (level) {
+                    case Level::DEBUG:
+                        batch += "[ENGINE] [DEBUG]: ";
+                        break;
+                    case Level::INFO:
+                        batch += "[ENGINE] [INFO]: ";
+                        break;
+                    case Level::WARN:
+                        batch += "[ENGINE] [WARN]: ";
+                        break;
+                    case Level::ERROR:
+                        batch += "[ENGINE] [ERROR]: ";
+                        break;
+                }
+
+                switch (category) {
+                    case Category::ENGINE:
+                        break;
+                    case Category::VULKAN:
+                        batch += "[Vulkan/General] ";
+                        break;
+                    case Category::VALIDATION:
+                        batch += "[Vulkan/Validation] ";
+                        break;
+                    case Category::PERFORMANCE:
+                        batch += "[Vulkan/Performance] ";
+                        break;
+                }
+            }
+
+            void wake() {
+                mPublished.fetch_add(1, std::memory_order_release);
+                mPublished.notify_one();
+            }
+
+        public:
+            Writer() {
+                for (size_t i = 0; i < RING_SLOTS; i++) {
+                    mSlots[i].sequence.store(i, std::memory_order_relaxed);
+                }
+
+                mThread = std::thread(&Writer::run, this);
+            }
+
+            // messages logged before exit are still written
+            ~Writer() {
+                mStopping.store(true, std::memory_order_release);
+                wake();
+                mThread.join();
+            }
+
+            void push(Level level, Category category, const char* text, size_t length) {
+                uint64_t position = mEnqueue.load(std::memory_order_relaxed);
+                Slot* slot;
+
+                while (true) {
+                    slot = &mSlots[position % RING_SLOTS];
+                    uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+                    int64_t difference = static_cast<int64_t>(sequence - position);
+
+                    if (difference == 0) {
+                        if (mEnqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                            break;
+                    } else if (difference < 0) {
+                        // writer is a whole ring behind, rather lose the message than stall the caller
+                        mDropped.fetch_add(1, std::memory_order_relaxed);
+                        return;
+                    } else {
+                        position = mEnqueue.load(std::memory_order_relaxed);
+                    }
+                }
+
+                slot->level = level;
+                slot->category = category;
+                slot->length = static_cast<uint16_t>(length);
+                std::memcpy(slot->text, text, length);
+                slot->sequence.store(position + 1, std::memory_order_release);
+
+                wake();
+            }
+
+            void flush() {
+                uint64_t target = mEnqueue.load(std::memory_order_acquire);
+
+                uint64_t consumed = mConsumed.load(std::memory_order_acquire);
+                while (consumed < target) {
+                    mConsumed.wait(consumed, std::memory_order_acquire);
+                    consumed = mConsumed.load(std::memory_order_acquire);
+                }
+            }
+
+            bool throttle(uint64_t key, uint32_t limit, uint64_t& suppressed) {
+                suppressed = 0;
+
+                uint64_t second = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count()) & UINT32_MAX;
+                ThrottleEntry& entry = mThrottle[(key * 0x9E3779B97F4A7C15ull) >> 56];
+
+                // racing takeovers of an entry only reset a count
+                if (entry.key.load(std::memory_order_relaxed) != key) {
+                    entry.key.store(key, std::memory_order_relaxed);
+                    entry.state.store((second << 32) | 1, std::memory_order_relaxed);
+                    return true;
+                }
+
+                uint64_t state = entry.state.load(std::memory_order_relaxed);
+                uint64_t next;
+                do {
+                    next = (state >> 32) == second ? state + 1 : (second << 32) | 1;
+                } while (!entry.state.compare_exchange_weak(state, next, std::memory_order_relaxed));
+
+                if ((state >> 32) != second) {
+                    uint64_t previous = state & UINT32_MAX;
+                    suppressed = previous > limit ? previous - limit : 0;
+                    return true;
+                }
+
+                if ((next & UINT32_MAX) <= limit)
+                    return true;
+
+                mSuppressed.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            Stats getStats() const {
+                return { mWritten.load(std::memory_order_relaxed), mDropped.load(std::memory_order_relaxed), mSuppressed.load(std::memory_order_relaxed) };
+            }
+        };
+
+        Writer& getWriter() {
+            static Writer writer;
+            return writer;
+        }
+
+        // Fills a fixed array, whatever does not fit is discarded
+        class MessageBuffer : public std::streambuf {
+            char mText[MAX_MESSAGE];
+
+        public:
+            void reset() {
+                setp(mText, mText + MAX_MESSAGE);
+            }
+
+            const char* data() const {
+                return pbase();
+            }
+
+            size_t size() const {
+                return static_cast<size_t>(pptr() - pbase());
+            }
+        };
+
+        struct MessageStream {
+            MessageBuffer buffer;
+            std::ostream stream{&buffer};
+            std::ios::fmtflags flags = stream.flags();
+        };
+
+        thread_local MessageStream tMessage;
+    }
+
+    namespace detail {
+        std::ostream& begin() {
+            tMessage.buffer.reset();
+            // a full buffer sets badbit, and manipulators of the last message must not leak into this one
+            tMessage.stream.clear();
+            tMessage.stream.flags(tMessage.flags);
+            tMessage.stream.precision(6);
+            tMessage.stream.width(0);
+            return tMessage.stream;
+        }
+
+        void commit(Level level, Category category) {
+            getWriter().push(level, category, tMessage.buffer.data(), tMessage.buffer.size());
+        }
+    }
+
+    void setLevel(Category category, Level level) {
+        detail::gLevels[static_cast<size_t>(category)].store(level, std::memory_order_relaxed);
+    }
+
+    bool throttle(uint64_t key, uint32_t limit, uint64_t& suppressed) {
+        return getWriter().throttle(key, limit, suppressed);
+    }
+
+    void flush() {
+        getWriter().flush();
+    }
+
+    Stats getStats() {
+        return getWriter().getStats();
+    }
+
+    std::ostream& operator<<(std::ostream& stream, const Stats& stats) {
+        stream << "[LogStats] written: " << stats.written
+               << ", dropped: " << stats.dropped
+               << ", suppressed: " << stats.suppressed;
+        return stream;
+    }
+}
@@ -0,0 +1,203 @@
+#include "engine/Math.hpp"
+#include "engine/Simd.hpp"
+
+namespace vke {
+
+    namespace {
+        using namespace simd;
+
+        // c0 * x + c1 * y + c2 * z + c3 * w with x, y, z, w taken from the lanes of v
+        template<typename F>
+        F combine(F c0, F c1, F c2, F c3, F v) {
+            return madd(c0, splatLane<0>(v), madd(c1, splatLane<1>(v), madd(c2, splatLane<2>(v), mul(c3, splatLane<3>(v)))));
+        }
+
+        // same with w = 1
+        template<typename F>
+        F combinePoint(F c0, F c1, F c2, F c3, F v) {
+            return madd(c0, splatLane<0>(v), madd(c1, splatLane<1>(v), madd(c2, splatLane<2>(v), c3)));
+        }
+
+        // each output column is a linear combination of a's columns weighted by b's column
+        void multiplyColumns(Float4 a0, Float4 a1, Float4 a2, Float4 a3, const float* b, float* out) {
+#if defined(VKE_SIMD_AVX2)
+            // two output columns per instruction
+            Float8 c0{ _mm256_set_m128(a0.v, a0.v) };
+            Float8 c1{ _mm256_set_m128(a1.v, a1.v) };
+            Float8 c2{ _mm256_set_m128(a2.v, a2.v) };
+            Float8 c3{ _mm256_set_m128(a3.v, a3.v) };
+
+            Float8 low = combine(c0, c1, c2, c3, load8(b));
+            Float8 high = combine(c0, c1, c2, c3, load8(b + 8));
+            store(out, low);
+            store(out + 8, high);
+#else
+            Float4 r0 = combine(a0, a1, a2, a3, load(b));
+            Float4 r1 = combine(a0, a1, a2, a3, load(b + 4));
+            Float4 r2 = combine(a0, a1, a2, a3, load(b + 8));
+            Float4 r3 = combine(a0, a1, a2, a3, load(b + 12));
+            store(out, r0);
+            store(out + 4, r1);
+            store(out + 8, r2);
+            store(out + 12, r3);
+#endif
+        }
+
+        void transformBox(Float4 c0, Float4 c1, Float4 c2, Float4 c3, const Aabb& box, Aabb& out) {
+            Float4 half = splat(0.5f);
+            Float4 min = load(&box.min.x);
+            Float4 max = load(&box.max.x);
+            Float4 center = mul(add(min, max), half);
+            Float4 extent = mul(sub(max, min), half);
+
+            // Arvo: new extent is the old one projected onto the absolute rotation/scale part
+            Float4 newCenter = combinePoint(c0, c1, c2, c3, center);
+            Float4 newExtent = madd(abs(c0), splatLane<0>(extent), madd(abs(c1), splatLane<1>(extent), mul(abs(c2), splatLane<2>(extent))));
+
+            store(&out.min.x, sub(newCenter, newExtent));
+            store(&out.max.x, add(newCenter, newExtent));
+        }
+    }
+
+    Mat4 Mat4::identity() {
+        return { {
+            { 1.0f, 0.0f, 0.0f, 0.0f },
+            { 0.0f, 1.0f, 0.0f, 0.0f },
+            { 0.0f, 0.0f, 1.0f, 0.0f },
+            { 0.0f, 0.0f, 0.0f, 1.0f }
+        } };
+    }
+
+    Mat4 Mat4::translation(Vec3 offset) {
+        Mat4 m = identity();
+        m.columns[3] = { offset.x, offset.y, offset.z, 1.0f };
+        return m;
+    }
+
+    Mat4 Mat4::compose(Vec3 position, Quat rotation, Vec3 scale) {
+        float x = rotation.x, y = rotation.y, z = rotation.z, w = rotation.w;
+
+        return { {
+            { (1.0f - 2.0f * (y * y + z * z)) * scale.x, 2.0f * (x * y + w * z) * scale.x, 2.0f * (x * z - w * y) * scale.x, 0.0f },
+            { 2.0f * (x * y - w * z) * scale.y, (1.0f - 2.0f * (x * x + z * z)) * scale.y, 2.0f * (y * z + w * x) * scale.y, 0.0f },
+            { 2.0f * (x * z + w * y) * scale.z, 2.0f * (y * z - w * x) * scale.z, (1.0f - 2.0f * (x * x + y * y)) * scale.z, 0.0f },
+            { position.x, position.y, position.z, 1.0f }
+        } };
+    }
+
+    Mat4 Mat4::perspective(float fovY, float aspect, float near, float far) {
+        float f = 1.0f / std::tan(fovY * 0.5f);
+
+        return { {
+            { f / aspect, 0.0f, 0.0f, 0.0f },
+            { 0.0f, -f, 0.0f, 0.0f },
+            { 0.0f, 0.0f, far / (near - far), -1.0f },
+            { 0.0f, 0.0f, near * far / (near - far), 0.0f }
+        } };
+    }
+
+    Mat4 Mat4::lookAt(Vec3 eye, Vec3 center, Vec3 up) {
+        Vec3 f = normalize(center - eye);
+        Vec3 s = normalize(cross(f, up));
+        Vec3 u = cross(s, f);
+
+        return { {
+            { s.x, u.x, -f.x, 0.0f },
+            { s.y, u.y, -f.y, 0.0f },
+            { s.z, u.z, -f.z, 0.0f },
+            { -dot(s, eye), -dot(u, eye), dot(f, eye), 1.0f }
+        } };
+    }
+
+    Mat4 operator*(const Mat4& a, const Mat4& b) {
+        Mat4 out;
+        multiply(a.data(), b.data(), out.data());
+        return out;
+    }
+
+    Vec4 operator*(const Mat4& m, Vec4 v) {
+        Vec4 out;
+        store(&out.x, combine(load(m.data()), load(m.data() + 4), load(m.data() + 8), load(m.data() + 12), load(&v.x)));
+        return out;
+    }
+
+    Vec3 transformPoint(const Mat4& m, Vec3 point) {
+        Vec3 out;
+        transformPoints(m, &point, &out, 1);
+        return out;
+    }
+
+    Vec3 transformDirection(const Mat4& m, Vec3 direction) {
+        Vec4 out = m * Vec4{ direction.x, direction.y, direction.z, 0.0f };
+        return { out.x, out.y, out.z };
+    }
+
+    Aabb transformAabb(const Mat4& m, const Aabb& box) {
+        Aabb out;
+        transformAabbs(m, &box, &out, 1);
+        return out;
+    }
+
+    void transformPoints(const Mat4& m, const Vec3* points, Vec3* out, size_t count) {
+        size_t i = 0;
+
+#if defined(VKE_SIMD_AVX2)
+        Float8 c0 = broadcast4(m.data());
+        Float8 c1 = broadcast4(m.data() + 4);
+        Float8 c2 = broadcast4(m.data() + 8);
+        Float8 c3 = broadcast4(m.data() + 12);
+
+        // Vec3 is padded to 16 bytes, so two points fill a register
+        for (; i + 2 <= count; i += 2) {
+            store(&out[i].x, combinePoint(c0, c1, c2, c3, load8(&points[i].x)));
+        }
+#endif
+
+        Float4 d0 = load(m.data());
+        Float4 d1 = load(m.data() + 4);
+        Float4 d2 = load(m.data() + 8);
+        Float4 d3 = load(m.data() + 12);
+
+        for (; i < count; i++) {
+            // padding lane ends up as the point's w, which is harmless
+            store(&out[i].x, combinePoint(d0, d1, d2, d3, load(&points[i].x)));
+        }
+    }
+
+    void multiplyMatrices(const Mat4* a, const Mat4* b, Mat4* out, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            const float* left = a[i].data();
+            multiplyColumns(load(left), load(left + 4), load(left + 8), load(left + 12), b[i].data(), out[i].data());
+        }
+    }
+
+    void multiplyMatrices(const Mat4& a, const Mat4* b, Mat4* out, size_t count) {
+        Float4 a0 = load(a.data());
+        Float4 a1 = load(a.data() + 4);
+        Float4 a2 = load(a.data() + 8);
+        Float4 a3 = load(a.data() + 12);
+
+        for (size_t i = 0; i < count; i++) {
+            multiplyColumns(a0, a1, a2, a3, b[i].data(), out[i].data());
+        }
+    }
+
+    void transformAabbs(const Mat4& m, const Aabb* boxes, Aabb* out, size_t count) {
+        Float4 c0 = load(m.data());
+        Float4 c1 = load(m.data() + 4);
+        Float4 c2 = load(m.data() + 8);
+        Float4 c3 = load(m.data() + 12);
+
+        for (size_t i = 0; i < count; i++) {
+            transformBox(c0, c1, c2, c3, boxes[i], out[i]);
+        }
+    }
+
+    void multiply(const float* a, const float* b, float* out) {
+        multiplyColumns(load(a), load(a + 4), load(a + 8), load(a + 12), b, out);
+    }
+
+    unsigned getMathSimdWidth() {
+        return getWidth();
+    }
+}
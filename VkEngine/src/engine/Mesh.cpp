@@ -0,0 +1,43 @@
+#include "engine/Mesh.hpp"
+#include "engine/vk/dispatch.hpp"
+
+namespace vke {
+
+    Mesh::Mesh(Buffer&& vertexBuffer, Buffer&& indexBuffer, VkIndexType indexType, uint32_t indexCount, uint32_t vertexCount) : mVertexBuffer{std::move(vertexBuffer)}, mIndexBuffer{std::move(indexBuffer)}, mIndexType{indexType}, mIndexCount{indexCount}, mVertexCount{vertexCount} {
+    }
+
+    Mesh::Mesh() : mVertexBuffer{}, mIndexBuffer{}, mIndexType{VK_INDEX_TYPE_UINT16}, mIndexCount{0}, mVertexCount{0} {
+    }
+
+    void Mesh::bind(VkCommandBuffer cmdBuffer) {
+        VkDeviceSize offset = 0;
+        vkCmdBindVertexBuffers(cmdBuffer, 0, 1, &mVertexBuffer.getHandle(), &offset);
+        vkCmdBindIndexBuffer(cmdBuffer, mIndexBuffer.getHandle(), 0, mIndexType);
+    }
+
+    void Mesh::draw(VkCommandBuffer cmdBuffer, uint32_t instanceCount) {
+        vkCmdDrawIndexed(cmdBuffer, mIndexCount, instanceCount, 0, 0, 0);
+    }
+
+    DrawCommand Mesh::makeDraw(float depth) {
+        DrawCommand draw{};
+        draw.vertexBuffer = mVertexBuffer.getHandle();
+        draw.indexBuffer = mIndexBuffer.getHandle();
+        draw.indexType = mIndexType;
+        draw.indexCount = mIndexCount;
+        draw.depth = depth;
+        return draw;
+    }
+
+    VkIndexType Mesh::getIndexType() const {
+        return mIndexType;
+    }
+
+    uint32_t Mesh::getIndexCount() const {
+        return mIndexCount;
+    }
+
+    uint32_t Mesh::getVertexCount() const {
+        return mVertexCount;
+    }
+}
@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "engine/MeshFile.hpp"
+
+namespace vke {
+
+    namespace {
+        uint64_t alignUp(uint64_t value, uint64_t alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        EngineError lastOsError() {
+            return EngineError::fromOsError({ errno, std::generic_category() });
+        }
+    }
+
+    MeshFile::MeshFile(const char* data, size_t size) : mData{data}, mSize{size} {
+    }
+
+    MeshFile::MeshFile() : mData{nullptr}, mSize{0} {
+    }
+
+    MeshFile::~MeshFile() {
+        if (mData) {
+            munmap(const_cast<char*>(mData), mSize);
+        }
+    }
+
+    MeshFile::MeshFile(MeshFile&& other) noexcept : mData{std::exchange(other.mData, nullptr)}, mSize{std::exchange(other.mSize, 0)} {
+    }
+
+    MeshFile& MeshFile::operator=(MeshFile&& other) noexcept {
+        if (this != &other) {
+            this->MeshFile::~MeshFile();
+
+            mData = std::exchange(other.mData, nullptr);
+            mSize = std::exchange(other.mSize, 0);
+        }
+
+        return *this;
+    }
+
+    EngineResult<MeshFile> MeshFile::open(const std::filesystem::path& path) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return EngineResult<MeshFile>::error(lastOsError());
+
+        struct stat info{};
+        if (fstat(fd, &info) != 0) {
+            EngineError error = lastOsError();
+            close(fd);
+            return EngineResult<MeshFile>::error(std::move(error));
+        }
+
+        size_t size = static_cast<size_t>(info.st_size);
+        if (size < sizeof(Header)) {
+            close(fd);
+            return EngineResult<MeshFile>::error(EngineError::invalidFile("too small for a mesh header"));
+        }
+
+        void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        // mapping keeps the file referenced on its own
+        close(fd);
+
+        if (mapping == MAP_FAILED)
+            return EngineResult<MeshFile>::error(lastOsError());
+
+        // everything is read front to back exactly once, so let the kernel read ahead aggressively
+        madvise(mapping, size, MADV_SEQUENTIAL);
+        madvise(mapping, size, MADV_WILLNEED);
+
+        MeshFile file(static_cast<const char*>(mapping), size);
+
+        if (const char* problem = validate(mapping, size))
+            return EngineResult<MeshFile>::error(EngineError::invalidFile(problem));
+
+        return file;
+    }
+
+    const char* MeshFile::validate(const void* data, size_t size) {
+        if (size < sizeof(Header))
+            return "too small for a mesh header";
+
+        const Header& header = *static_cast<const Header*>(data);
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+            return "not a mesh file";
+        if (header.version != VERSION)
+            return "unsupported mesh file version";
+        if (header.vertexStride == 0 || (header.indexSize != 2 && header.indexSize != 4))
+            return "invalid vertex or index format";
+        if (header.vertexOffset % STREAM_ALIGNMENT != 0 || header.indexOffset % STREAM_ALIGNMENT != 0)
+            return "misaligned stream";
+        if (header.vertexOffset > size || getVertexBytes(header) > size - header.vertexOffset ||
+            header.indexOffset > size || getIndexBytes(header) > size - header.indexOffset)
+            return "stream extends past end of file";
+
+        return nullptr;
+    }
+
+    EngineResult<void> MeshFile::write(const std::filesystem::path& path, const MeshData& data) {
+        uint32_t vertexCount = data.getVertexCount();
+        bool shortIndices = vertexCount <= UINT16_MAX + 1;
+
+        Header header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.vertexStride = data.vertexStride;
+        header.vertexCount = vertexCount;
+        header.indexCount = static_cast<uint32_t>(data.indices.size());
+        header.indexSize = shortIndices ? sizeof(uint16_t) : sizeof(uint32_t);
+
+        uint64_t vertexBytes = static_cast<uint64_t>(vertexCount) * data.vertexStride * sizeof(float);
+        header.vertexOffset = alignUp(sizeof(Header), STREAM_ALIGNMENT);
+        header.indexOffset = alignUp(header.vertexOffset + vertexBytes, STREAM_ALIGNMENT);
+
+        // sphere around the box center, cheap and good enough for culling
+        float min[3] = { INFINITY, INFINITY, INFINITY };
+        float max[3] = { -INFINITY, -INFINITY, -INFINITY };
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            const float* position = &data.vertices[static_cast<size_t>(v) * data.vertexStride];
+            for (int i = 0; i < 3; i++) {
+                min[i] = std::min(min[i], position[i]);
+                max[i] = std::max(max[i], position[i]);
+            }
+        }
+
+        if (vertexCount > 0 && data.vertexStride >= 3) {
+            for (int i = 0; i < 3; i++) {
+                header.center[i] = (min[i] + max[i]) * 0.5f;
+            }
+
+            for (uint32_t v = 0; v < vertexCount; v++) {
+                const float* position = &data.vertices[static_cast<size_t>(v) * data.vertexStride];
+                float dx = position[0] - header.center[0], dy = position[1] - header.center[1], dz = position[2] - header.center[2];
+                header.radius = std::max(header.radius, std::sqrt(dx * dx + dy * dy + dz * dz));
+            }
+        }
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (file.fail())
+            return EngineResult<void>::error(lastOsError());
+
+        const char padding[STREAM_ALIGNMENT]{};
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(padding, static_cast<std::streamsize>(header.vertexOffset - sizeof(header)));
+        file.write(reinterpret_cast<const char*>(data.vertices.data()), static_cast<std::streamsize>(vertexBytes));
+        file.write(padding, static_cast<std::streamsize>(header.indexOffset - header.vertexOffset - vertexBytes));
+
+        if (shortIndices) {
+            std::vector<uint16_t> indices(data.indices.begin(), data.indices.end());
+            file.write(reinterpret_cast<const char*>(indices.data()), static_cast<std::streamsize>(indices.size() * sizeof(uint16_t)));
+        } else {
+            file.write(reinterpret_cast<const char*>(data.indices.data()), static_cast<std::streamsize>(data.indices.size() * sizeof(uint32_t)));
+        }
+
+        file.close();
+        if (file.fail())
+            return EngineResult<void>::error(lastOsError());
+
+        return {};
+    }
+
+    const MeshFile::Header& MeshFile::getHeader() const {
+        return *reinterpret_cast<const Header*>(mData);
+    }
+
+    const void* MeshFile::getVertices() const {
+        return mData + getHeader().vertexOffset;
+    }
+
+    uint64_t MeshFile::getVertexBytes() const {
+        return getVertexBytes(getHeader());
+    }
+
+    uint64_t MeshFile::getVertexBytes(const Header& header) {
+        return static_cast<uint64_t>(header.vertexCount) * header.vertexStride * sizeof(float);
+    }
+
+    const void* MeshFile::getIndices() const {
+        return mData + getHeader().indexOffset;
+    }
+
+    uint64_t MeshFile::getIndexBytes() const {
+        return getIndexBytes(getHeader());
+    }
+
+    uint64_t MeshFile::getIndexBytes(const Header& header) {
+        return static_cast<uint64_t>(header.indexCount) * header.indexSize;
+    }
+
+    VkIndexType MeshFile::getIndexType() const {
+        return getIndexType(getHeader());
+    }
+
+    VkIndexType MeshFile::getIndexType(const Header& header) {
+        return header.indexSize == sizeof(uint16_t) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+    }
+}
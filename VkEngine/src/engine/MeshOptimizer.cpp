@@ -0,0 +1,339 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include "engine/MeshOptimizer.hpp"
+
+namespace vke {
+
+    namespace {
+        struct VertexHash {
+            const float* vertices;
+            uint32_t stride;
+
+            size_t operator()(uint32_t index) const {
+                const auto* bytes = reinterpret_cast<const unsigned char*>(vertices + static_cast<size_t>(index) * stride);
+                size_t hash = 14695981039346656037ULL;
+
+                // FNV-1a over raw bytes, identical vertices are bitwise identical
+                for (size_t i = 0, size = stride * sizeof(float); i < size; i++) {
+                    hash = (hash ^ bytes[i]) * 1099511628211ULL;
+                }
+
+                return hash;
+            }
+        };
+
+        struct VertexEqual {
+            const float* vertices;
+            uint32_t stride;
+
+            bool operator()(uint32_t a, uint32_t b) const {
+                return std::memcmp(vertices + static_cast<size_t>(a) * stride, vertices + static_cast<size_t>(b) * stride, stride * sizeof(float)) == 0;
+            }
+        };
+
+        struct Cluster {
+            uint32_t firstTriangle;
+            uint32_t triangleCount;
+            float sortKey;
+        };
+
+        int32_t skipDeadEnd(std::vector<uint32_t>& deadEnds, const std::vector<uint32_t>& liveTriangles, uint32_t& cursor, uint32_t vertexCount) {
+            while (!deadEnds.empty()) {
+                uint32_t vertex = deadEnds.back();
+                deadEnds.pop_back();
+
+                if (liveTriangles[vertex] > 0)
+                    return static_cast<int32_t>(vertex);
+            }
+
+            while (cursor < vertexCount) {
+                if (liveTriangles[cursor] > 0)
+                    return static_cast<int32_t>(cursor);
+
+                cursor++;
+            }
+
+            return -1;
+        }
+
+        void sortClusters(MeshData& mesh, std::vector<Cluster>& clusters) {
+            const std::vector<uint32_t>& indices = mesh.indices;
+            const float* vertices = mesh.vertices.data();
+            uint32_t stride = mesh.vertexStride;
+
+            float meshCentroid[3] = { 0.0f, 0.0f, 0.0f };
+            float meshArea = 0.0f;
+
+            std::vector<float> clusterData(clusters.size() * 7, 0.0f);
+
+            for (size_t c = 0; c < clusters.size(); c++) {
+                float* data = &clusterData[c * 7];
+
+                for (uint32_t t = clusters[c].firstTriangle, end = t + clusters[c].triangleCount; t < end; t++) {
+                    const float* a = vertices + static_cast<size_t>(indices[t * 3 + 0]) * stride;
+                    const float* b = vertices + static_cast<size_t>(indices[t * 3 + 1]) * stride;
+                    const float* d = vertices + static_cast<size_t>(indices[t * 3 + 2]) * stride;
+
+                    float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+                    float e2[3] = { d[0] - a[0], d[1] - a[1], d[2] - a[2] };
+                    float normal[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+                    float area = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]) * 0.5f;
+
+                    for (int i = 0; i < 3; i++) {
+                        float centroid = (a[i] + b[i] + d[i]) / 3.0f;
+                        data[i] += centroid * area;
+                        data[3 + i] += normal[i];
+                        meshCentroid[i] += centroid * area;
+                    }
+
+                    data[6] += area;
+                    meshArea += area;
+                }
+            }
+
+            if (meshArea > 0.0f) {
+                for (float& value : meshCentroid) {
+                    value /= meshArea;
+                }
+            }
+
+            for (size_t c = 0; c < clusters.size(); c++) {
+                float* data = &clusterData[c * 7];
+                float area = data[6] > 0.0f ? data[6] : 1.0f;
+                float normalLength = std::sqrt(data[3] * data[3] + data[4] * data[4] + data[5] * data[5]);
+                if (normalLength == 0.0f) normalLength = 1.0f;
+
+                // clusters far out along their own normal are likely to occlude the rest of the mesh
+                float key = 0.0f;
+                for (int i = 0; i < 3; i++) {
+                    key += (data[i] / area - meshCentroid[i]) * (data[3 + i] / normalLength);
+                }
+
+                clusters[c].sortKey = key;
+            }
+
+            std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) {
+                return a.sortKey > b.sortKey;
+            });
+
+            std::vector<uint32_t> sorted;
+            sorted.reserve(indices.size());
+            for (const Cluster& cluster : clusters) {
+                auto begin = indices.begin() + cluster.firstTriangle * 3;
+                sorted.insert(sorted.end(), begin, begin + cluster.triangleCount * 3);
+            }
+
+            mesh.indices = std::move(sorted);
+        }
+    }
+
+    std::ostream& operator<<(std::ostream& stream, const MeshOptimizer::Stats& stats) {
+        stream << "[MeshStats] triangles: " << stats.triangles
+               << ", vertices: " << stats.verticesBefore << " -> " << stats.verticesAfter
+               << ", ACMR: " << stats.acmrBefore << " -> " << stats.acmrAfter;
+        return stream;
+    }
+
+    MeshOptimizer::Stats MeshOptimizer::optimize(MeshData& mesh, uint32_t cacheSize) {
+        Stats stats{};
+        stats.verticesBefore = mesh.getVertexCount();
+
+        deduplicateVertices(mesh);
+
+        // before dedup there is no index buffer to measure, so measure the deduplicated but unordered mesh
+        stats.acmrBefore = computeAcmr(mesh, cacheSize);
+
+        optimizeVertexCache(mesh, cacheSize);
+        optimizeVertexFetch(mesh);
+
+        stats.verticesAfter = mesh.getVertexCount();
+        stats.triangles = mesh.indices.size() / 3;
+        stats.acmrAfter = computeAcmr(mesh, cacheSize);
+
+        return stats;
+    }
+
+    void MeshOptimizer::deduplicateVertices(MeshData& mesh) {
+        uint32_t vertexCount = mesh.getVertexCount();
+        uint32_t stride = mesh.vertexStride;
+
+        if (mesh.indices.empty()) {
+            mesh.indices.resize(vertexCount);
+            for (uint32_t i = 0; i < vertexCount; i++) {
+                mesh.indices[i] = i;
+            }
+        }
+
+        std::unordered_map<uint32_t, uint32_t, VertexHash, VertexEqual> unique(vertexCount, VertexHash{mesh.vertices.data(), stride}, VertexEqual{mesh.vertices.data(), stride});
+        std::vector<uint32_t> remap(vertexCount);
+        uint32_t uniqueCount = 0;
+
+        for (uint32_t i = 0; i < vertexCount; i++) {
+            auto [it, inserted] = unique.emplace(i, uniqueCount);
+            remap[i] = it->second;
+
+            if (inserted)
+                uniqueCount++;
+        }
+
+        std::vector<float> vertices(static_cast<size_t>(uniqueCount) * stride);
+        for (uint32_t i = 0; i < vertexCount; i++) {
+            std::memcpy(&vertices[static_cast<size_t>(remap[i]) * stride], &mesh.vertices[static_cast<size_t>(i) * stride], stride * sizeof(float));
+        }
+
+        for (uint32_t& index : mesh.indices) {
+            index = remap[index];
+        }
+
+        mesh.vertices = std::move(vertices);
+    }
+
+    void MeshOptimizer::optimizeVertexCache(MeshData& mesh, uint32_t cacheSize) {
+        uint32_t vertexCount = mesh.getVertexCount();
+        uint32_t triangleCount = mesh.indices.size() / 3;
+        const std::vector<uint32_t>& indices = mesh.indices;
+
+        if (triangleCount == 0)
+            return;
+
+        // vertex -> triangle adjacency in CSR form
+        std::vector<uint32_t> liveTriangles(vertexCount, 0);
+        for (uint32_t index : indices) {
+            liveTriangles[index]++;
+        }
+
+        std::vector<uint32_t> offsets(vertexCount + 1, 0);
+        for (uint32_t v = 0; v < vertexCount; v++) {
+            offsets[v + 1] = offsets[v] + liveTriangles[v];
+        }
+
+        std::vector<uint32_t> adjacency(offsets[vertexCount]);
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (uint32_t t = 0; t < triangleCount; t++) {
+            for (uint32_t k = 0; k < 3; k++) {
+                adjacency[fill[indices[t * 3 + k]]++] = t;
+            }
+        }
+
+        std::vector<uint32_t> cacheTime(vertexCount, 0);
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<uint32_t> deadEnds;
+        std::vector<uint32_t> candidates;
+        std::vector<uint32_t> output;
+        output.reserve(indices.size());
+        std::vector<Cluster> clusters;
+
+        uint32_t time = cacheSize + 1;
+        uint32_t cursor = 0;
+        int32_t fanning = 0;
+
+        clusters.push_back({ 0, 0, 0.0f });
+
+        while (fanning >= 0) {
+            candidates.clear();
+
+            for (uint32_t i = offsets[fanning], end = offsets[fanning + 1]; i < end; i++) {
+                uint32_t t = adjacency[i];
+                if (emitted[t])
+                    continue;
+
+                for (uint32_t k = 0; k < 3; k++) {
+                    uint32_t v = indices[t * 3 + k];
+                    output.push_back(v);
+                    deadEnds.push_back(v);
+                    candidates.push_back(v);
+                    liveTriangles[v]--;
+
+                    if (time - cacheTime[v] > cacheSize) {
+                        cacheTime[v] = time++;
+                    }
+                }
+
+                emitted[t] = true;
+            }
+
+            // prefer the candidate that is still in cache and will stay there while its fan is emitted
+            int32_t next = -1;
+            int32_t bestPriority = -1;
+            for (uint32_t v : candidates) {
+                if (liveTriangles[v] == 0)
+                    continue;
+
+                int32_t priority = 0;
+                if (time - cacheTime[v] + 2 * liveTriangles[v] <= cacheSize) {
+                    priority = static_cast<int32_t>(time - cacheTime[v]);
+                }
+
+                if (priority > bestPriority) {
+                    bestPriority = priority;
+                    next = static_cast<int32_t>(v);
+                }
+            }
+
+            if (next == -1) {
+                next = skipDeadEnd(deadEnds, liveTriangles, cursor, vertexCount);
+
+                // non-local jump, cache is effectively cold, so start a new cluster for overdraw sorting
+                uint32_t emittedTriangles = output.size() / 3;
+                if (next >= 0 && emittedTriangles > clusters.back().firstTriangle) {
+                    clusters.back().triangleCount = emittedTriangles - clusters.back().firstTriangle;
+                    clusters.push_back({ emittedTriangles, 0, 0.0f });
+                }
+            }
+
+            fanning = next;
+        }
+
+        clusters.back().triangleCount = output.size() / 3 - clusters.back().firstTriangle;
+
+        mesh.indices = std::move(output);
+
+        if (mesh.vertexStride >= 3 && clusters.size() > 1) {
+            sortClusters(mesh, clusters);
+        }
+    }
+
+    void MeshOptimizer::optimizeVertexFetch(MeshData& mesh) {
+        uint32_t vertexCount = mesh.getVertexCount();
+        uint32_t stride = mesh.vertexStride;
+
+        constexpr uint32_t UNUSED = ~0u;
+        std::vector<uint32_t> remap(vertexCount, UNUSED);
+        std::vector<float> vertices;
+        vertices.reserve(mesh.vertices.size());
+        uint32_t next = 0;
+
+        for (uint32_t& index : mesh.indices) {
+            if (remap[index] == UNUSED) {
+                remap[index] = next++;
+                auto begin = mesh.vertices.begin() + static_cast<size_t>(index) * stride;
+                vertices.insert(vertices.end(), begin, begin + stride);
+            }
+
+            index = remap[index];
+        }
+
+        mesh.vertices = std::move(vertices);
+    }
+
+    float MeshOptimizer::computeAcmr(const MeshData& mesh, uint32_t cacheSize) {
+        uint32_t triangleCount = mesh.indices.size() / 3;
+        if (triangleCount == 0)
+            return 0.0f;
+
+        // FIFO cache: vertex is resident if fewer than cacheSize misses happened since it was loaded
+        std::vector<uint32_t> loadTime(mesh.getVertexCount(), 0);
+        uint32_t misses = 0;
+
+        for (uint32_t index : mesh.indices) {
+            if (loadTime[index] == 0 || misses + 1 - loadTime[index] > cacheSize) {
+                misses++;
+                loadTime[index] = misses;
+            }
+        }
+
+        return static_cast<float>(misses) / static_cast<float>(triangleCount);
+    }
+}
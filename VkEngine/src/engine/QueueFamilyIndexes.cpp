@@ -1,5 +1,6 @@
 #include <vector>
 #include "engine/QueueFamilyIndexes.hpp"
+#include "engine/vk/dispatch.hpp"
 
 namespace vke {
 
@@ -14,6 +15,7 @@ namespace vke {
         uint32_t graphicsIndex;
         uint32_t computeIndex;
         uint32_t presentIndex;
+        uint32_t asyncComputeIndex;
         uint32_t flags = 0;
         for (size_t i = 0, size = families.size(); i < size; i++) {
             VkQueueFamilyProperties family = families[i];
@@ -28,6 +30,11 @@ namespace vke {
                 flags |= QueueFamilyIndexes::COMPUTE;
             }
 
+            if (family.queueFlags & VK_QUEUE_COMPUTE_BIT && !(family.queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
+                asyncComputeIndex = i;
+                flags |= QueueFamilyIndexes::ASYNC_COMPUTE;
+            }
+
             VkBool32 surfaceSupported;
             vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &surfaceSupported);
             if (surfaceSupported) {
@@ -36,7 +43,7 @@ namespace vke {
             }
         }
 
-        return QueueFamilyIndexes{ flags, graphicsIndex, computeIndex, presentIndex };
+        return QueueFamilyIndexes{ flags, graphicsIndex, computeIndex, presentIndex, asyncComputeIndex };
     }
 
     bool QueueFamilyIndexes::isComplete() const {
@@ -59,6 +66,10 @@ namespace vke {
         return hasIndex(PRESENT);
     }
 
+    bool QueueFamilyIndexes::hasAsyncCompute() const {
+        return hasIndex(ASYNC_COMPUTE);
+    }
+
     uint32_t QueueFamilyIndexes::getIndex(Index index) const {
         switch (index) {
             case GRAPHICS:
@@ -67,6 +78,8 @@ namespace vke {
                 return getCompute();
             case PRESENT:
                 return getPresent();
+            case ASYNC_COMPUTE:
+                return getAsyncCompute();
         }
     }
 
@@ -82,7 +95,11 @@ namespace vke {
         return mComputeIndex;
     }
 
-    QueueFamilyIndexes::QueueFamilyIndexes(uint32_t flags, uint32_t graphics, uint32_t compute, uint32_t present) : mFlags{flags}, mGraphicsIndex{graphics}, mComputeIndex{compute}, mPresentIndex{present}  {
+    uint32_t QueueFamilyIndexes::getAsyncCompute() const {
+        return mAsyncComputeIndex;
+    }
+
+    QueueFamilyIndexes::QueueFamilyIndexes(uint32_t flags, uint32_t graphics, uint32_t compute, uint32_t present, uint32_t asyncCompute) : mFlags{flags}, mGraphicsIndex{graphics}, mComputeIndex{compute}, mPresentIndex{present}, mAsyncComputeIndex{asyncCompute}  {
     }
 
 }
\ No newline at end of file
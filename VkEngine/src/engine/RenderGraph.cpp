@@ -0,0 +1,575 @@
+#include <algorithm>
+#include <bit>
+#include "engine/RenderGraph.hpp"
+#include "engine/vk/dispatch.hpp"
+
+namespace vke {
+
+    namespace {
+        constexpr VkAccessFlags2 WRITE_ACCESSES = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT
+                                                | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_SHADER_WRITE_BIT
+                                                | VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT;
+
+        constexpr VkPipelineStageFlags2 SHADER_STAGES = VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+
+        // What a resource is waiting on while the graph is walked: last write, reads since then,
+        // and which stages and accesses the last write was already made visible to
+        struct Tracked {
+            VkImageLayout layout;
+            VkPipelineStageFlags2 writeStage;
+            VkAccessFlags2 writeAccess;
+            VkPipelineStageFlags2 readStages;
+            VkPipelineStageFlags2 visibleStages;
+            VkAccessFlags2 visibleAccess;
+        };
+
+        bool overlaps(uint32_t firstA, uint32_t lastA, uint32_t firstB, uint32_t lastB) {
+            return firstA <= lastB && firstB <= lastA;
+        }
+    }
+
+    std::ostream& operator<<(std::ostream& stream, const RenderGraph::Stats& stats) {
+        stream << "[RenderGraph] passes: " << stats.passes << " (" << stats.culledPasses << " culled)"
+               << ", barrier batches: " << stats.barrierBatches
+               << ", image barriers: " << stats.imageBarriers
+               << ", buffer barriers: " << stats.bufferBarriers
+               << ", transient memory: " << stats.transientBytes << " -> " << stats.allocatedBytes << " bytes";
+        return stream;
+    }
+
+    RenderGraph::PassBuilder::PassBuilder(RenderGraph& graph, uint32_t pass) : mGraph{graph}, mPass{pass} {
+    }
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::read(Resource resource, Access access) {
+        mGraph.addUsage(mPass, resource, access, false);
+        return *this;
+    }
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::write(Resource resource, Access access) {
+        mGraph.addUsage(mPass, resource, access, true);
+        return *this;
+    }
+
+    RenderGraph::PassBuilder& RenderGraph::PassBuilder::sideEffect() {
+        mGraph.mPasses[mPass].sideEffect = true;
+        return *this;
+    }
+
+    RenderGraph::RenderGraph() : mDevice{VK_NULL_HANDLE}, mMemoryType{}, mResources{}, mPasses{}, mBatches{}, mSlots{}, mImageBarriers{}, mBufferBarriers{}, mStats{}, mCompiled{false} {
+    }
+
+    void RenderGraph::init(VkDevice device, MemoryType memoryType) {
+        mDevice = device;
+        mMemoryType = memoryType;
+    }
+
+    void RenderGraph::cleanup() {
+        if (mDevice == VK_NULL_HANDLE)
+            return;
+
+        reset();
+        mDevice = VK_NULL_HANDLE;
+    }
+
+    void RenderGraph::reset() {
+        destroyTransients();
+
+        mResources.clear();
+        mPasses.clear();
+        mBatches.clear();
+        mStats = {};
+        mCompiled = false;
+    }
+
+    void RenderGraph::destroyTransients() {
+        for (ResourceInfo& resource : mResources) {
+            if (resource.imported || !resource.isImage)
+                continue;
+
+            vkDestroyImageView(mDevice, resource.view, nullptr);
+            vkDestroyImage(mDevice, resource.image, nullptr);
+            resource.view = VK_NULL_HANDLE;
+            resource.image = VK_NULL_HANDLE;
+        }
+
+        for (MemorySlot& slot : mSlots) {
+            vkFreeMemory(mDevice, slot.memory, nullptr);
+        }
+        mSlots.clear();
+    }
+
+    RenderGraph::Resource RenderGraph::createImage(std::string name, const ImageDescription& description) {
+        ResourceInfo info{};
+        info.name = std::move(name);
+        info.isImage = true;
+        info.imported = false;
+        info.description = description;
+        info.initial = { VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, VK_IMAGE_LAYOUT_UNDEFINED };
+        info.finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        mResources.push_back(std::move(info));
+        return static_cast<Resource>(mResources.size() - 1);
+    }
+
+    RenderGraph::Resource RenderGraph::importImage(std::string name, VkImageAspectFlags aspect, State initial, VkImageLayout finalLayout) {
+        ResourceInfo info{};
+        info.name = std::move(name);
+        info.isImage = true;
+        info.imported = true;
+        info.description.aspect = aspect;
+        info.initial = initial;
+        info.finalLayout = finalLayout;
+
+        mResources.push_back(std::move(info));
+        return static_cast<Resource>(mResources.size() - 1);
+    }
+
+    RenderGraph::Resource RenderGraph::importBuffer(std::string name, State initial) {
+        ResourceInfo info{};
+        info.name = std::move(name);
+        info.isImage = false;
+        info.imported = true;
+        info.initial = initial;
+        info.finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        mResources.push_back(std::move(info));
+        return static_cast<Resource>(mResources.size() - 1);
+    }
+
+    void RenderGraph::setImage(Resource resource, VkImage image, VkImageView view) {
+        mResources[resource].image = image;
+        mResources[resource].view = view;
+    }
+
+    void RenderGraph::setBuffer(Resource resource, VkBuffer buffer) {
+        mResources[resource].buffer = buffer;
+    }
+
+    RenderGraph::PassBuilder RenderGraph::addPass(std::string name, Execute execute) {
+        mPasses.push_back({ std::move(name), {}, std::move(execute), false, false });
+        return PassBuilder{*this, static_cast<uint32_t>(mPasses.size() - 1)};
+    }
+
+    RenderGraph::State RenderGraph::getState(Access access, bool write, bool image) {
+        State state{};
+
+        switch (access) {
+            case Access::COLOR_ATTACHMENT:
+                state.stage = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+                state.access = write ? VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT : VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT;
+                state.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+                break;
+            case Access::DEPTH_ATTACHMENT:
+                state.stage = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+                state.access = write ? VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT : VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+                state.layout = write ? VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL;
+                break;
+            case Access::SAMPLED:
+                state.stage = SHADER_STAGES;
+                state.access = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
+                state.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+                break;
+            case Access::STORAGE:
+                state.stage = SHADER_STAGES;
+                state.access = write ? VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_SHADER_STORAGE_READ_BIT : VK_ACCESS_2_SHADER_STORAGE_READ_BIT;
+                state.layout = VK_IMAGE_LAYOUT_GENERAL;
+                break;
+            case Access::TRANSFER:
+                state.stage = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+                state.access = write ? VK_ACCESS_2_TRANSFER_WRITE_BIT : VK_ACCESS_2_TRANSFER_READ_BIT;
+                state.layout = write ? VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL : VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+                break;
+            case Access::INDIRECT:
+                state.stage = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT;
+                state.access = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT;
+                break;
+            case Access::VERTEX:
+                state.stage = VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT;
+                state.access = VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_2_INDEX_READ_BIT;
+                break;
+            case Access::UNIFORM:
+                state.stage = SHADER_STAGES;
+                state.access = VK_ACCESS_2_UNIFORM_READ_BIT;
+                break;
+        }
+
+        if (!image) {
+            state.layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        }
+
+        return state;
+    }
+
+    void RenderGraph::addUsage(uint32_t pass, Resource resource, Access access, bool write) {
+        State state = getState(access, write, mResources[resource].isImage);
+        std::vector<Usage>& usages = mPasses[pass].usages;
+
+        // a resource appears once per pass, reads and writes of it are merged and the written layout wins
+        for (Usage& usage : usages) {
+            if (usage.resource != resource)
+                continue;
+
+            usage.state.stage |= state.stage;
+            usage.state.access |= state.access;
+            if (write) {
+                usage.state.layout = state.layout;
+            }
+            usage.read = usage.read || !write;
+            usage.write = usage.write || write;
+            return;
+        }
+
+        usages.push_back({ resource, state, !write, write });
+    }
+
+    void RenderGraph::cullPasses() {
+        // walk backwards, a pass survives when a later surviving pass reads something it writes,
+        // when it writes an imported resource (visible outside of the graph) or when it asked to
+        std::vector<bool> consumed(mResources.size(), false);
+
+        for (size_t i = mPasses.size(); i-- > 0;) {
+            Pass& pass = mPasses[i];
+
+            bool needed = pass.sideEffect;
+            for (const Usage& usage : pass.usages) {
+                if (usage.write && (mResources[usage.resource].imported || consumed[usage.resource])) {
+                    needed = true;
+                }
+            }
+
+            pass.culled = !needed;
+            if (!needed)
+                continue;
+
+            // whatever was written before this pass overwrote it is dead, unless this pass reads it too
+            for (const Usage& usage : pass.usages) {
+                consumed[usage.resource] = usage.read || (consumed[usage.resource] && !usage.write);
+            }
+        }
+    }
+
+    void RenderGraph::computeBarriers(std::vector<State>& finalStates) {
+        std::vector<Tracked> tracked(mResources.size());
+        for (size_t i = 0; i < mResources.size(); i++) {
+            const State& initial = mResources[i].initial;
+            tracked[i] = { initial.layout, initial.stage, initial.access & WRITE_ACCESSES, 0, 0, 0 };
+        }
+
+        mBatches.assign(mPasses.size() + 1, {});
+
+        for (size_t p = 0; p < mPasses.size(); p++) {
+            if (mPasses[p].culled)
+                continue;
+
+            for (const Usage& usage : mPasses[p].usages) {
+                Tracked& current = tracked[usage.resource];
+                const State& required = usage.state;
+                bool layoutChange = mResources[usage.resource].isImage && required.layout != current.layout;
+
+                if (layoutChange || usage.write) {
+                    // layout transitions and writes wait for everything before them, only writes need to be made visible
+                    VkPipelineStageFlags2 srcStage = current.writeStage | current.readStages;
+                    if (layoutChange || srcStage != 0) {
+                        mBatches[p].push_back({ usage.resource, { srcStage, current.writeAccess, current.layout }, required });
+                    }
+
+                    current.layout = required.layout;
+                    current.writeStage = required.stage;
+                    current.writeAccess = usage.write ? required.access & WRITE_ACCESSES : VK_ACCESS_2_NONE;
+                    // transition itself is visible to the stages of this barrier
+                    current.readStages = usage.write ? 0 : required.stage;
+                    current.visibleStages = usage.write ? 0 : required.stage;
+                    current.visibleAccess = usage.write ? 0 : required.access;
+                    continue;
+                }
+
+                // read after read of the same layout needs nothing, read after write only when not yet visible
+                bool visible = (required.stage & ~current.visibleStages) == 0 && (required.access & ~current.visibleAccess) == 0;
+                if (current.writeStage != 0 && !visible) {
+                    mBatches[p].push_back({ usage.resource, { current.writeStage, current.writeAccess, current.layout }, required });
+                    current.visibleStages |= required.stage;
+                    current.visibleAccess |= required.access;
+                }
+
+                current.readStages |= required.stage;
+            }
+        }
+
+        // hand imported images over in the layout the outside world expects
+        std::vector<Barrier>& last = mBatches.back();
+        for (size_t i = 0; i < mResources.size(); i++) {
+            const ResourceInfo& resource = mResources[i];
+            Tracked& current = tracked[i];
+
+            if (resource.imported && resource.isImage && resource.finalLayout != VK_IMAGE_LAYOUT_UNDEFINED && resource.finalLayout != current.layout) {
+                last.push_back({ static_cast<Resource>(i), { current.writeStage | current.readStages, current.writeAccess, current.layout }, { VK_PIPELINE_STAGE_2_BOTTOM_OF_PIPE_BIT, VK_ACCESS_2_NONE, resource.finalLayout } });
+            }
+
+            finalStates[i] = { current.writeStage | current.readStages, current.writeAccess, current.layout };
+        }
+    }
+
+    EngineResult<void> RenderGraph::allocateTransients(const std::vector<State>& finalStates) {
+        struct Transient {
+            Resource resource;
+            VkMemoryRequirements requirements;
+        };
+
+        std::vector<Transient> transients;
+
+        for (size_t i = 0; i < mResources.size(); i++) {
+            ResourceInfo& resource = mResources[i];
+            // culled away or never used
+            if (resource.imported || !resource.isImage || resource.firstPass == UINT32_MAX)
+                continue;
+
+            VkImageCreateInfo createInfo{};
+            createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+            createInfo.imageType = VK_IMAGE_TYPE_2D;
+            createInfo.format = resource.description.format;
+            createInfo.extent.width = resource.description.extent.width;
+            createInfo.extent.height = resource.description.extent.height;
+            createInfo.extent.depth = 1;
+            createInfo.mipLevels = 1;
+            createInfo.arrayLayers = 1;
+            createInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+            createInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+            createInfo.usage = resource.description.usage;
+            createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            createInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+            if (VkResult result = vkCreateImage(mDevice, &createInfo, nullptr, &resource.image)) {
+                return EngineError::fromVkError(result);
+            }
+
+            VkMemoryRequirements requirements;
+            vkGetImageMemoryRequirements(mDevice, resource.image, &requirements);
+            transients.push_back({ static_cast<Resource>(i), requirements });
+            mStats.transientBytes += requirements.size;
+        }
+
+        // largest first, so a slot's first occupant decides its size and later ones only have to fit
+        std::stable_sort(transients.begin(), transients.end(), [](const Transient& a, const Transient& b) {
+            return a.requirements.size > b.requirements.size;
+        });
+
+        for (const Transient& transient : transients) {
+            const ResourceInfo& resource = mResources[transient.resource];
+            MemorySlot* target = nullptr;
+
+            for (MemorySlot& slot : mSlots) {
+                if (slot.size < transient.requirements.size || (slot.typeBits & transient.requirements.memoryTypeBits) == 0)
+                    continue;
+
+                bool free = std::none_of(slot.occupants.begin(), slot.occupants.end(), [&](Resource occupant) {
+                    return overlaps(mResources[occupant].firstPass, mResources[occupant].lastPass, resource.firstPass, resource.lastPass);
+                });
+
+                if (free) {
+                    target = &slot;
+                    break;
+                }
+            }
+
+            if (target == nullptr) {
+                mSlots.push_back({ VK_NULL_HANDLE, transient.requirements.size, transient.requirements.memoryTypeBits, {} });
+                target = &mSlots.back();
+            }
+
+            target->typeBits &= transient.requirements.memoryTypeBits;
+            target->occupants.push_back(transient.resource);
+        }
+
+        for (MemorySlot& slot : mSlots) {
+            VkMemoryAllocateInfo allocateInfo{};
+            allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+            allocateInfo.allocationSize = slot.size;
+            if (mMemoryType.isValid() && (slot.typeBits >> mMemoryType.getTypeIndex()) & 1) {
+                allocateInfo.memoryTypeIndex = mMemoryType.getTypeIndex();
+            } else {
+                // fall back to lowest type all occupants accept
+                allocateInfo.memoryTypeIndex = std::countr_zero(slot.typeBits);
+            }
+
+            if (VkResult result = vkAllocateMemory(mDevice, &allocateInfo, nullptr, &slot.memory)) {
+                return EngineError::fromVkError(result);
+            }
+
+            mStats.allocatedBytes += slot.size;
+
+            std::sort(slot.occupants.begin(), slot.occupants.end(), [this](Resource a, Resource b) {
+                return mResources[a].firstPass < mResources[b].firstPass;
+            });
+
+            for (size_t i = 0; i < slot.occupants.size(); i++) {
+                ResourceInfo& resource = mResources[slot.occupants[i]];
+
+                if (VkResult result = vkBindImageMemory(mDevice, resource.image, slot.memory, 0)) {
+                    return EngineError::fromVkError(result);
+                }
+
+                VkImageViewCreateInfo viewCreateInfo{};
+                viewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+                viewCreateInfo.image = resource.image;
+                viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+                viewCreateInfo.format = resource.description.format;
+                viewCreateInfo.subresourceRange.aspectMask = resource.description.aspect;
+                viewCreateInfo.subresourceRange.baseMipLevel = 0;
+                viewCreateInfo.subresourceRange.levelCount = 1;
+                viewCreateInfo.subresourceRange.baseArrayLayer = 0;
+                viewCreateInfo.subresourceRange.layerCount = 1;
+
+                if (VkResult result = vkCreateImageView(mDevice, &viewCreateInfo, nullptr, &resource.view)) {
+                    return EngineError::fromVkError(result);
+                }
+
+                // first use has to wait for whoever had the memory before, for the first occupant that is
+                // the last one of the previous frame, which may still be in flight
+                const State& previous = finalStates[slot.occupants[(i + slot.occupants.size() - 1) % slot.occupants.size()]];
+                for (Barrier& barrier : mBatches[resource.firstPass]) {
+                    if (barrier.resource == slot.occupants[i]) {
+                        barrier.src = { previous.stage, previous.access, VK_IMAGE_LAYOUT_UNDEFINED };
+                        break;
+                    }
+                }
+            }
+        }
+
+        return {};
+    }
+
+    EngineResult<void> RenderGraph::compile() {
+        destroyTransients();
+        mStats = {};
+
+        cullPasses();
+
+        for (ResourceInfo& resource : mResources) {
+            resource.firstPass = UINT32_MAX;
+            resource.lastPass = 0;
+        }
+
+        for (uint32_t p = 0; p < mPasses.size(); p++) {
+            if (mPasses[p].culled) {
+                mStats.culledPasses++;
+                continue;
+            }
+
+            mStats.passes++;
+            for (const Usage& usage : mPasses[p].usages) {
+                ResourceInfo& resource = mResources[usage.resource];
+                resource.firstPass = std::min(resource.firstPass, p);
+                resource.lastPass = std::max(resource.lastPass, p);
+            }
+        }
+
+        std::vector<State> finalStates(mResources.size());
+        computeBarriers(finalStates);
+        TRY(allocateTransients(finalStates));
+
+        for (const std::vector<Barrier>& batch : mBatches) {
+            if (!batch.empty()) {
+                mStats.barrierBatches++;
+            }
+
+            for (const Barrier& barrier : batch) {
+                if (mResources[barrier.resource].isImage) {
+                    mStats.imageBarriers++;
+                } else {
+                    mStats.bufferBarriers++;
+                }
+            }
+        }
+
+        mCompiled = true;
+
+        return {};
+    }
+
+    void RenderGraph::recordBarriers(VkCommandBuffer cmdBuffer, const std::vector<Barrier>& batch) {
+        if (batch.empty())
+            return;
+
+        mImageBarriers.clear();
+        mBufferBarriers.clear();
+
+        for (const Barrier& barrier : batch) {
+            const ResourceInfo& resource = mResources[barrier.resource];
+
+            if (resource.isImage) {
+                VkImageMemoryBarrier2 imageBarrier{};
+                imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+                imageBarrier.srcStageMask = barrier.src.stage;
+                imageBarrier.srcAccessMask = barrier.src.access;
+                imageBarrier.dstStageMask = barrier.dst.stage;
+                imageBarrier.dstAccessMask = barrier.dst.access;
+                imageBarrier.oldLayout = barrier.src.layout;
+                imageBarrier.newLayout = barrier.dst.layout;
+                imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                imageBarrier.image = resource.image;
+                imageBarrier.subresourceRange.aspectMask = resource.description.aspect;
+                imageBarrier.subresourceRange.baseMipLevel = 0;
+                imageBarrier.subresourceRange.levelCount = 1;
+                imageBarrier.subresourceRange.baseArrayLayer = 0;
+                imageBarrier.subresourceRange.layerCount = 1;
+                mImageBarriers.push_back(imageBarrier);
+            } else {
+                VkBufferMemoryBarrier2 bufferBarrier{};
+                bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+                bufferBarrier.srcStageMask = barrier.src.stage;
+                bufferBarrier.srcAccessMask = barrier.src.access;
+                bufferBarrier.dstStageMask = barrier.dst.stage;
+                bufferBarrier.dstAccessMask = barrier.dst.access;
+                bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+                bufferBarrier.buffer = resource.buffer;
+                bufferBarrier.offset = 0;
+                bufferBarrier.size = VK_WHOLE_SIZE;
+                mBufferBarriers.push_back(bufferBarrier);
+            }
+        }
+
+        VkDependencyInfo dependencyInfo{};
+        dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(mImageBarriers.size());
+        dependencyInfo.pImageMemoryBarriers = mImageBarriers.data();
+        dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(mBufferBarriers.size());
+        dependencyInfo.pBufferMemoryBarriers = mBufferBarriers.data();
+        vkCmdPipelineBarrier2(cmdBuffer, &dependencyInfo);
+    }
+
+    EngineResult<void> RenderGraph::execute(VkCommandBuffer cmdBuffer) {
+        for (size_t p = 0; p < mPasses.size(); p++) {
+            if (mPasses[p].culled)
+                continue;
+
+            recordBarriers(cmdBuffer, mBatches[p]);
+            TRY(mPasses[p].execute(cmdBuffer));
+        }
+
+        recordBarriers(cmdBuffer, mBatches.back());
+
+        return {};
+    }
+
+    VkImage RenderGraph::getImage(Resource resource) const {
+        return mResources[resource].image;
+    }
+
+    VkImageView RenderGraph::getImageView(Resource resource) const {
+        return mResources[resource].view;
+    }
+
+    VkBuffer RenderGraph::getBuffer(Resource resource) const {
+        return mResources[resource].buffer;
+    }
+
+    bool RenderGraph::isCompiled() const {
+        return mCompiled;
+    }
+
+    const RenderGraph::Stats& RenderGraph::getStats() const {
+        return mStats;
+    }
+}
@@ -0,0 +1,51 @@
+#include <algorithm>
+#include <cmath>
+#include "engine/RenderSystem.hpp"
+
+namespace vke {
+
+    RenderSystem::RenderSystem() : mCuller{}, mMeshes{}, mWorlds{}, mVisible{} {
+    }
+
+    FrustumCuller& RenderSystem::getCuller() {
+        return mCuller;
+    }
+
+    size_t RenderSystem::gather(EntityStore& store, const TransformHierarchy& hierarchy, const Frustum& frustum, InstanceBatcher& batcher) {
+        mCuller.clear();
+        mMeshes.clear();
+        mWorlds.clear();
+
+        store.forEachChunk<Renderable, Transform, Bounds>([&](uint32_t count, const Entity*, Renderable* renderables, Transform* transforms, Bounds* bounds) {
+            for (uint32_t i = 0; i < count; i++) {
+                // column major, translation in last column
+                const float* m = hierarchy.getWorld(transforms[i].node);
+                const float* c = bounds[i].center;
+
+                float center[3];
+                for (int k = 0; k < 3; k++) {
+                    center[k] = m[k] * c[0] + m[4 + k] * c[1] + m[8 + k] * c[2] + m[12 + k];
+                }
+
+                // largest axis scale keeps the sphere conservative under non uniform scaling
+                float scale = 0.0f;
+                for (int column = 0; column < 3; column++) {
+                    const float* axis = m + column * 4;
+                    scale = std::max(scale, axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+                }
+
+                mCuller.addSphere(center, bounds[i].radius * std::sqrt(scale));
+                mMeshes.push_back(renderables[i].mesh);
+                mWorlds.push_back(m);
+            }
+        });
+
+        mCuller.cullSpheres(frustum, mVisible);
+
+        for (uint32_t index : mVisible) {
+            batcher.add(*mMeshes[index], mWorlds[index], TransformHierarchy::MATRIX_SIZE);
+        }
+
+        return mVisible.size();
+    }
+}
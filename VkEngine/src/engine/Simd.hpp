@@ -0,0 +1,97 @@
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include <cmath>
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define VKE_SIMD_SSE
+#define VKE_SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#define VKE_SIMD_SSE
+#endif
+
+// Thin wrappers over the vector registers the engine targets, so math kernels are written once for SSE and the
+// scalar fallback. Float8 only exists in AVX2 builds, kernels using it need their own Float4 path.
+namespace vke::simd {
+
+#if defined(VKE_SIMD_SSE)
+    struct Float4 {
+        __m128 v;
+    };
+
+    inline Float4 load(const float* data) { return { _mm_loadu_ps(data) }; }
+    inline void store(float* data, Float4 a) { _mm_storeu_ps(data, a.v); }
+    inline Float4 splat(float value) { return { _mm_set1_ps(value) }; }
+    inline Float4 add(Float4 a, Float4 b) { return { _mm_add_ps(a.v, b.v) }; }
+    inline Float4 sub(Float4 a, Float4 b) { return { _mm_sub_ps(a.v, b.v) }; }
+    inline Float4 mul(Float4 a, Float4 b) { return { _mm_mul_ps(a.v, b.v) }; }
+    inline Float4 abs(Float4 a) { return { _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v) }; }
+
+    // a * b + c
+    inline Float4 madd(Float4 a, Float4 b, Float4 c) {
+#if defined(__FMA__)
+        return { _mm_fmadd_ps(a.v, b.v, c.v) };
+#else
+        return { _mm_add_ps(_mm_mul_ps(a.v, b.v), c.v) };
+#endif
+    }
+
+    // Broadcasts one element to all lanes
+    template<int I>
+    Float4 splatLane(Float4 a) {
+        return { _mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(I, I, I, I)) };
+    }
+#else
+    struct Float4 {
+        float v[4];
+    };
+
+    inline Float4 load(const float* data) { return { { data[0], data[1], data[2], data[3] } }; }
+    inline void store(float* data, Float4 a) { for (int i = 0; i < 4; i++) data[i] = a.v[i]; }
+    inline Float4 splat(float value) { return { { value, value, value, value } }; }
+    inline Float4 add(Float4 a, Float4 b) { return { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; }
+    inline Float4 sub(Float4 a, Float4 b) { return { { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } }; }
+    inline Float4 mul(Float4 a, Float4 b) { return { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } }; }
+    inline Float4 abs(Float4 a) { return { { std::abs(a.v[0]), std::abs(a.v[1]), std::abs(a.v[2]), std::abs(a.v[3]) } }; }
+    inline Float4 madd(Float4 a, Float4 b, Float4 c) { return add(mul(a, b), c); }
+
+    template<int I>
+    Float4 splatLane(Float4 a) {
+        return splat(a.v[I]);
+    }
+#endif
+
+#if defined(VKE_SIMD_AVX2)
+    // Two Float4 side by side, lane ops never cross the 128 bit halves
+    struct Float8 {
+        __m256 v;
+    };
+
+    inline Float8 load8(const float* data) { return { _mm256_loadu_ps(data) }; }
+    inline void store(float* data, Float8 a) { _mm256_storeu_ps(data, a.v); }
+    // Same four floats in both halves
+    inline Float8 broadcast4(const float* data) { return { _mm256_broadcast_ps(reinterpret_cast<const __m128*>(data)) }; }
+    inline Float8 madd(Float8 a, Float8 b, Float8 c) { return { _mm256_fmadd_ps(a.v, b.v, c.v) }; }
+    inline Float8 mul(Float8 a, Float8 b) { return { _mm256_mul_ps(a.v, b.v) }; }
+
+    // Broadcasts element I of each half within that half
+    template<int I>
+    Float8 splatLane(Float8 a) {
+        return { _mm256_permute_ps(a.v, _MM_SHUFFLE(I, I, I, I)) };
+    }
+#endif
+
+    constexpr unsigned getWidth() {
+#if defined(VKE_SIMD_AVX2)
+        return 8;
+#elif defined(VKE_SIMD_SSE)
+        return 4;
+#else
+        return 1;
+#endif
+    }
+}
+
+#endif
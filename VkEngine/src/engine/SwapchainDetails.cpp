@@ -1,5 +1,6 @@
 #include <algorithm>
 #include "engine/SwapchainDetails.hpp"
+#include "engine/vk/dispatch.hpp"
 
 namespace vke {
 
@@ -81,4 +82,8 @@ namespace vke {
     VkSurfaceTransformFlagBitsKHR SwapchainDetails::getCurrentTransform() const {
         return caps.currentTransform;
     }
+
+    VkImageUsageFlags SwapchainDetails::getSupportedUsage() const {
+        return caps.supportedUsageFlags;
+    }
 }
\ No newline at end of file
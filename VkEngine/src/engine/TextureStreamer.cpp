@@ -0,0 +1,438 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include "engine/TextureStreamer.hpp"
+#include "engine/Image.hpp"
+#include "engine/Trace.hpp"
+#include "engine/vk/dispatch.hpp"
+
+namespace vke {
+
+    namespace {
+        uint64_t alignUp(uint64_t value, uint64_t alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        uint32_t divideUp(uint32_t value, uint32_t divisor) {
+            return (value + divisor - 1) / divisor;
+        }
+
+        // Pixels covered by one block, 1x1 for everything that is not block compressed
+        VkExtent2D getBlockExtent(VkFormat format) {
+            // BC1 through BC7, then ETC2 and EAC, all of them use 4x4 blocks
+            if (format >= VK_FORMAT_BC1_RGB_UNORM_BLOCK && format <= VK_FORMAT_EAC_R11G11_SNORM_BLOCK)
+                return { 4, 4 };
+
+            if (format >= VK_FORMAT_ASTC_4x4_UNORM_BLOCK && format <= VK_FORMAT_ASTC_12x12_SRGB_BLOCK) {
+                // UNORM and SRGB variant of each block size follow each other
+                static constexpr VkExtent2D ASTC_BLOCKS[] = {
+                    { 4, 4 }, { 5, 4 }, { 5, 5 }, { 6, 5 }, { 6, 6 }, { 8, 5 }, { 8, 6 },
+                    { 8, 8 }, { 10, 5 }, { 10, 6 }, { 10, 8 }, { 10, 10 }, { 12, 10 }, { 12, 12 }
+                };
+                return ASTC_BLOCKS[(format - VK_FORMAT_ASTC_4x4_UNORM_BLOCK) / 2];
+            }
+
+            return { 1, 1 };
+        }
+
+        uint64_t getBlockCount(VkExtent2D extent, VkExtent2D blockExtent) {
+            return static_cast<uint64_t>(divideUp(extent.width, blockExtent.width)) * divideUp(extent.height, blockExtent.height);
+        }
+
+        VkImageMemoryBarrier2 makeBarrier(VkImage image, uint32_t baseLevel, uint32_t levelCount) {
+            VkImageMemoryBarrier2 barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = image;
+            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            barrier.subresourceRange.baseMipLevel = baseLevel;
+            barrier.subresourceRange.levelCount = levelCount;
+            barrier.subresourceRange.baseArrayLayer = 0;
+            barrier.subresourceRange.layerCount = 1;
+            return barrier;
+        }
+
+        void pipelineBarrier(VkCommandBuffer cmdBuffer, const std::vector<VkImageMemoryBarrier2>& barriers) {
+            if (barriers.empty())
+                return;
+
+            VkDependencyInfo dependency{};
+            dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+            dependency.imageMemoryBarrierCount = barriers.size();
+            dependency.pImageMemoryBarriers = barriers.data();
+            vkCmdPipelineBarrier2(cmdBuffer, &dependency);
+        }
+    }
+
+    std::ostream& operator<<(std::ostream& stream, const TextureStreamer::Stats& stats) {
+        stream << "[TextureStats] textures: " << stats.textures
+               << ", complete: " << stats.complete
+               << ", uploaded: " << stats.bytesUploaded << " B"
+               << ", pending: " << stats.bytesPending << " B";
+        return stream;
+    }
+
+    TextureStreamer::TextureStreamer() : mDevice{VK_NULL_HANDLE}, mPhysicalDevice{VK_NULL_HANDLE}, mDeviceMemoryType{}, mStagingBuffer{VK_NULL_HANDLE},
+                                         mStagingMemory{VK_NULL_HANDLE}, mStagingData{nullptr}, mStagingCoherent{false}, mFrameBudget{0}, mTextures{},
+                                         mPending{}, mChanged{}, mRetiredViews{}, mStats{} {
+    }
+
+    EngineResult<void> TextureStreamer::init(VkDevice device, VkPhysicalDevice physicalDevice, MemoryType stagingMemoryType, MemoryType deviceMemoryType, uint64_t frameBudget, size_t frameCount) {
+        mDevice = device;
+        mPhysicalDevice = physicalDevice;
+        mDeviceMemoryType = deviceMemoryType;
+        mStagingCoherent = stagingMemoryType.isHostCoherent();
+        mFrameBudget = frameBudget;
+        mRetiredViews.resize(frameCount);
+
+        // every frame in flight gets its own slice, so a slice is only rewritten after its frame finished
+        VkBufferCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        createInfo.size = frameBudget * frameCount;
+        createInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (VkResult result = vkCreateBuffer(mDevice, &createInfo, nullptr, &mStagingBuffer)) {
+            return EngineError::fromVkError(result);
+        }
+
+        VkMemoryRequirements requirements;
+        vkGetBufferMemoryRequirements(mDevice, mStagingBuffer, &requirements);
+
+        VkMemoryAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.allocationSize = requirements.size;
+        allocateInfo.memoryTypeIndex = stagingMemoryType.getTypeIndex();
+        if (VkResult result = vkAllocateMemory(mDevice, &allocateInfo, nullptr, &mStagingMemory)) {
+            return EngineError::fromVkError(result);
+        }
+
+        if (VkResult result = vkBindBufferMemory(mDevice, mStagingBuffer, mStagingMemory, 0)) {
+            return EngineError::fromVkError(result);
+        }
+
+        void* data;
+        if (VkResult result = vkMapMemory(mDevice, mStagingMemory, 0, VK_WHOLE_SIZE, 0, &data)) {
+            return EngineError::fromVkError(result);
+        }
+        mStagingData = static_cast<char*>(data);
+
+        return {};
+    }
+
+    void TextureStreamer::cleanup() {
+        if (mDevice == VK_NULL_HANDLE)
+            return;
+
+        for (std::vector<VkImageView>& views : mRetiredViews) {
+            for (VkImageView view : views) {
+                vkDestroyImageView(mDevice, view, nullptr);
+            }
+        }
+
+        for (Texture& texture : mTextures) {
+            vkDestroyImageView(mDevice, texture.view, nullptr);
+            vkDestroyImage(mDevice, texture.image, nullptr);
+            vkFreeMemory(mDevice, texture.memory, nullptr);
+        }
+
+        if (mStagingMemory != VK_NULL_HANDLE) {
+            vkUnmapMemory(mDevice, mStagingMemory);
+        }
+        vkDestroyBuffer(mDevice, mStagingBuffer, nullptr);
+        vkFreeMemory(mDevice, mStagingMemory, nullptr);
+
+        mTextures.clear();
+        mPending.clear();
+        mChanged.clear();
+        mRetiredViews.clear();
+        mStagingBuffer = VK_NULL_HANDLE;
+        mStagingMemory = VK_NULL_HANDLE;
+        mStagingData = nullptr;
+        mDevice = VK_NULL_HANDLE;
+    }
+
+    EngineResult<TextureStreamer::Handle> TextureStreamer::load(const std::filesystem::path& path) {
+        Ktx2File file;
+        if (auto opened = Ktx2File::open(path)) {
+            file = std::move(opened.getOk());
+        } else {
+            return EngineResult<Handle>::error(std::move(opened.getError()));
+        }
+
+        VkFormat format = file.getFormat();
+        VkExtent2D extent = file.getExtent();
+        uint32_t levelCount = file.getLevelCount();
+
+        // block compressed formats only report support when the device has the matching feature
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(mPhysicalDevice, format, &properties);
+        VkFormatFeatureFlags required = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_TRANSFER_DST_BIT;
+        if ((properties.optimalTilingFeatures & required) != required) {
+            return EngineResult<Handle>::error(EngineError::fromVkError(VK_ERROR_FORMAT_NOT_SUPPORTED));
+        }
+
+        // levels are copied in whole block rows, which needs every level tightly packed
+        VkExtent2D blockExtent = getBlockExtent(format);
+        uint64_t blockBytes = file.getLevelBytes(0) / getBlockCount(extent, blockExtent);
+        for (uint32_t level = 0; level < levelCount; level++) {
+            if (blockBytes == 0 || file.getLevelBytes(level) != getBlockCount(Image::getMipExtent(extent, level), blockExtent) * blockBytes)
+                return EngineResult<Handle>::error(EngineError::invalidFile("level sizes do not match the format"));
+        }
+
+        if (blockBytes * divideUp(extent.width, blockExtent.width) > mFrameBudget) {
+            return EngineResult<Handle>::error(EngineError::invalidFile("one row of blocks exceeds the frame budget"));
+        }
+
+        VkImageCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        createInfo.imageType = VK_IMAGE_TYPE_2D;
+        createInfo.format = format;
+        createInfo.extent = { extent.width, extent.height, 1 };
+        createInfo.mipLevels = levelCount;
+        createInfo.arrayLayers = 1;
+        createInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        createInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        createInfo.usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+        createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        createInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        VkImage image;
+        if (VkResult result = vkCreateImage(mDevice, &createInfo, nullptr, &image)) {
+            return EngineResult<Handle>::error(EngineError::fromVkError(result));
+        }
+
+        VkMemoryRequirements requirements;
+        vkGetImageMemoryRequirements(mDevice, image, &requirements);
+
+        uint32_t typeIndex = mDeviceMemoryType.getTypeIndex();
+        if (!mDeviceMemoryType.isValid() || !((requirements.memoryTypeBits >> typeIndex) & 1)) {
+            // fall back to lowest type the image accepts
+            typeIndex = std::countr_zero(requirements.memoryTypeBits);
+        }
+
+        VkMemoryAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.allocationSize = requirements.size;
+        allocateInfo.memoryTypeIndex = typeIndex;
+
+        VkDeviceMemory memory;
+        if (VkResult result = vkAllocateMemory(mDevice, &allocateInfo, nullptr, &memory)) {
+            vkDestroyImage(mDevice, image, nullptr);
+            return EngineResult<Handle>::error(EngineError::fromVkError(result));
+        }
+
+        if (VkResult result = vkBindImageMemory(mDevice, image, memory, 0)) {
+            vkDestroyImage(mDevice, image, nullptr);
+            vkFreeMemory(mDevice, memory, nullptr);
+            return EngineResult<Handle>::error(EngineError::fromVkError(result));
+        }
+
+        uint64_t totalBytes = 0;
+        for (uint32_t level = 0; level < levelCount; level++) {
+            totalBytes += file.getLevelBytes(level);
+        }
+
+        Handle handle = mTextures.size();
+        Texture& texture = mTextures.emplace_back();
+        texture.file = std::move(file);
+        texture.image = image;
+        texture.memory = memory;
+        texture.view = VK_NULL_HANDLE;
+        texture.format = format;
+        texture.extent = extent;
+        texture.levelCount = levelCount;
+        texture.residentLevel = levelCount;
+        texture.levelProgress = 0;
+        texture.blockExtent = blockExtent;
+        // buffer offsets of copies must be multiples of both the block size and 4
+        texture.copyAlignment = std::lcm(blockBytes, uint64_t{4});
+
+        mStats.textures++;
+        mStats.bytesPending += totalBytes;
+        schedule(handle);
+
+        return handle;
+    }
+
+    void TextureStreamer::schedule(Handle handle) {
+        const Texture& texture = mTextures[handle];
+        mPending.emplace_back(texture.file.getLevelBytes(texture.residentLevel - 1), handle);
+        std::push_heap(mPending.begin(), mPending.end(), std::greater<>());
+    }
+
+    EngineResult<VkImageView> TextureStreamer::createView(const Texture& texture) {
+        VkImageViewCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        createInfo.image = texture.image;
+        createInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        createInfo.format = texture.format;
+        createInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        // base level is the LOD clamp, levels above it are not there yet
+        createInfo.subresourceRange.baseMipLevel = texture.residentLevel;
+        createInfo.subresourceRange.levelCount = texture.levelCount - texture.residentLevel;
+        createInfo.subresourceRange.baseArrayLayer = 0;
+        createInfo.subresourceRange.layerCount = 1;
+
+        VkImageView view;
+        if (VkResult result = vkCreateImageView(mDevice, &createInfo, nullptr, &view)) {
+            return EngineResult<VkImageView>::error(EngineError::fromVkError(result));
+        }
+
+        return view;
+    }
+
+    VkImageView TextureStreamer::getView(Handle handle) const {
+        return mTextures[handle].view;
+    }
+
+    uint32_t TextureStreamer::getResidentLevel(Handle handle) const {
+        return mTextures[handle].residentLevel;
+    }
+
+    bool TextureStreamer::isComplete(Handle handle) const {
+        return mTextures[handle].residentLevel == 0;
+    }
+
+    std::vector<TextureStreamer::Handle> TextureStreamer::takeChanged() {
+        return std::exchange(mChanged, {});
+    }
+
+    EngineResult<void> TextureStreamer::record(VkCommandBuffer cmdBuffer, size_t frame) {
+        VKE_TRACE_SCOPE("TextureStreamer::record");
+
+        // frame's fence was waited on, nothing it recorded can still use these
+        for (VkImageView view : mRetiredViews[frame]) {
+            vkDestroyImageView(mDevice, view, nullptr);
+        }
+        mRetiredViews[frame].clear();
+
+        if (mPending.empty())
+            return {};
+
+        std::vector<VkBufferImageCopy> regions;
+        std::vector<VkImage> targets;
+        std::vector<VkImageMemoryBarrier2> before;
+        std::vector<VkImageMemoryBarrier2> after;
+        std::vector<Handle> completed;
+
+        uint64_t base = frame * mFrameBudget;
+        uint64_t used = 0;
+
+        while (!mPending.empty()) {
+            Handle handle = mPending.front().second;
+            Texture& texture = mTextures[handle];
+
+            uint32_t level = texture.residentLevel - 1;
+            VkExtent2D levelExtent = Image::getMipExtent(texture.extent, level);
+            uint64_t levelBytes = texture.file.getLevelBytes(level);
+            uint32_t blockRows = divideUp(levelExtent.height, texture.blockExtent.height);
+            uint64_t rowBytes = levelBytes / blockRows;
+
+            // copies need offsets aligned within the whole staging buffer, the frame's slice may start anywhere
+            uint64_t offset = alignUp(base + used, texture.copyAlignment) - base;
+            uint64_t available = offset < mFrameBudget ? mFrameBudget - offset : 0;
+            uint32_t firstRow = static_cast<uint32_t>(texture.levelProgress / rowBytes);
+            uint32_t rows = static_cast<uint32_t>(std::min<uint64_t>(available / rowBytes, blockRows - firstRow));
+            if (rows == 0)
+                break;
+
+            if (level == texture.levelCount - 1 && texture.levelProgress == 0) {
+                // first copy into this image, the whole chain leaves UNDEFINED at once
+                VkImageMemoryBarrier2& barrier = before.emplace_back(makeBarrier(texture.image, 0, texture.levelCount));
+                barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+                barrier.srcAccessMask = VK_ACCESS_2_NONE;
+                barrier.dstStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+                barrier.dstAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+                barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+                barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            }
+
+            uint64_t bytes = static_cast<uint64_t>(rows) * rowBytes;
+            std::memcpy(mStagingData + base + offset, static_cast<const char*>(texture.file.getLevelData(level)) + texture.levelProgress, bytes);
+
+            uint32_t firstPixelRow = firstRow * texture.blockExtent.height;
+            VkBufferImageCopy& region = regions.emplace_back();
+            region.bufferOffset = base + offset;
+            region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1 };
+            region.imageOffset = { 0, static_cast<int32_t>(firstPixelRow), 0 };
+            region.imageExtent = { levelExtent.width, std::min(rows * texture.blockExtent.height, levelExtent.height - firstPixelRow), 1 };
+            targets.push_back(texture.image);
+
+            used = offset + bytes;
+            texture.levelProgress += bytes;
+            mStats.bytesUploaded += bytes;
+            mStats.bytesPending -= bytes;
+
+            // level only partially fit, so the budget is used up
+            if (texture.levelProgress < levelBytes)
+                break;
+
+            VkImageMemoryBarrier2& barrier = after.emplace_back(makeBarrier(texture.image, level, 1));
+            barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+            barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            barrier.dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+            barrier.dstAccessMask = VK_ACCESS_2_SHADER_SAMPLED_READ_BIT;
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+            std::pop_heap(mPending.begin(), mPending.end(), std::greater<>());
+            mPending.pop_back();
+
+            texture.residentLevel = level;
+            texture.levelProgress = 0;
+            if (std::find(completed.begin(), completed.end(), handle) == completed.end()) {
+                completed.push_back(handle);
+            }
+
+            if (level > 0) {
+                schedule(handle);
+            } else {
+                mStats.complete++;
+            }
+        }
+
+        if (regions.empty())
+            return {};
+
+        if (!mStagingCoherent) {
+            VkMappedMemoryRange range{};
+            range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+            range.memory = mStagingMemory;
+            range.offset = 0;
+            range.size = VK_WHOLE_SIZE;
+            if (VkResult result = vkFlushMappedMemoryRanges(mDevice, 1, &range)) {
+                return EngineError::fromVkError(result);
+            }
+        }
+
+        pipelineBarrier(cmdBuffer, before);
+        for (size_t i = 0; i < regions.size(); i++) {
+            vkCmdCopyBufferToImage(cmdBuffer, mStagingBuffer, targets[i], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &regions[i]);
+        }
+        pipelineBarrier(cmdBuffer, after);
+
+        // one new view per texture, however many of its levels arrived this frame
+        for (Handle handle : completed) {
+            Texture& texture = mTextures[handle];
+
+            auto view = createView(texture);
+            if (!view)
+                return view;
+
+            if (texture.view != VK_NULL_HANDLE) {
+                mRetiredViews[frame].push_back(texture.view);
+            }
+            texture.view = view.getOk();
+            mChanged.push_back(handle);
+        }
+
+        return {};
+    }
+
+    const TextureStreamer::Stats& TextureStreamer::getStats() const {
+        return mStats;
+    }
+}
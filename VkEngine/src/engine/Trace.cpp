@@ -0,0 +1,382 @@
+#include "engine/Trace.hpp"
+
+#ifdef VKE_TRACING
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "engine/Log.hpp"
+#include "engine/vk/dispatch.hpp"
+
+namespace vke::trace {
+
+    namespace {
+        struct Event {
+            const char* name;
+            uint64_t begin;
+            uint64_t end;
+        };
+
+        constexpr uint32_t CHUNK_EVENTS = 4096;
+        // about 24 MiB of events per thread
+        constexpr uint32_t MAX_CHUNKS = 256;
+
+        // Filled by a single writer, count is published after the event so readers never see a partial one
+        struct Chunk {
+            Event events[CHUNK_EVENTS];
+            std::atomic<uint32_t> count{0};
+            std::atomic<Chunk*> next{nullptr};
+        };
+    }
+
+    struct Track {
+        uint32_t id;
+        std::atomic<const char*> name{nullptr};
+        std::atomic<uint64_t> dropped{0};
+        Chunk head;
+        // writer only
+        Chunk* tail = &head;
+        uint32_t chunkCount = 1;
+
+        ~Track() {
+            Chunk* chunk = head.next.load(std::memory_order_relaxed);
+            while (chunk) {
+                Chunk* next = chunk->next.load(std::memory_order_relaxed);
+                delete chunk;
+                chunk = next;
+            }
+        }
+    };
+
+    namespace {
+        // Tracks outlive their threads so events of finished workers still get exported
+        struct Registry {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<Track>> tracks;
+        };
+
+        Registry& getRegistry() {
+            // never destroyed, threads may still trace while statics are torn down
+            static Registry* registry = new Registry;
+            return *registry;
+        }
+
+        Track* createTrack(const char* name) {
+            Registry& registry = getRegistry();
+            std::lock_guard lock(registry.mutex);
+
+            auto track = std::make_unique<Track>();
+            track->id = static_cast<uint32_t>(registry.tracks.size()) + 1;
+            track->name.store(name, std::memory_order_relaxed);
+            registry.tracks.push_back(std::move(track));
+
+            return registry.tracks.back().get();
+        }
+
+        thread_local Track* tTrack = nullptr;
+
+        Track& getThreadTrack() {
+            if (!tTrack)
+                tTrack = createTrack(nullptr);
+
+            return *tTrack;
+        }
+
+        void append(Track& track, const char* name, uint64_t begin, uint64_t end) {
+            Chunk* chunk = track.tail;
+            uint32_t count = chunk->count.load(std::memory_order_relaxed);
+
+            if (count == CHUNK_EVENTS) {
+                if (track.chunkCount == MAX_CHUNKS) {
+                    track.dropped.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+
+                Chunk* next = new Chunk;
+                chunk->next.store(next, std::memory_order_release);
+                track.tail = chunk = next;
+                track.chunkCount++;
+                count = 0;
+            }
+
+            chunk->events[count] = { name, begin, end };
+            chunk->count.store(count + 1, std::memory_order_release);
+        }
+
+        GpuTimeline* gActive = nullptr;
+
+        void writeString(std::ostream& stream, const char* string) {
+            stream << '"';
+            for (const char* c = string; *c; c++) {
+                if (*c == '"' || *c == '\\') {
+                    stream << '\\' << *c;
+                } else if (static_cast<unsigned char>(*c) < 0x20) {
+                    stream << ' ';
+                } else {
+                    stream << *c;
+                }
+            }
+            stream << '"';
+        }
+
+        // Chrome trace timestamps are microseconds, keep nanosecond precision
+        void writeMicros(std::ostream& stream, uint64_t nanos) {
+            char buffer[32];
+            std::snprintf(buffer, sizeof(buffer), "%llu.%03llu", static_cast<unsigned long long>(nanos / 1000), static_cast<unsigned long long>(nanos % 1000));
+            stream << buffer;
+        }
+    }
+
+    uint64_t now() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void record(const char* name, uint64_t begin, uint64_t end) {
+        append(getThreadTrack(), name, begin, end);
+    }
+
+    void setThreadName(const char* name) {
+        getThreadTrack().name.store(name, std::memory_order_relaxed);
+    }
+
+    GpuTimeline::GpuTimeline() : mDevice{}, mPool{VK_NULL_HANDLE}, mPeriod{}, mMask{}, mFrameQueries{}, mCurrent{}, mRecording{false}, mOffset{}, mCalibrated{false}, mTrack{nullptr} {
+    }
+
+    EngineResult<void> GpuTimeline::init(VkDevice device, VkPhysicalDevice physicalDevice, uint32_t queueFamily, size_t frameCount) {
+        mDevice = device;
+
+        uint32_t familyCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, nullptr);
+        std::vector<VkQueueFamilyProperties> families(familyCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, families.data());
+
+        uint32_t validBits = queueFamily < familyCount ? families[queueFamily].timestampValidBits : 0;
+        if (validBits == 0) {
+            log::warn(log::Category::ENGINE, "Queue family has no timestamps, GPU scopes are not traced");
+            return {};
+        }
+
+        VkPhysicalDeviceProperties properties;
+        vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+        mPeriod = properties.limits.timestampPeriod;
+        mMask = validBits >= 64 ? std::numeric_limits<uint64_t>::max() : (1ull << validBits) - 1;
+
+        // every scope reserves its begin and end query
+        mFrameQueries = MAX_FRAME_SCOPES * 2;
+        mFrames.resize(frameCount);
+        mResults.resize(mFrameQueries);
+
+        VkQueryPoolCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        createInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        createInfo.queryCount = mFrameQueries * static_cast<uint32_t>(frameCount);
+        if (VkResult result = vkCreateQueryPool(mDevice, &createInfo, nullptr, &mPool)) {
+            return EngineError::fromVkError(result);
+        }
+
+        if (!mTrack)
+            mTrack = createTrack("GPU");
+
+        gActive = this;
+
+        return {};
+    }
+
+    void GpuTimeline::cleanup() {
+        if (!mPool)
+            return;
+
+        // device is idle, so every submitted frame has its results
+        for (Frame& frame : mFrames) {
+            if (frame.submitTime != 0)
+                collect(frame);
+        }
+
+        vkDestroyQueryPool(mDevice, mPool, nullptr);
+        mPool = VK_NULL_HANDLE;
+        mFrames.clear();
+        mOpen.clear();
+        mRecording = false;
+
+        if (gActive == this)
+            gActive = nullptr;
+    }
+
+    void GpuTimeline::collect(Frame& frame) {
+        // frames recorded but never submitted have no results
+        if (!frame.scopes.empty() && frame.submitTime != 0) {
+            uint64_t* results = mResults.data();
+            VkResult result = vkGetQueryPoolResults(mDevice, mPool, static_cast<uint32_t>(&frame - mFrames.data()) * mFrameQueries, frame.queryCount,
+                frame.queryCount * sizeof(uint64_t), results, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+
+            if (result == VK_SUCCESS) {
+                auto toNanos = [this](uint64_t ticks) { return static_cast<int64_t>(static_cast<double>(ticks) * mPeriod); };
+
+                uint64_t first = results[frame.scopes.front().beginQuery];
+                for (const Pending& scope : frame.scopes) {
+                    first = std::min(first, results[scope.beginQuery]);
+                }
+
+                // GPU can't start before submit, so every frame bounds the clock offset from below
+                int64_t offset = static_cast<int64_t>(frame.submitTime) - toNanos(first);
+                if (!mCalibrated || offset > mOffset) {
+                    mOffset = offset;
+                    mCalibrated = true;
+                }
+
+                for (const Pending& scope : frame.scopes) {
+                    uint64_t begin = results[scope.beginQuery];
+                    uint64_t duration = static_cast<uint64_t>(toNanos((results[scope.endQuery] - begin) & mMask));
+                    uint64_t start = static_cast<uint64_t>(toNanos(begin) + mOffset);
+                    append(*mTrack, scope.name, start, start + duration);
+                }
+            }
+        }
+
+        frame.scopes.clear();
+        frame.queryCount = 0;
+        frame.submitTime = 0;
+    }
+
+    void GpuTimeline::record(VkCommandBuffer cmdBuffer, size_t frame) {
+        if (!mPool)
+            return;
+
+        collect(mFrames[frame]);
+
+        vkCmdResetQueryPool(cmdBuffer, mPool, static_cast<uint32_t>(frame) * mFrameQueries, mFrameQueries);
+        mCurrent = frame;
+        mOpen.clear();
+        mRecording = true;
+    }
+
+    void GpuTimeline::submitted(size_t frame) {
+        if (!mPool)
+            return;
+
+        mFrames[frame].submitTime = now();
+        mRecording = false;
+    }
+
+    void GpuTimeline::begin(VkCommandBuffer cmdBuffer, const char* name) {
+        Frame& frame = mFrames[mCurrent];
+
+        // queries are only reset between record() and submitted(), scopes elsewhere or past the limit are skipped
+        if (!mRecording || frame.queryCount == mFrameQueries) {
+            mOpen.push_back(UINT32_MAX);
+            return;
+        }
+
+        uint32_t query = frame.queryCount;
+        frame.queryCount += 2;
+        vkCmdWriteTimestamp2(cmdBuffer, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT, mPool, static_cast<uint32_t>(mCurrent) * mFrameQueries + query);
+
+        mOpen.push_back(static_cast<uint32_t>(frame.scopes.size()));
+        frame.scopes.push_back({ name, query, query + 1 });
+    }
+
+    void GpuTimeline::end(VkCommandBuffer cmdBuffer) {
+        if (mOpen.empty())
+            return;
+
+        uint32_t index = mOpen.back();
+        mOpen.pop_back();
+        if (index == UINT32_MAX || !mRecording)
+            return;
+
+        uint32_t query = static_cast<uint32_t>(mCurrent) * mFrameQueries + mFrames[mCurrent].scopes[index].endQuery;
+        vkCmdWriteTimestamp2(cmdBuffer, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, mPool, query);
+    }
+
+    GpuTimeline* GpuTimeline::getActive() {
+        return gActive;
+    }
+
+    EngineResult<void> exportChromeJson(const std::filesystem::path& path) {
+        std::vector<Track*> tracks;
+        {
+            Registry& registry = getRegistry();
+            std::lock_guard lock(registry.mutex);
+            for (const std::unique_ptr<Track>& track : registry.tracks) {
+                tracks.push_back(track.get());
+            }
+        }
+
+        // events are written relative to the earliest one, chunks only ever grow so a second pass sees at least as much
+        uint64_t base = std::numeric_limits<uint64_t>::max();
+        for (Track* track : tracks) {
+            for (Chunk* chunk = &track->head; chunk; chunk = chunk->next.load(std::memory_order_acquire)) {
+                uint32_t count = chunk->count.load(std::memory_order_acquire);
+                for (uint32_t i = 0; i < count; i++) {
+                    base = std::min(base, chunk->events[i].begin);
+                }
+            }
+        }
+
+        std::ofstream file(path, std::ios::trunc);
+        if (file.fail())
+            return EngineResult<void>::error(EngineError::fromOsError({ errno, std::generic_category() }));
+
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+        bool first = true;
+        uint64_t dropped = 0;
+        for (Track* track : tracks) {
+            std::string fallbackName = "Thread " + std::to_string(track->id);
+            const char* name = track->name.load(std::memory_order_relaxed);
+
+            file << (first ? "" : ",\n") << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << track->id << ",\"args\":{\"name\":";
+            writeString(file, name ? name : fallbackName.c_str());
+            file << "}}";
+            first = false;
+
+            for (Chunk* chunk = &track->head; chunk; chunk = chunk->next.load(std::memory_order_acquire)) {
+                uint32_t count = chunk->count.load(std::memory_order_acquire);
+                for (uint32_t i = 0; i < count; i++) {
+                    const Event& event = chunk->events[i];
+                    // GPU events placed by a loose clock offset may land before the first CPU event
+                    uint64_t begin = std::max(event.begin, base) - base;
+
+                    file << ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":" << track->id << ",\"name\":";
+                    writeString(file, event.name);
+                    file << ",\"ts\":";
+                    writeMicros(file, begin);
+                    file << ",\"dur\":";
+                    writeMicros(file, event.end >= event.begin ? event.end - event.begin : 0);
+                    file << '}';
+                }
+            }
+
+            dropped += track->dropped.load(std::memory_order_relaxed);
+        }
+
+        file << "\n]}\n";
+
+        file.close();
+        if (file.fail())
+            return EngineResult<void>::error(EngineError::fromOsError({ errno, std::generic_category() }));
+
+        if (dropped > 0) {
+            log::warn(log::Category::ENGINE, dropped, " trace events were dropped, per thread buffers are full");
+        }
+
+        return {};
+    }
+}
+
+#else
+
+namespace vke::trace {
+
+    EngineResult<void> exportChromeJson(const std::filesystem::path&) {
+        return EngineResult<void>::error(EngineError::featureNotSupported("tracing"));
+    }
+}
+
+#endif
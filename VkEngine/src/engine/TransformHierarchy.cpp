@@ -0,0 +1,257 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <numeric>
+#include "engine/TransformHierarchy.hpp"
+#include "engine/Math.hpp"
+
+namespace vke {
+
+    namespace {
+        template<typename T>
+        void permute(std::vector<T>& values, const std::vector<uint32_t>& order) {
+            std::vector<T> sorted(values.size());
+            for (size_t i = 0; i < order.size(); i++) {
+                sorted[i] = values[order[i]];
+            }
+            values = std::move(sorted);
+        }
+
+        std::atomic<uint64_t> nextId{1};
+    }
+
+    TransformHierarchy::TransformHierarchy() : mId{nextId++}, mVersion{0}, mNeedsSort{false}, mAnyDirty{false} {
+    }
+
+    TransformHierarchy::Node TransformHierarchy::create(Node parent) {
+        Node node = mIndexes.size();
+        uint32_t index = mNodes.size();
+
+        mPositionX.push_back(0.0f);
+        mPositionY.push_back(0.0f);
+        mPositionZ.push_back(0.0f);
+        mRotationX.push_back(0.0f);
+        mRotationY.push_back(0.0f);
+        mRotationZ.push_back(0.0f);
+        mRotationW.push_back(1.0f);
+        mScaleX.push_back(1.0f);
+        mScaleY.push_back(1.0f);
+        mScaleZ.push_back(1.0f);
+        mWorld.resize(mWorld.size() + 16, 0.0f);
+        // appended after its parent, so order is preserved
+        mParents.push_back(parent == NONE ? NONE : mIndexes[parent]);
+        mDirty.push_back(1);
+        mChangedAt.push_back(0);
+        mNodes.push_back(node);
+        mIndexes.push_back(index);
+        mAnyDirty = true;
+
+        return node;
+    }
+
+    bool TransformHierarchy::setParent(Node node, Node parent) {
+        uint32_t index = mIndexes[node];
+        uint32_t parentIndex = parent == NONE ? NONE : mIndexes[parent];
+
+        // a cycle would have no root to resolve it from and keep depth() walking forever
+        for (uint32_t ancestor = parentIndex; ancestor != NONE; ancestor = mParents[ancestor]) {
+            if (ancestor == index)
+                return false;
+        }
+
+        mParents[index] = parentIndex;
+        if (parentIndex != NONE && parentIndex > index) {
+            mNeedsSort = true;
+        }
+
+        markDirty(index);
+        return true;
+    }
+
+    TransformHierarchy::Node TransformHierarchy::getParent(Node node) const {
+        uint32_t parentIndex = mParents[mIndexes[node]];
+        return parentIndex == NONE ? NONE : mNodes[parentIndex];
+    }
+
+    size_t TransformHierarchy::size() const {
+        return mNodes.size();
+    }
+
+    void TransformHierarchy::setPosition(Node node, float x, float y, float z) {
+        uint32_t index = mIndexes[node];
+        mPositionX[index] = x;
+        mPositionY[index] = y;
+        mPositionZ[index] = z;
+        markDirty(index);
+    }
+
+    void TransformHierarchy::setRotation(Node node, float x, float y, float z, float w) {
+        uint32_t index = mIndexes[node];
+        mRotationX[index] = x;
+        mRotationY[index] = y;
+        mRotationZ[index] = z;
+        mRotationW[index] = w;
+        markDirty(index);
+    }
+
+    void TransformHierarchy::setScale(Node node, float x, float y, float z) {
+        uint32_t index = mIndexes[node];
+        mScaleX[index] = x;
+        mScaleY[index] = y;
+        mScaleZ[index] = z;
+        markDirty(index);
+    }
+
+    void TransformHierarchy::markDirty(uint32_t index) {
+        mDirty[index] = 1;
+        mAnyDirty = true;
+    }
+
+    uint32_t TransformHierarchy::depth(uint32_t index) const {
+        uint32_t depth = 0;
+        for (uint32_t parent = mParents[index]; parent != NONE; parent = mParents[parent]) {
+            depth++;
+        }
+        return depth;
+    }
+
+    void TransformHierarchy::sort() {
+        size_t count = mNodes.size();
+
+        // sorting by depth puts every parent in front of its children, stable sort keeps siblings together
+        std::vector<uint32_t> depths(count);
+        for (uint32_t i = 0; i < count; i++) {
+            depths[i] = depth(i);
+        }
+
+        std::vector<uint32_t> order(count);
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&depths](uint32_t a, uint32_t b) {
+            return depths[a] < depths[b];
+        });
+
+        std::vector<uint32_t> remap(count);
+        for (uint32_t i = 0; i < count; i++) {
+            remap[order[i]] = i;
+        }
+
+        permute(mPositionX, order);
+        permute(mPositionY, order);
+        permute(mPositionZ, order);
+        permute(mRotationX, order);
+        permute(mRotationY, order);
+        permute(mRotationZ, order);
+        permute(mRotationW, order);
+        permute(mScaleX, order);
+        permute(mScaleY, order);
+        permute(mScaleZ, order);
+        permute(mParents, order);
+        permute(mNodes, order);
+
+        for (uint32_t& parent : mParents) {
+            if (parent != NONE) {
+                parent = remap[parent];
+            }
+        }
+
+        for (uint32_t i = 0; i < count; i++) {
+            mIndexes[mNodes[i]] = i;
+        }
+
+        // every buffer slot moved, so everything is recomputed and rewritten
+        std::fill(mDirty.begin(), mDirty.end(), 1);
+        mAnyDirty = true;
+        mNeedsSort = false;
+    }
+
+    void TransformHierarchy::update() {
+        if (mNeedsSort) {
+            sort();
+        }
+
+        if (!mAnyDirty)
+            return;
+
+        mVersion++;
+
+        for (size_t i = 0, count = mNodes.size(); i < count; i++) {
+            uint32_t parent = mParents[i];
+
+            // parent was already resolved, its flag tells whether its world matrix changed
+            if (parent != NONE && mDirty[parent]) {
+                mDirty[i] = 1;
+            }
+
+            if (!mDirty[i])
+                continue;
+
+            float x = mRotationX[i], y = mRotationY[i], z = mRotationZ[i], w = mRotationW[i];
+            float sx = mScaleX[i], sy = mScaleY[i], sz = mScaleZ[i];
+
+            float local[16] = {
+                (1.0f - 2.0f * (y * y + z * z)) * sx, 2.0f * (x * y + w * z) * sx, 2.0f * (x * z - w * y) * sx, 0.0f,
+                2.0f * (x * y - w * z) * sy, (1.0f - 2.0f * (x * x + z * z)) * sy, 2.0f * (y * z + w * x) * sy, 0.0f,
+                2.0f * (x * z + w * y) * sz, 2.0f * (y * z - w * x) * sz, (1.0f - 2.0f * (x * x + y * y)) * sz, 0.0f,
+                mPositionX[i], mPositionY[i], mPositionZ[i], 1.0f
+            };
+
+            float* world = &mWorld[i * 16];
+            if (parent == NONE) {
+                std::memcpy(world, local, sizeof(local));
+            } else {
+                multiply(&mWorld[static_cast<size_t>(parent) * 16], local, world);
+            }
+
+            mChangedAt[i] = mVersion;
+        }
+
+        std::fill(mDirty.begin(), mDirty.end(), 0);
+        mAnyDirty = false;
+    }
+
+    const float* TransformHierarchy::getWorld(Node node) const {
+        return &mWorld[static_cast<size_t>(mIndexes[node]) * 16];
+    }
+
+    uint32_t TransformHierarchy::getIndex(Node node) const {
+        return mIndexes[node];
+    }
+
+    uint64_t TransformHierarchy::getVersion() const {
+        return mVersion;
+    }
+
+    uint64_t TransformHierarchy::getId() const {
+        return mId;
+    }
+
+    TransformHierarchy::WorldWrite TransformHierarchy::writeWorld(void* mapped, uint64_t version) const {
+        char* destination = static_cast<char*>(mapped);
+        size_t count = mNodes.size();
+        size_t first = count;
+        size_t last = 0;
+
+        // copy runs of changed matrices, mapped memory is often write combined and likes long sequential writes
+        for (size_t i = 0; i < count;) {
+            if (mChangedAt[i] <= version) {
+                i++;
+                continue;
+            }
+
+            size_t end = i + 1;
+            while (end < count && mChangedAt[end] > version) {
+                end++;
+            }
+
+            std::memcpy(destination + i * MATRIX_SIZE, &mWorld[i * 16], (end - i) * MATRIX_SIZE);
+            first = std::min(first, i);
+            last = end;
+            i = end;
+        }
+
+        if (first >= last)
+            return { mVersion, 0, 0 };
+
+        return { mVersion, first * MATRIX_SIZE, (last - first) * MATRIX_SIZE };
+    }
+}
@@ -1,14 +1,56 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_vulkan.h>
 #include <map>
+#include <bit>
+#include <cstring>
+#include <functional>
+#include <string_view>
 
-#include "engine/vk/proxies.hpp"
+#include "engine/vk/dispatch.hpp"
 #include "engine/VkEngineApp.hpp"
 #include "engine/QueueFamilyIndexes.hpp"
 #include "engine/SwapchainDetails.hpp"
+#include "engine/Log.hpp"
+#include "engine/Trace.hpp"
 
 namespace vke {
-    VkEngineApp::VkEngineApp() : mWindow{nullptr}, mRunning{false} {
+    namespace {
+        // validation costs CPU time on every Vulkan call, so builds without asserts go without it
+#ifdef NDEBUG
+        constexpr VkEngineApp::Profile DEFAULT_PROFILE = VkEngineApp::Profile::RELEASE;
+#else
+        constexpr VkEngineApp::Profile DEFAULT_PROFILE = VkEngineApp::Profile::DEBUG;
+#endif
+
+        // Bytes of one texel for the uncompressed color formats textures are created with, 0 when unknown
+        uint32_t getTexelSize(VkFormat format) {
+            switch (format) {
+                case VK_FORMAT_R8_UNORM:
+                case VK_FORMAT_R8_SRGB:
+                    return 1;
+                case VK_FORMAT_R8G8_UNORM:
+                case VK_FORMAT_R8G8_SRGB:
+                case VK_FORMAT_R16_SFLOAT:
+                    return 2;
+                case VK_FORMAT_R8G8B8A8_UNORM:
+                case VK_FORMAT_R8G8B8A8_SRGB:
+                case VK_FORMAT_B8G8R8A8_UNORM:
+                case VK_FORMAT_B8G8R8A8_SRGB:
+                case VK_FORMAT_R16G16_SFLOAT:
+                case VK_FORMAT_R32_SFLOAT:
+                    return 4;
+                case VK_FORMAT_R16G16B16A16_SFLOAT:
+                case VK_FORMAT_R32G32_SFLOAT:
+                    return 8;
+                case VK_FORMAT_R32G32B32A32_SFLOAT:
+                    return 16;
+                default:
+                    return 0;
+            }
+        }
+    }
+
+    VkEngineApp::VkEngineApp() : mWindow{nullptr}, mRunning{false}, mSwapchainOutdated{false}, mRenderPath{RenderPath::RENDER_PASS}, mAsyncComputeRequested{false}, mWindowHidden{false}, mProfile{DEFAULT_PROFILE}, mUploadStaging(MAX_CONCURRENT_FRAMES) {
         SDL_SetMainReady();
         SDL_Init(SDL_INIT_VIDEO);
     }
@@ -17,25 +59,74 @@ namespace vke {
         SDL_Quit();
     }
 
+    void VkEngineApp::setRenderPath(RenderPath path) {
+        mRenderPath = path;
+    }
+
+    void VkEngineApp::setAsyncCompute(bool enabled) {
+        mAsyncComputeRequested = enabled;
+    }
+
+    void VkEngineApp::setWindowHidden(bool hidden) {
+        mWindowHidden = hidden;
+    }
+
+    void VkEngineApp::setProfile(Profile profile) {
+        mProfile = profile;
+    }
+
+    VkEngineApp::Profile VkEngineApp::getProfile() const {
+        return mProfile;
+    }
+
     EngineResult<void> VkEngineApp::create(int width, int height, const char* title) {
+        VKE_TRACE_THREAD("Render");
+        VKE_TRACE_SCOPE("VkEngineApp::create");
+
         TRY(createWindow(width, height, title));
         TRY(createInstance(title));
         TRY(createSurface());
         TRY(findPhysicalDevice());
         TRY(createDevice());
+        setMemoryTypes();
         TRY(createSwapchain());
         TRY(createImageViews());
-        TRY(createRenderPass());
+        TRY(chooseDepthFormat());
+        TRY(createDepthResources());
+
+        if (mRenderPath == RenderPath::RENDER_PASS) {
+            TRY(createRenderPass());
+        }
+
         TRY(createShaderModules());
+        mPipelineDescription = describePipeline();
+        mInstanceBatcher.setInstanceStride(mPipelineDescription.getInstanceStride());
+        TRY(createDescriptors());
         TRY(createPipeline());
-        TRY(createFramebuffers());
+
+        if (mRenderPath == RenderPath::RENDER_PASS) {
+            TRY(createFramebuffers());
+        }
+
         TRY(createCommandPool());
         TRY(createCommandBuffers());
         TRY(createSemaphores());
         TRY(createFences());
-        setMemoryTypes();
+        TRY(createAsyncCompute());
+        TRY(createAssetStreamer());
+        TRY(createTextureStreamer());
+        TRY(createFrameCapture());
+        TRY(createGpuTimeline());
+
+        {
+            VKE_TRACE_SCOPE("VkEngineApp::onInit");
+            TRY(onInit());
+        }
 
-        onInit();
+        // passes declared by the app may use whatever onInit() created
+        if (mRenderPath == RenderPath::DYNAMIC_RENDERING) {
+            TRY(createRenderGraph());
+        }
 
         return utils::Result<void, EngineError>::ok();
     }
@@ -66,6 +157,11 @@ namespace vke {
             case SDL_QUIT:
                 mRunning = false;
                 break;
+            case SDL_WINDOWEVENT:
+                if (event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
+                    mSwapchainOutdated = true;
+                }
+                break;
         }
     }
 
@@ -73,6 +169,40 @@ namespace vke {
         // Finish whatever device is doing right now before cleanup
         vkDeviceWaitIdle(mDevice);
 
+        mInstanceMappings.clear();
+        mInstanceBuffers.clear();
+        mInstanceBufferSizes.clear();
+        mTransformUploads.clear();
+        mGpuCulling.cleanup();
+        mAsyncCompute.cleanup();
+        mAssetStreamer.cleanup();
+        mTextureStreamer.cleanup();
+        mFrameCapture.cleanup();
+#ifdef VKE_TRACING
+        mGpuTimeline.cleanup();
+#endif
+        mRenderGraph.cleanup();
+        mImageUploads.clear();
+        mMeshUploads.clear();
+        for (std::vector<Buffer>& staging : mUploadStaging) {
+            staging.clear();
+        }
+
+        for (VkSampler sampler : mSamplers) {
+            vkDestroySampler(mDevice, sampler, nullptr);
+        }
+        mSamplers.clear();
+
+        for (VkImageView view : mImageViews) {
+            vkDestroyImageView(mDevice, view, nullptr);
+        }
+        mImageViews.clear();
+
+        for (VkImage image : mImages) {
+            vkDestroyImage(mDevice, image, nullptr);
+        }
+        mImages.clear();
+
         for (VkBuffer buffer : mBuffers) {
             vkDestroyBuffer(mDevice, buffer, nullptr);
         }
@@ -96,41 +226,48 @@ namespace vke {
         vkFreeCommandBuffers(mDevice, mCommandPool, mCommandBuffers.size(), mCommandBuffers.data());
         vkDestroyCommandPool(mDevice, mCommandPool, nullptr);
 
-        for (const VkFramebuffer& framebuffer : mFramebuffers) {
-            vkDestroyFramebuffer(mDevice, framebuffer, nullptr);
-        }
-        mFramebuffers.clear();
+        destroySwapchain();
+        destroyDepthResources();
 
         for (const auto& entry : mShaderModules) {
             vkDestroyShaderModule(mDevice, entry.second.getHandle(), nullptr);
         }
         mShaderModules.clear();
 
+        mDescriptorAllocator.cleanup();
+        mDescriptorLayoutCache.cleanup();
+        mDescriptorSetLayouts.clear();
+
         vkDestroyPipelineLayout(mDevice, mPipelineLayout, nullptr);
         vkDestroyRenderPass(mDevice, mRenderPass, nullptr);
         vkDestroyPipeline(mDevice, mPipeline, nullptr);
 
-        for (const VkImageView& view : mSwapchainImageViews) {
-            vkDestroyImageView(mDevice, view, nullptr);
-        }
-        mSwapchainImageViews.clear();
-
-        vkDestroySwapchainKHR(mDevice, mSwapchain, nullptr);
-        mSwapchainImages.clear();
-
         vkDestroySurfaceKHR(mInstance, mSurface, nullptr);
 
         vkDestroyDevice(mDevice, nullptr);
 
-        vke::vk::vkDestroyDebugUtilsMessengerEXT(mInstance, mMessenger, nullptr);
+        if (mMessenger) {
+            vkDestroyDebugUtilsMessengerEXT(mInstance, mMessenger, nullptr);
+            mMessenger = VK_NULL_HANDLE;
+        }
         vkDestroyInstance(mInstance, nullptr);
 
         SDL_DestroyWindow(mWindow);
         mWindow = nullptr;
+
+        // whatever cleanup reported is on screen before run() returns
+        log::flush();
     }
 
     EngineResult<void> VkEngineApp::createWindow(int width, int height, const char *title) {
-        mWindow = SDL_CreateWindow(title, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, width, height, SDL_WINDOW_VULKAN);
+        VKE_TRACE_SCOPE("VkEngineApp::createWindow");
+
+        Uint32 flags = SDL_WINDOW_VULKAN | SDL_WINDOW_RESIZABLE;
+        if (mWindowHidden) {
+            flags |= SDL_WINDOW_HIDDEN;
+        }
+
+        mWindow = SDL_CreateWindow(title, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, width, height, flags);
 
         if (!mWindow) {
             return EngineError::fromSdlError(SDL_GetError());
@@ -140,6 +277,10 @@ namespace vke {
     }
 
     EngineResult<void> VkEngineApp::createInstance(const char* name) {
+        VKE_TRACE_SCOPE("VkEngineApp::createInstance");
+
+        vk::loadGlobal();
+
         VkApplicationInfo appInfo{};
         appInfo.sType = VK_STRUCTURE_TYPE_APPLICATION_INFO;
         appInfo.pApplicationName = name;
@@ -152,9 +293,33 @@ namespace vke {
         if (!extsResults)
             return extsResults;
 
-        std::vector<const char*> extensions = extsResults.getOk();
-        std::vector<const char*> layers{"VK_LAYER_KHRONOS_validation"};
-        extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+        std::vector<const char*> extensions = std::move(extsResults).getOk();
+        std::vector<const char*> layers;
+
+        // release runs without any layer, every other profile validates and differs in what the layer checks on top
+        bool validation = mProfile != Profile::RELEASE;
+        if (validation) {
+            layers.push_back("VK_LAYER_KHRONOS_validation");
+            extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+        }
+
+        std::vector<VkValidationFeatureEnableEXT> validationFeatures;
+        switch (mProfile) {
+            case Profile::GPU_ASSISTED:
+                validationFeatures.push_back(VK_VALIDATION_FEATURE_ENABLE_GPU_ASSISTED_EXT);
+                validationFeatures.push_back(VK_VALIDATION_FEATURE_ENABLE_GPU_ASSISTED_RESERVE_BINDING_SLOT_EXT);
+                break;
+            case Profile::BEST_PRACTICES:
+                validationFeatures.push_back(VK_VALIDATION_FEATURE_ENABLE_BEST_PRACTICES_EXT);
+                break;
+            case Profile::RELEASE:
+            case Profile::DEBUG:
+                break;
+        }
+
+        if (!validationFeatures.empty()) {
+            extensions.push_back(VK_EXT_VALIDATION_FEATURES_EXTENSION_NAME);
+        }
 
         TRY(checkExtensionsPresence(layers, extensions));
 
@@ -166,21 +331,47 @@ namespace vke {
         createInfo.enabledExtensionCount = extensions.size();
         createInfo.ppEnabledExtensionNames = extensions.data();
 
+        // layer only builds messages of severities the log would keep, everything below is never even formatted
+        VkDebugUtilsMessageSeverityFlagsEXT severities = VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+        for (log::Category category : { log::Category::VULKAN, log::Category::VALIDATION, log::Category::PERFORMANCE }) {
+            if (log::isEnabled(log::Level::INFO, category))
+                severities |= VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT;
+            if (log::isEnabled(log::Level::DEBUG, category))
+                severities |= VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT;
+        }
+
         VkDebugUtilsMessengerCreateInfoEXT debugMessengerCreateInfo{};
         debugMessengerCreateInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_MESSENGER_CREATE_INFO_EXT;
-        debugMessengerCreateInfo.messageSeverity = VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT;
+        debugMessengerCreateInfo.messageSeverity = severities;
         debugMessengerCreateInfo.messageType = VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT | VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT;
         debugMessengerCreateInfo.pfnUserCallback = onVulkanDebugMessage;
         debugMessengerCreateInfo.pUserData = nullptr;
 
-        createInfo.pNext = &debugMessengerCreateInfo;
+        VkValidationFeaturesEXT validationFeaturesInfo{};
+        validationFeaturesInfo.sType = VK_STRUCTURE_TYPE_VALIDATION_FEATURES_EXT;
+        validationFeaturesInfo.enabledValidationFeatureCount = validationFeatures.size();
+        validationFeaturesInfo.pEnabledValidationFeatures = validationFeatures.data();
+
+        if (validation) {
+            // messenger in the chain also covers instance creation and destruction
+            createInfo.pNext = &debugMessengerCreateInfo;
+            if (!validationFeatures.empty()) {
+                debugMessengerCreateInfo.pNext = &validationFeaturesInfo;
+            }
+        }
 
         if (VkResult result = vkCreateInstance(&createInfo, nullptr, &mInstance)) {
             return EngineError::fromVkError(result);
         }
 
-        if (VkResult result = vke::vk::vkCreateDebugUtilsMessengerEXT(mInstance, &debugMessengerCreateInfo, nullptr, &mMessenger)) {
-            return EngineError::fromVkError(result);
+        vk::loadInstance(mInstance);
+
+        if (validation) {
+            // chained structures are only for instance creation
+            debugMessengerCreateInfo.pNext = nullptr;
+            if (VkResult result = vkCreateDebugUtilsMessengerEXT(mInstance, &debugMessengerCreateInfo, nullptr, &mMessenger)) {
+                return EngineError::fromVkError(result);
+            }
         }
 
         return {};
@@ -269,43 +460,50 @@ namespace vke {
     }
 
     VKAPI_ATTR VkBool32 VKAPI_CALL VkEngineApp::onVulkanDebugMessage(VkDebugUtilsMessageSeverityFlagBitsEXT severity, VkDebugUtilsMessageTypeFlagsEXT type, const VkDebugUtilsMessengerCallbackDataEXT* message, void* data) {
-        if (severity < VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT)
-            return VK_FALSE;
-
-        std::cout << "[ENGINE] ";
-
+        log::Level level = log::Level::DEBUG;
         switch (severity) {
             case VK_DEBUG_UTILS_MESSAGE_SEVERITY_VERBOSE_BIT_EXT:
-                std::cout << "[DEBUG]: ";
+                level = log::Level::DEBUG;
                 break;
             case VK_DEBUG_UTILS_MESSAGE_SEVERITY_INFO_BIT_EXT:
-                std::cout << "[INFO]: ";
+                level = log::Level::INFO;
                 break;
             case VK_DEBUG_UTILS_MESSAGE_SEVERITY_WARNING_BIT_EXT:
-                std::cout << "[WARN]: ";
+                level = log::Level::WARN;
                 break;
             case VK_DEBUG_UTILS_MESSAGE_SEVERITY_ERROR_BIT_EXT:
-                std::cout << "[ERROR]: ";
+                level = log::Level::ERROR;
                 break;
         }
 
-        if (type & VK_DEBUG_UTILS_MESSAGE_TYPE_GENERAL_BIT_EXT) {
-            std::cout << "[Vulkan/General] ";
-        }
-
+        log::Category category = log::Category::VULKAN;
         if (type & VK_DEBUG_UTILS_MESSAGE_TYPE_VALIDATION_BIT_EXT) {
-            std::cout << "[Vulkan/Validation] ";
+            category = log::Category::VALIDATION;
+        } else if (type & VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT) {
+            category = log::Category::PERFORMANCE;
         }
 
-        if (type & VK_DEBUG_UTILS_MESSAGE_TYPE_PERFORMANCE_BIT_EXT) {
-            std::cout << "[Vulkan/Performance] ";
+        if (!log::isEnabled(level, category))
+            return VK_FALSE;
+
+        // the same message repeated every draw or every frame would flood the log and the writer
+        uint64_t key = message->messageIdNumber != 0 ? static_cast<uint32_t>(message->messageIdNumber) : std::hash<std::string_view>{}(message->pMessage);
+        uint64_t suppressed;
+        if (!log::throttle(key, DEBUG_MESSAGE_REPEAT_LIMIT, suppressed))
+            return VK_FALSE;
+
+        if (suppressed > 0) {
+            log::write(level, category, message->pMessage, " (repeated ", suppressed, " more times)");
+        } else {
+            log::write(level, category, message->pMessage);
         }
 
-        std::cout << message->pMessage << '\n';
         return VK_FALSE;
     }
 
     EngineResult<void> VkEngineApp::findPhysicalDevice() {
+        VKE_TRACE_SCOPE("VkEngineApp::findPhysicalDevice");
+
         uint32_t count = 0;
         if (VkResult result = vkEnumeratePhysicalDevices(mInstance, &count, nullptr)) {
             return EngineError::fromVkError(result);
@@ -340,7 +538,9 @@ namespace vke {
 
         VkPhysicalDeviceProperties properties;
         vkGetPhysicalDeviceProperties(mPhysicalDevice, &properties);
-        std::cout << "[ENGINE] [DEBUG]: Found physical graphics device " << properties.deviceName << '\n';
+        mMaxPushConstantsSize = properties.limits.maxPushConstantsSize;
+        mNonCoherentAtomSize = properties.limits.nonCoherentAtomSize;
+        log::debug(log::Category::ENGINE, "Found physical graphics device ", properties.deviceName);
 
         return {};
     }
@@ -351,7 +551,7 @@ namespace vke {
         }
 
         if (auto exts = getDeviceExtensions()) {
-            auto extensions = exts.getOk();
+            auto extensions = std::move(exts).getOk();
 
             if (!(checkDeviceExtensionsPresence(device, nullptr, extensions) && extensions.empty()))
                 return 0;
@@ -368,6 +568,8 @@ namespace vke {
     }
 
     EngineResult<void> VkEngineApp::createDevice() {
+        VKE_TRACE_SCOPE("VkEngineApp::createDevice");
+
         QueueFamilyIndexes indexes = QueueFamilyIndexes::query(mPhysicalDevice, mSurface);
 
         float priority = 1.0f;
@@ -387,13 +589,59 @@ namespace vke {
             queueCreateInfos[1].queueCount = 1;
         }
 
+        // compute only family never holds the graphics queue, it can still be the present one
+        bool asyncCompute = mAsyncComputeRequested && indexes.hasAsyncCompute();
+        mAsyncComputeFamily = asyncCompute ? indexes.getAsyncCompute() : indexes.getGraphics();
+        if (asyncCompute && !(queueCount > 1 && indexes.getPresent() == mAsyncComputeFamily)) {
+            VkDeviceQueueCreateInfo computeCreateInfo{};
+            computeCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+            computeCreateInfo.pQueuePriorities = &priority;
+            computeCreateInfo.queueFamilyIndex = mAsyncComputeFamily;
+            computeCreateInfo.queueCount = 1;
+            queueCreateInfos.push_back(computeCreateInfo);
+        }
+
         std::vector<const char*> extensions;
-        TRY(getDeviceExtensions()) extensions = result.getOk();
+        TRY(getDeviceExtensions()) extensions = std::move(result).getOk();
+
+        VkPhysicalDeviceVulkan12Features supported12{};
+        supported12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_12_FEATURES;
+
+        VkPhysicalDeviceFeatures2 supported{};
+        supported.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        supported.pNext = &supported12;
+        vkGetPhysicalDeviceFeatures2(mPhysicalDevice, &supported);
+
+        // GPU driven draws need all three, enable them together only when everything is there
+        mSupportsIndirectCount = supported12.drawIndirectCount && supported.features.multiDrawIndirect && supported.features.drawIndirectFirstInstance;
 
         VkPhysicalDeviceFeatures features{};
+        features.multiDrawIndirect = mSupportsIndirectCount;
+        features.drawIndirectFirstInstance = mSupportsIndirectCount;
+        // whatever compressed formats the device has, so textures can stay compressed in memory
+        features.textureCompressionBC = supported.features.textureCompressionBC;
+        features.textureCompressionETC2 = supported.features.textureCompressionETC2;
+        features.textureCompressionASTC_LDR = supported.features.textureCompressionASTC_LDR;
+        // GPU assisted validation instruments shaders with buffer stores and atomics, layer warns and checks less without them
+        if (mProfile == Profile::GPU_ASSISTED) {
+            features.vertexPipelineStoresAndAtomics = supported.features.vertexPipelineStoresAndAtomics;
+            features.fragmentStoresAndAtomics = supported.features.fragmentStoresAndAtomics;
+        }
+
+        VkPhysicalDeviceVulkan12Features features12{};
+        features12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_12_FEATURES;
+        features12.drawIndirectCount = mSupportsIndirectCount;
+
+        // both are core and mandatory in 1.3, so there is no need to query for them
+        VkPhysicalDeviceVulkan13Features features13{};
+        features13.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_13_FEATURES;
+        features13.pNext = &features12;
+        features13.synchronization2 = VK_TRUE;
+        features13.dynamicRendering = VK_TRUE;
 
         VkDeviceCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+        createInfo.pNext = &features13;
         createInfo.pQueueCreateInfos = queueCreateInfos.data();
         createInfo.queueCreateInfoCount = queueCreateInfos.size();
         createInfo.pEnabledFeatures = &features;
@@ -405,6 +653,9 @@ namespace vke {
             return EngineError::fromVkError(result);
         }
 
+        // device functions now skip the loader's dispatch
+        vk::loadDevice(mDevice);
+
         vkGetDeviceQueue(mDevice, indexes.getGraphics(), 0, &mGraphicsQueue);
 
         if (queueCount > 1) {
@@ -413,10 +664,16 @@ namespace vke {
             mPresentQueue = mGraphicsQueue;
         }
 
+        if (asyncCompute) {
+            vkGetDeviceQueue(mDevice, mAsyncComputeFamily, 0, &mAsyncComputeQueue);
+        }
+
         return {};
     }
 
     EngineResult<void> VkEngineApp::createSurface() {
+        VKE_TRACE_SCOPE("VkEngineApp::createSurface");
+
         if (!SDL_Vulkan_CreateSurface(mWindow, mInstance, &mSurface)) {
             return EngineError::fromSdlError(SDL_GetError());
         }
@@ -429,6 +686,8 @@ namespace vke {
     }
 
     EngineResult<void> VkEngineApp::createSwapchain() {
+        VKE_TRACE_SCOPE("VkEngineApp::createSwapchain");
+
         if (auto details = SwapchainDetails::query(mPhysicalDevice, mSurface)) {
             VkSurfaceFormatKHR format = details->chooseFormat();
             VkPresentModeKHR mode = details->chooseMode();
@@ -450,7 +709,8 @@ namespace vke {
             createInfo.imageColorSpace = format.colorSpace;
             createInfo.imageArrayLayers = 1;
             createInfo.imageExtent = extent;
-            createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+            // copying out is only needed for captures, so only ask for it where it comes for free
+            createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | (details->getSupportedUsage() & VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
 
             uint32_t queueFamilyIndexes[2] = { indexes.getGraphics(), indexes.getPresent() };
             if (indexes.getGraphics() == indexes.getPresent()) {
@@ -474,6 +734,7 @@ namespace vke {
 
             mSwapchainExtent = extent;
             mSwapchainImageFormat = format.format;
+            mSwapchainUsage = createInfo.imageUsage;
 
             uint32_t imageCount;
             if (VkResult result = vkGetSwapchainImagesKHR(mDevice, mSwapchain, &imageCount, nullptr)) {
@@ -491,7 +752,58 @@ namespace vke {
         }
     }
 
+    EngineResult<void> VkEngineApp::recreateSwapchain() {
+        VKE_TRACE_SCOPE("VkEngineApp::recreateSwapchain");
+
+        int width;
+        int height;
+        SDL_GetWindowSize(mWindow, &width, &height);
+
+        // minimized window has no surface area to render into, keep the swapchain outdated until it comes back
+        if (width == 0 || height == 0) {
+            return {};
+        }
+
+        vkDeviceWaitIdle(mDevice);
+        destroySwapchain();
+        destroyDepthResources();
+
+        TRY(createSwapchain());
+        TRY(createImageViews());
+        TRY(createDepthResources());
+
+        // dynamic rendering has no framebuffer objects that would depend on swapchain images,
+        // but transient images of its frame graph follow swapchain extent
+        if (mRenderPath == RenderPath::RENDER_PASS) {
+            TRY(createFramebuffers());
+        } else {
+            TRY(createRenderGraph());
+        }
+
+        mSwapchainOutdated = false;
+
+        return {};
+    }
+
+    void VkEngineApp::destroySwapchain() {
+        for (const VkFramebuffer& framebuffer : mFramebuffers) {
+            vkDestroyFramebuffer(mDevice, framebuffer, nullptr);
+        }
+        mFramebuffers.clear();
+
+        for (const VkImageView& view : mSwapchainImageViews) {
+            vkDestroyImageView(mDevice, view, nullptr);
+        }
+        mSwapchainImageViews.clear();
+
+        vkDestroySwapchainKHR(mDevice, mSwapchain, nullptr);
+        mSwapchain = VK_NULL_HANDLE;
+        mSwapchainImages.clear();
+    }
+
     EngineResult<void> VkEngineApp::createImageViews() {
+        VKE_TRACE_SCOPE("VkEngineApp::createImageViews");
+
         mSwapchainImageViews.resize(mSwapchainImages.size());
 
         for (size_t i = 0, size = mSwapchainImages.size(); i < size; i++) {
@@ -518,7 +830,106 @@ namespace vke {
         return {};
     }
 
+    EngineResult<void> VkEngineApp::chooseDepthFormat() {
+        VKE_TRACE_SCOPE("VkEngineApp::chooseDepthFormat");
+
+        // ordered by preference, D32 gives best precision and only formats without stencil are considered
+        VkFormat candidates[] = { VK_FORMAT_D32_SFLOAT, VK_FORMAT_X8_D24_UNORM_PACK32, VK_FORMAT_D16_UNORM };
+
+        for (VkFormat format : candidates) {
+            VkFormatProperties properties;
+            vkGetPhysicalDeviceFormatProperties(mPhysicalDevice, format, &properties);
+
+            if (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) {
+                mDepthFormat = format;
+                return {};
+            }
+        }
+
+        return EngineError::fromVkError(VK_ERROR_FORMAT_NOT_SUPPORTED);
+    }
+
+    EngineResult<void> VkEngineApp::createDepthResources() {
+        VKE_TRACE_SCOPE("VkEngineApp::createDepthResources");
+
+        VkImageCreateInfo imageCreateInfo{};
+        imageCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageCreateInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageCreateInfo.format = mDepthFormat;
+        imageCreateInfo.extent.width = mSwapchainExtent.width;
+        imageCreateInfo.extent.height = mSwapchainExtent.height;
+        imageCreateInfo.extent.depth = 1;
+        imageCreateInfo.mipLevels = 1;
+        imageCreateInfo.arrayLayers = 1;
+        imageCreateInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageCreateInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        // depth is never stored, so on tilers it can live in tile memory only
+        imageCreateInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+        imageCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageCreateInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        if (VkResult result = vkCreateImage(mDevice, &imageCreateInfo, nullptr, &mDepthImage)) {
+            return EngineError::fromVkError(result);
+        }
+
+        VkMemoryRequirements requirements;
+        vkGetImageMemoryRequirements(mDevice, mDepthImage, &requirements);
+
+        uint32_t typeIndex;
+        if (mLazyMemType.isValid() && (requirements.memoryTypeBits >> mLazyMemType.getTypeIndex()) & 1) {
+            typeIndex = mLazyMemType.getTypeIndex();
+        } else if (mSpeedyMemType.isValid() && (requirements.memoryTypeBits >> mSpeedyMemType.getTypeIndex()) & 1) {
+            typeIndex = mSpeedyMemType.getTypeIndex();
+        } else {
+            // fall back to lowest type the image accepts
+            typeIndex = std::countr_zero(requirements.memoryTypeBits);
+        }
+
+        VkMemoryAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.allocationSize = requirements.size;
+        allocateInfo.memoryTypeIndex = typeIndex;
+
+        if (VkResult result = vkAllocateMemory(mDevice, &allocateInfo, nullptr, &mDepthImageMemory)) {
+            return EngineError::fromVkError(result);
+        }
+
+        if (VkResult result = vkBindImageMemory(mDevice, mDepthImage, mDepthImageMemory, 0)) {
+            return EngineError::fromVkError(result);
+        }
+
+        VkImageViewCreateInfo viewCreateInfo{};
+        viewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewCreateInfo.image = mDepthImage;
+        viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewCreateInfo.format = mDepthFormat;
+        viewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+        viewCreateInfo.subresourceRange.baseMipLevel = 0;
+        viewCreateInfo.subresourceRange.levelCount = 1;
+        viewCreateInfo.subresourceRange.baseArrayLayer = 0;
+        viewCreateInfo.subresourceRange.layerCount = 1;
+
+        if (VkResult result = vkCreateImageView(mDevice, &viewCreateInfo, nullptr, &mDepthImageView)) {
+            return EngineError::fromVkError(result);
+        }
+
+        return {};
+    }
+
+    void VkEngineApp::destroyDepthResources() {
+        vkDestroyImageView(mDevice, mDepthImageView, nullptr);
+        mDepthImageView = VK_NULL_HANDLE;
+
+        vkDestroyImage(mDevice, mDepthImage, nullptr);
+        mDepthImage = VK_NULL_HANDLE;
+
+        vkFreeMemory(mDevice, mDepthImageMemory, nullptr);
+        mDepthImageMemory = VK_NULL_HANDLE;
+    }
+
     EngineResult<void> VkEngineApp::createRenderPass() {
+        VKE_TRACE_SCOPE("VkEngineApp::createRenderPass");
+
         VkAttachmentDescription colorAttachment{};
         colorAttachment.format = mSwapchainImageFormat;
         colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
@@ -529,23 +940,51 @@ namespace vke {
         colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
         colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
+        VkAttachmentDescription depthAttachment{};
+        depthAttachment.format = mDepthFormat;
+        depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+        depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
         VkAttachmentReference colorAttachmentRef{};
         colorAttachmentRef.attachment = 0;
         colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
+        VkAttachmentReference depthAttachmentRef{};
+        depthAttachmentRef.attachment = 1;
+        depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
         VkSubpassDescription subpass{};
         subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
         subpass.inputAttachmentCount = 0;
         subpass.pInputAttachments = nullptr;
         subpass.colorAttachmentCount = 1;
         subpass.pColorAttachments = &colorAttachmentRef;
+        subpass.pDepthStencilAttachment = &depthAttachmentRef;
+
+        // single depth image is shared by all frames in flight, previous frame must be done with it before clear
+        VkSubpassDependency dependency{};
+        dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
+        dependency.dstSubpass = 0;
+        dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        dependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+        dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+        VkAttachmentDescription attachments[] = { colorAttachment, depthAttachment };
 
         VkRenderPassCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-        createInfo.pAttachments = &colorAttachment;
-        createInfo.attachmentCount = 1;
+        createInfo.pAttachments = attachments;
+        createInfo.attachmentCount = 2;
         createInfo.subpassCount = 1;
         createInfo.pSubpasses = &subpass;
+        createInfo.dependencyCount = 1;
+        createInfo.pDependencies = &dependency;
 
         if (VkResult result = vkCreateRenderPass(mDevice, &createInfo, nullptr, &mRenderPass)) {
             return EngineError::fromVkError(result);
@@ -555,6 +994,8 @@ namespace vke {
     }
 
     EngineResult<void> VkEngineApp::createShaderModules() {
+        VKE_TRACE_SCOPE("VkEngineApp::createShaderModules");
+
         if (auto shaders = loadShaders()) {
             if (!shaders->contains(VK_SHADER_STAGE_VERTEX_BIT)) {
                 return EngineError::missingVertexShader();
@@ -580,7 +1021,26 @@ namespace vke {
         return {};
     }
 
+    EngineResult<void> VkEngineApp::createDescriptors() {
+        VKE_TRACE_SCOPE("VkEngineApp::createDescriptors");
+
+        mDescriptorLayoutCache.init(mDevice);
+        mDescriptorAllocator.init(mDevice, MAX_CONCURRENT_FRAMES);
+
+        for (const std::vector<VkDescriptorSetLayoutBinding>& bindings : mPipelineDescription.descriptorSets) {
+            if (auto layout = mDescriptorLayoutCache.getLayout(bindings)) {
+                mDescriptorSetLayouts.push_back(layout.getOk());
+            } else {
+                return layout;
+            }
+        }
+
+        return {};
+    }
+
     EngineResult<void> VkEngineApp::createPipeline() {
+        VKE_TRACE_SCOPE("VkEngineApp::createPipeline");
+
         std::vector<VkPipelineShaderStageCreateInfo> stages{mShaderModules.size()};
 
 
@@ -594,33 +1054,37 @@ namespace vke {
             i++;
         }
 
-        VkVertexInputBindingDescription vertexInputBinding{};
-        vertexInputBinding.binding = 0;
-        vertexInputBinding.stride = sizeof(float) * 6;
-        vertexInputBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-
-        VkVertexInputAttributeDescription vertexPositionAttribute{};
-        vertexPositionAttribute.location = 0;
-        vertexPositionAttribute.binding = 0;
-        vertexPositionAttribute.format = VK_FORMAT_R32G32B32_SFLOAT;
-        vertexPositionAttribute.offset = 0;
-
-        VkVertexInputAttributeDescription vertexColorAttribute{};
-        vertexColorAttribute.location = 1;
-        vertexColorAttribute.binding = 0;
-        vertexColorAttribute.format = VK_FORMAT_R32G32B32_SFLOAT;
-        vertexColorAttribute.offset = sizeof(float) * 3;
-
-        VkVertexInputAttributeDescription attributeDescriptions[] = {
-                vertexPositionAttribute, vertexColorAttribute
-        };
+        std::vector<VkVertexInputBindingDescription> bindingDescriptions = mPipelineDescription.vertexBindings;
+        std::vector<VkVertexInputAttributeDescription> attributeDescriptions = mPipelineDescription.vertexAttributes;
+
+        if (bindingDescriptions.empty()) {
+            VkVertexInputBindingDescription vertexInputBinding{};
+            vertexInputBinding.binding = PipelineDescription::VERTEX_BINDING;
+            vertexInputBinding.stride = sizeof(float) * 6;
+            vertexInputBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+            bindingDescriptions.push_back(vertexInputBinding);
+
+            VkVertexInputAttributeDescription vertexPositionAttribute{};
+            vertexPositionAttribute.location = 0;
+            vertexPositionAttribute.binding = PipelineDescription::VERTEX_BINDING;
+            vertexPositionAttribute.format = VK_FORMAT_R32G32B32_SFLOAT;
+            vertexPositionAttribute.offset = 0;
+            attributeDescriptions.push_back(vertexPositionAttribute);
+
+            VkVertexInputAttributeDescription vertexColorAttribute{};
+            vertexColorAttribute.location = 1;
+            vertexColorAttribute.binding = PipelineDescription::VERTEX_BINDING;
+            vertexColorAttribute.format = VK_FORMAT_R32G32B32_SFLOAT;
+            vertexColorAttribute.offset = sizeof(float) * 3;
+            attributeDescriptions.push_back(vertexColorAttribute);
+        }
 
         VkPipelineVertexInputStateCreateInfo vertexInput{};
         vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-        vertexInput.vertexBindingDescriptionCount = 1;
-        vertexInput.pVertexBindingDescriptions = &vertexInputBinding;
-        vertexInput.vertexAttributeDescriptionCount = 2;
-        vertexInput.pVertexAttributeDescriptions = attributeDescriptions;
+        vertexInput.vertexBindingDescriptionCount = bindingDescriptions.size();
+        vertexInput.pVertexBindingDescriptions = bindingDescriptions.data();
+        vertexInput.vertexAttributeDescriptionCount = attributeDescriptions.size();
+        vertexInput.pVertexAttributeDescriptions = attributeDescriptions.data();
 
         VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
         inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
@@ -665,6 +1129,16 @@ namespace vke {
         multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
         multisampling.sampleShadingEnable = VK_FALSE;
 
+        VkPipelineDepthStencilStateCreateInfo depthStencil{};
+        depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+        depthStencil.depthTestEnable = VK_TRUE;
+        depthStencil.depthWriteEnable = VK_TRUE;
+        depthStencil.depthCompareOp = VK_COMPARE_OP_LESS;
+        depthStencil.depthBoundsTestEnable = VK_FALSE;
+        depthStencil.stencilTestEnable = VK_FALSE;
+        depthStencil.minDepthBounds = 0.0f;
+        depthStencil.maxDepthBounds = 1.0f;
+
         VkPipelineColorBlendAttachmentState colorBlendAttachment{};
         colorBlendAttachment.blendEnable = VK_FALSE;
         colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_ONE;
@@ -688,19 +1162,33 @@ namespace vke {
         dynamicState.dynamicStateCount = 2;
         dynamicState.pDynamicStates = dynamicStates;
 
+        for (const VkPushConstantRange& range : mPipelineDescription.pushConstantRanges) {
+            if (range.offset + range.size > mMaxPushConstantsSize) {
+                return EngineError::pushConstantsTooLarge();
+            }
+        }
+
         VkPipelineLayoutCreateInfo layoutCreateInfo{};
         layoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-        layoutCreateInfo.setLayoutCount = 0;
-        layoutCreateInfo.pSetLayouts = nullptr;
-        layoutCreateInfo.pushConstantRangeCount = 0;
-        layoutCreateInfo.pPushConstantRanges = nullptr;
+        layoutCreateInfo.setLayoutCount = mDescriptorSetLayouts.size();
+        layoutCreateInfo.pSetLayouts = mDescriptorSetLayouts.data();
+        layoutCreateInfo.pushConstantRangeCount = mPipelineDescription.pushConstantRanges.size();
+        layoutCreateInfo.pPushConstantRanges = mPipelineDescription.pushConstantRanges.data();
 
         if (VkResult result = vkCreatePipelineLayout(mDevice, &layoutCreateInfo, nullptr, &mPipelineLayout)) {
             return EngineError::fromVkError(result);
         }
 
+        VkPipelineRenderingCreateInfo renderingCreateInfo{};
+        renderingCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO;
+        renderingCreateInfo.colorAttachmentCount = 1;
+        renderingCreateInfo.pColorAttachmentFormats = &mSwapchainImageFormat;
+        renderingCreateInfo.depthAttachmentFormat = mDepthFormat;
+        renderingCreateInfo.stencilAttachmentFormat = VK_FORMAT_UNDEFINED;
+
         VkGraphicsPipelineCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        createInfo.pNext = mRenderPath == RenderPath::DYNAMIC_RENDERING ? &renderingCreateInfo : nullptr;
         createInfo.stageCount = stages.size();
         createInfo.pStages = stages.data();
         createInfo.pVertexInputState = &vertexInput;
@@ -709,7 +1197,7 @@ namespace vke {
         createInfo.pViewportState = &viewportState;
         createInfo.pRasterizationState = &rasterizer;
         createInfo.pMultisampleState = &multisampling;
-        createInfo.pDepthStencilState = nullptr;
+        createInfo.pDepthStencilState = &depthStencil;
         createInfo.pColorBlendState = &colorBlend;
         createInfo.pDynamicState = &dynamicState;
         createInfo.layout = mPipelineLayout;
@@ -726,14 +1214,18 @@ namespace vke {
     }
 
     EngineResult<void> VkEngineApp::createFramebuffers() {
+        VKE_TRACE_SCOPE("VkEngineApp::createFramebuffers");
+
         mFramebuffers.resize(mSwapchainImageViews.size());
 
         for (size_t i = 0, size = mSwapchainImageViews.size(); i < size; i++) {
             VkFramebufferCreateInfo createInfo{};
             createInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
             createInfo.renderPass = mRenderPass;
-            createInfo.attachmentCount = 1;
-            createInfo.pAttachments = &mSwapchainImageViews[i];
+            VkImageView attachments[] = { mSwapchainImageViews[i], mDepthImageView };
+
+            createInfo.attachmentCount = 2;
+            createInfo.pAttachments = attachments;
             createInfo.width = mSwapchainExtent.width;
             createInfo.height = mSwapchainExtent.height;
             createInfo.layers = 1;
@@ -747,6 +1239,8 @@ namespace vke {
     }
 
     EngineResult<void> VkEngineApp::createCommandPool() {
+        VKE_TRACE_SCOPE("VkEngineApp::createCommandPool");
+
         VkCommandPoolCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
         createInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
@@ -760,6 +1254,8 @@ namespace vke {
     }
 
     EngineResult<void> VkEngineApp::createCommandBuffers() {
+        VKE_TRACE_SCOPE("VkEngineApp::createCommandBuffers");
+
         size_t size = MAX_CONCURRENT_FRAMES;
         mCommandBuffers.resize(size);
 
@@ -777,105 +1273,189 @@ namespace vke {
     }
 
     EngineResult<void> VkEngineApp::renderFrame() {
+        VKE_TRACE_SCOPE("VkEngineApp::renderFrame");
+
+        if (mSwapchainOutdated) {
+            TRY(recreateSwapchain());
+
+            // still outdated, window is minimized
+            if (mSwapchainOutdated) {
+                return {};
+            }
+        }
+
         VkFence frameAvailableFence = mFrameFences[mCurrentFrame];
 
         // FENCE: wait for queue to finish
-        if (VkResult result = vkWaitForFences(mDevice, 1, &frameAvailableFence, VK_TRUE, UINT64_MAX)) {
-            return EngineError::fromVkError(result);
+        {
+            VKE_TRACE_SCOPE("Fence wait");
+            if (VkResult result = vkWaitForFences(mDevice, 1, &frameAvailableFence, VK_TRUE, UINT64_MAX)) {
+                return EngineError::fromVkError(result);
+            }
         }
 
-        // FENCE: reset, we are processing this frame
-        if (VkResult result = vkResetFences(mDevice, 1, &frameAvailableFence)) {
-            return EngineError::fromVkError(result);
-        }
+        // frame is no longer in flight, its descriptor sets can be recycled in bulk
+        TRY(mDescriptorAllocator.resetFrame(mCurrentFrame));
 
         VkSemaphore imageAvailableSemaphore = mFrameSemaphores[mCurrentFrame * 2];
         VkSemaphore frameRenderedSemaphore = mFrameSemaphores[(mCurrentFrame * 2) + 1];
 
         // acquire next swapchain image
         uint32_t imageIndex;
-        if (VkResult result = vkAcquireNextImageKHR(mDevice, mSwapchain, UINT32_MAX, imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex)) {
-            return EngineError::fromVkError(result);
+        VkResult acquireResult;
+        {
+            VKE_TRACE_SCOPE("Acquire");
+            acquireResult = vkAcquireNextImageKHR(mDevice, mSwapchain, UINT64_MAX, imageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex);
         }
-
-        VkCommandBuffer cmdBuffer = mCommandBuffers[mCurrentFrame];
-        // reset buffer
-        if (VkResult result = vkResetCommandBuffer(cmdBuffer, 0)) {
-            return EngineError::fromVkError(result);
+        if (acquireResult == VK_ERROR_OUT_OF_DATE_KHR) {
+            mSwapchainOutdated = true;
+            return {};
+        } else if (acquireResult != VK_SUCCESS && acquireResult != VK_SUBOPTIMAL_KHR) {
+            return EngineError::fromVkError(acquireResult);
         }
 
-        // begin command buffer
-        VkCommandBufferBeginInfo beginInfo{};
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        beginInfo.pInheritanceInfo = nullptr;
-        if (VkResult result = vkBeginCommandBuffer(cmdBuffer, &beginInfo)) {
+        // FENCE: reset, we are processing this frame
+        // (only after acquire succeeded, otherwise next wait on it would never return)
+        if (VkResult result = vkResetFences(mDevice, 1, &frameAvailableFence)) {
             return EngineError::fromVkError(result);
         }
 
-        // setup dynamic state
-        VkViewport viewport{};
-        viewport.x = 0;
-        viewport.y = 0;
-        viewport.width = static_cast<float>(mSwapchainExtent.width);
-        viewport.height = static_cast<float>(mSwapchainExtent.height);
-        viewport.minDepth = 0.0f;
-        viewport.maxDepth = 1.0f;
-        vkCmdSetViewport(cmdBuffer, 0, 1, &viewport);
-        VkRect2D scissors{};
-        scissors.offset.x = 0;
-        scissors.offset.y = 0;
-        scissors.extent = mSwapchainExtent;
-        vkCmdSetScissor(cmdBuffer, 0, 1, &scissors);
-        // bind pipeline
-        vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipeline);
-        // begin render pass
-        VkClearValue clearValue{};
-        clearValue.color.float32[0] = 0.0;
-        clearValue.color.float32[1] = 0.0;
-        clearValue.color.float32[2] = 0.0;
-        clearValue.color.float32[3] = 1.0;
-        VkRenderPassBeginInfo renderPassBeginInfo{};
-        renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-        renderPassBeginInfo.renderPass = mRenderPass;
-        renderPassBeginInfo.framebuffer = mFramebuffers[imageIndex];
-        renderPassBeginInfo.renderArea = scissors;
-        renderPassBeginInfo.clearValueCount = 1;
-        renderPassBeginInfo.pClearValues = &clearValue;
-        vkCmdBeginRenderPass(cmdBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
-        // render
-        render(cmdBuffer);
-        // end render pass
-        vkCmdEndRenderPass(cmdBuffer);
-        // end command buffer
-        vkEndCommandBuffer(cmdBuffer);
+        // kick off compute scheduled since last frame, it runs while graphics work below is recorded and executed
+        TRY(mAsyncCompute.submit(mCurrentFrame));
+
+        VkCommandBuffer cmdBuffer = mCommandBuffers[mCurrentFrame];
+        {
+            VKE_TRACE_SCOPE("Record");
+
+            // reset buffer
+            if (VkResult result = vkResetCommandBuffer(cmdBuffer, 0)) {
+                return EngineError::fromVkError(result);
+            }
+
+            // begin command buffer
+            VkCommandBufferBeginInfo beginInfo{};
+            beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            beginInfo.pInheritanceInfo = nullptr;
+            if (VkResult result = vkBeginCommandBuffer(cmdBuffer, &beginInfo)) {
+                return EngineError::fromVkError(result);
+            }
+
+#ifdef VKE_TRACING
+            // GPU scopes of this frame's previous use are done, its queries are reused from here on
+            mGpuTimeline.record(cmdBuffer, mCurrentFrame);
+#endif
+
+            // take ownership of compute results (or run compute inline without dedicated queue)
+            mAsyncCompute.acquire(cmdBuffer, mCurrentFrame);
+
+            // streamed meshes finished reading since last frame, this frame's fence guarantees its old staging is free
+            {
+                VKE_TRACE_GPU_SCOPE(cmdBuffer, "Uploads");
+                TRY(mAssetStreamer.record(cmdBuffer, mCurrentFrame));
+                recordUploads(cmdBuffer);
+                TRY(mTextureStreamer.record(cmdBuffer, mCurrentFrame));
+            }
+
+            // setup dynamic state
+            VkViewport viewport{};
+            viewport.x = 0;
+            viewport.y = 0;
+            viewport.width = static_cast<float>(mSwapchainExtent.width);
+            viewport.height = static_cast<float>(mSwapchainExtent.height);
+            viewport.minDepth = 0.0f;
+            viewport.maxDepth = 1.0f;
+            vkCmdSetViewport(cmdBuffer, 0, 1, &viewport);
+            VkRect2D scissors{};
+            scissors.offset.x = 0;
+            scissors.offset.y = 0;
+            scissors.extent = mSwapchainExtent;
+            vkCmdSetScissor(cmdBuffer, 0, 1, &scissors);
+            // cull on the GPU, has to happen before rendering starts
+            if (mGpuCulling.isEnabled()) {
+                VKE_TRACE_GPU_SCOPE(cmdBuffer, "Culling");
+                TRY(mGpuCulling.dispatch(cmdBuffer, mCurrentFrame));
+            }
+            switch (mRenderPath) {
+                case RenderPath::RENDER_PASS:
+                    // render pass takes care of attachment layouts itself
+                    beginRendering(cmdBuffer, mFramebuffers[imageIndex], VK_NULL_HANDLE, VK_NULL_HANDLE);
+                    TRY(recordScene(cmdBuffer));
+                    endRendering(cmdBuffer);
+                    break;
+                case RenderPath::DYNAMIC_RENDERING: {
+                    VKE_TRACE_GPU_SCOPE(cmdBuffer, "Render graph");
+                    // layout transitions and barriers between passes come from the frame graph
+                    mRenderGraph.setImage(mBackbuffer, mSwapchainImages[imageIndex], mSwapchainImageViews[imageIndex]);
+                    mRenderGraph.setImage(mDepth, mDepthImage, mDepthImageView);
+                    TRY(mRenderGraph.execute(cmdBuffer));
+                    break;
+                }
+            }
+            // both paths leave the swapchain image ready to present
+            TRY(mFrameCapture.record(cmdBuffer, mCurrentFrame, mSwapchainImages[imageIndex], VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, mSwapchainImageFormat, mSwapchainExtent));
+            // end command buffer
+            vkEndCommandBuffer(cmdBuffer);
+        }
         // submit command buffer (resets frame busy fence, signals queue busy semaphore)
         // SEMAPHORE: signal that frame is rendered, wait for swapchain image
         // FENCE: signals when queue processing finishes
-        VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-        VkSubmitInfo submitInfo{};
-        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-        submitInfo.waitSemaphoreCount = 1;
-        submitInfo.pWaitSemaphores = &imageAvailableSemaphore;
-        submitInfo.pWaitDstStageMask = waitStages;
-        submitInfo.commandBufferCount = 1;
-        submitInfo.pCommandBuffers = &cmdBuffer;
-        submitInfo.signalSemaphoreCount = 1;
-        submitInfo.pSignalSemaphores = &frameRenderedSemaphore;
-        if (VkResult result = vkQueueSubmit(mGraphicsQueue, 1, &submitInfo, frameAvailableFence)) {
-            return EngineError::fromVkError(result);
+        // SEMAPHORE: wait for async compute results where graphics first reads them
+        {
+            VKE_TRACE_SCOPE("Submit");
+
+            VkSemaphoreSubmitInfo waitInfos[2]{};
+            waitInfos[0].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+            waitInfos[0].semaphore = imageAvailableSemaphore;
+            waitInfos[0].stageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+            waitInfos[1].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+            waitInfos[1].semaphore = mAsyncCompute.getWaitSemaphore(mCurrentFrame);
+            waitInfos[1].stageMask = mAsyncCompute.getWaitStage(mCurrentFrame);
+
+            VkSemaphoreSubmitInfo signalInfo{};
+            signalInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO;
+            signalInfo.semaphore = frameRenderedSemaphore;
+            signalInfo.stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT;
+
+            VkCommandBufferSubmitInfo cmdBufferInfo{};
+            cmdBufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO;
+            cmdBufferInfo.commandBuffer = cmdBuffer;
+
+            VkSubmitInfo2 submitInfo{};
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2;
+            submitInfo.waitSemaphoreInfoCount = waitInfos[1].semaphore != VK_NULL_HANDLE ? 2 : 1;
+            submitInfo.pWaitSemaphoreInfos = waitInfos;
+            submitInfo.commandBufferInfoCount = 1;
+            submitInfo.pCommandBufferInfos = &cmdBufferInfo;
+            submitInfo.signalSemaphoreInfoCount = 1;
+            submitInfo.pSignalSemaphoreInfos = &signalInfo;
+#ifdef VKE_TRACING
+            // anchors GPU timestamps of this frame to the CPU clock
+            mGpuTimeline.submitted(mCurrentFrame);
+#endif
+            if (VkResult result = vkQueueSubmit2(mGraphicsQueue, 1, &submitInfo, frameAvailableFence)) {
+                return EngineError::fromVkError(result);
+            }
         }
 
         // SEMAPHORE: wait for queue to finish
         // preset
-        VkPresentInfoKHR presentInfo{};
-        presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-        presentInfo.waitSemaphoreCount = 1;
-        presentInfo.pWaitSemaphores = &frameRenderedSemaphore;
-        presentInfo.swapchainCount = 1;
-        presentInfo.pSwapchains = &mSwapchain;
-        presentInfo.pImageIndices = &imageIndex;
-        if (VkResult result = vkQueuePresentKHR(mPresentQueue, &presentInfo)) {
-            return EngineError::fromVkError(result);
+        VkResult presentResult;
+        {
+            VKE_TRACE_SCOPE("Present");
+
+            VkPresentInfoKHR presentInfo{};
+            presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
+            presentInfo.waitSemaphoreCount = 1;
+            presentInfo.pWaitSemaphores = &frameRenderedSemaphore;
+            presentInfo.swapchainCount = 1;
+            presentInfo.pSwapchains = &mSwapchain;
+            presentInfo.pImageIndices = &imageIndex;
+            presentResult = vkQueuePresentKHR(mPresentQueue, &presentInfo);
+        }
+        if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR) {
+            mSwapchainOutdated = true;
+        } else if (presentResult != VK_SUCCESS) {
+            return EngineError::fromVkError(presentResult);
         }
 
         mCurrentFrame = (mCurrentFrame + 1) % MAX_CONCURRENT_FRAMES;
@@ -883,7 +1463,186 @@ namespace vke {
         return {};
     }
 
+    EngineResult<void> VkEngineApp::flushInstances() {
+        uint64_t bytes = mInstanceBatcher.getRequiredBytes();
+        // instances added with a zero stride still have to go, or their counts pile up frame after frame
+        if (bytes == 0) {
+            mInstanceBatcher.clear();
+            return {};
+        }
+
+        if (mInstanceBuffers.empty()) {
+            mInstanceBuffers.resize(MAX_CONCURRENT_FRAMES);
+            mInstanceMappings.resize(MAX_CONCURRENT_FRAMES);
+            mInstanceBufferSizes.resize(MAX_CONCURRENT_FRAMES, 0);
+        }
+
+        // each frame in flight owns its buffer, so it can be rewritten as soon as that frame's fence signaled
+        if (mInstanceBufferSizes[mCurrentFrame] < bytes) {
+            uint64_t size = std::max(bytes, mInstanceBufferSizes[mCurrentFrame] * 2);
+
+            mInstanceMappings[mCurrentFrame] = Buffer::MappedScope{};
+            if (mInstanceBufferSizes[mCurrentFrame] > 0) {
+                destroyBuffer(mInstanceBuffers[mCurrentFrame]);
+            }
+
+            // rewritten by the host every frame, so host visible memory is read directly by the device
+            if (auto buffer = allocateBuffer(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, size, BufferType::STAGING)) {
+                mInstanceBuffers[mCurrentFrame] = std::move(buffer.getOk());
+            } else {
+                return buffer;
+            }
+
+            // stays mapped for the lifetime of the buffer
+            if (auto mapped = mInstanceBuffers[mCurrentFrame].map()) {
+                mInstanceMappings[mCurrentFrame] = std::move(mapped.getOk());
+            } else {
+                return mapped;
+            }
+
+            mInstanceBufferSizes[mCurrentFrame] = size;
+        }
+
+        mInstanceBatcher.flush(&mInstanceMappings[mCurrentFrame][0], mInstanceBuffers[mCurrentFrame].getHandle(), mOpaqueDraws);
+
+        return mInstanceMappings[mCurrentFrame].flush(0, bytes);
+    }
+
+    void VkEngineApp::beginRendering(VkCommandBuffer cmdBuffer, VkFramebuffer framebuffer, VkImageView colorView, VkImageView depthView) {
+        VkRect2D renderArea{};
+        renderArea.offset.x = 0;
+        renderArea.offset.y = 0;
+        renderArea.extent = mSwapchainExtent;
+
+        VkClearValue clearValues[2]{};
+        clearValues[0].color.float32[0] = 0.0;
+        clearValues[0].color.float32[1] = 0.0;
+        clearValues[0].color.float32[2] = 0.0;
+        clearValues[0].color.float32[3] = 1.0;
+        clearValues[1].depthStencil.depth = 1.0f;
+        clearValues[1].depthStencil.stencil = 0;
+
+        switch (mRenderPath) {
+            case RenderPath::RENDER_PASS: {
+                VkRenderPassBeginInfo renderPassBeginInfo{};
+                renderPassBeginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+                renderPassBeginInfo.renderPass = mRenderPass;
+                renderPassBeginInfo.framebuffer = framebuffer;
+                renderPassBeginInfo.renderArea = renderArea;
+                renderPassBeginInfo.clearValueCount = 2;
+                renderPassBeginInfo.pClearValues = clearValues;
+                vkCmdBeginRenderPass(cmdBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+                break;
+            }
+            case RenderPath::DYNAMIC_RENDERING: {
+                VkRenderingAttachmentInfo colorAttachment{};
+                colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+                colorAttachment.imageView = colorView;
+                colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+                colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+                colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+                colorAttachment.clearValue = clearValues[0];
+
+                VkRenderingAttachmentInfo depthAttachment{};
+                depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+                depthAttachment.imageView = depthView;
+                depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
+                depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+                depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+                depthAttachment.clearValue = clearValues[1];
+
+                VkRenderingInfo renderingInfo{};
+                renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+                renderingInfo.renderArea = renderArea;
+                renderingInfo.layerCount = 1;
+                renderingInfo.colorAttachmentCount = 1;
+                renderingInfo.pColorAttachments = &colorAttachment;
+                renderingInfo.pDepthAttachment = &depthAttachment;
+                vkCmdBeginRendering(cmdBuffer, &renderingInfo);
+                break;
+            }
+        }
+    }
+
+    void VkEngineApp::endRendering(VkCommandBuffer cmdBuffer) {
+        switch (mRenderPath) {
+            case RenderPath::RENDER_PASS:
+                vkCmdEndRenderPass(cmdBuffer);
+                break;
+            case RenderPath::DYNAMIC_RENDERING:
+                vkCmdEndRendering(cmdBuffer);
+                break;
+        }
+    }
+
+    EngineResult<void> VkEngineApp::recordScene(VkCommandBuffer cmdBuffer) {
+        VKE_TRACE_SCOPE("VkEngineApp::recordScene");
+        VKE_TRACE_GPU_SCOPE(cmdBuffer, "Scene");
+
+        // bind pipeline
+        vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, mPipeline);
+        // render, app scopes nest under this one
+        {
+            VKE_TRACE_SCOPE("VkEngineApp::render");
+            render(cmdBuffer);
+        }
+        TRY(flushInstances());
+        // opaque draws queued by render(), grouped by state and nearest first within a group so early depth test culls hidden fragments
+        mOpaqueDraws.sort();
+        mOpaqueDraws.record(cmdBuffer, mPipelineLayout, mPipeline);
+        mOpaqueDraws.clear();
+        // survivors of GPU culling
+        if (mGpuCulling.isEnabled()) {
+            mGpuCulling.draw(cmdBuffer, mCurrentFrame);
+        }
+
+        return {};
+    }
+
+    EngineResult<void> VkEngineApp::createRenderGraph() {
+        VKE_TRACE_SCOPE("VkEngineApp::createRenderGraph");
+
+        mRenderGraph.init(mDevice, mSpeedyMemType);
+        mRenderGraph.reset();
+
+        // swapchain image is cleared, so its previous contents can be discarded once presentation engine is done with it
+        mBackbuffer = mRenderGraph.importImage("backbuffer", VK_IMAGE_ASPECT_COLOR_BIT,
+                                               { VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_2_NONE, VK_IMAGE_LAYOUT_UNDEFINED },
+                                               VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+        // depth is shared between frames in flight, wait for previous frame's depth writes before clearing
+        mDepth = mRenderGraph.importImage("depth", VK_IMAGE_ASPECT_DEPTH_BIT,
+                                          { VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, VK_IMAGE_LAYOUT_UNDEFINED });
+
+        describeFrame(mRenderGraph, mBackbuffer, mDepth);
+        TRY(mRenderGraph.compile());
+
+        log::debug(log::Category::ENGINE, mRenderGraph.getStats());
+
+        return {};
+    }
+
+    void VkEngineApp::describeFrame(RenderGraph& graph, RenderGraph::Resource backbuffer, RenderGraph::Resource depth) {
+        addScenePass(graph, backbuffer, depth);
+    }
+
+    RenderGraph::PassBuilder VkEngineApp::addScenePass(RenderGraph& graph, RenderGraph::Resource target, RenderGraph::Resource depth) {
+        RenderGraph::PassBuilder pass = graph.addPass("scene", [this, &graph, target, depth](VkCommandBuffer cmdBuffer) -> EngineResult<void> {
+            beginRendering(cmdBuffer, VK_NULL_HANDLE, graph.getImageView(target), graph.getImageView(depth));
+            TRY(recordScene(cmdBuffer));
+            endRendering(cmdBuffer);
+
+            return {};
+        });
+
+        pass.write(target, RenderGraph::Access::COLOR_ATTACHMENT)
+            .write(depth, RenderGraph::Access::DEPTH_ATTACHMENT);
+
+        return pass;
+    }
+
     EngineResult<void> VkEngineApp::createSemaphores() {
+        VKE_TRACE_SCOPE("VkEngineApp::createSemaphores");
+
         size_t size = MAX_CONCURRENT_FRAMES * 2;
         mFrameSemaphores.resize(size);
 
@@ -900,6 +1659,8 @@ namespace vke {
     }
 
     EngineResult<void> VkEngineApp::createFences() {
+        VKE_TRACE_SCOPE("VkEngineApp::createFences");
+
         size_t size = MAX_CONCURRENT_FRAMES;
         mFrameFences.resize(size);
 
@@ -916,13 +1677,59 @@ namespace vke {
         return {};
     }
 
+    EngineResult<void> VkEngineApp::createAsyncCompute() {
+        VKE_TRACE_SCOPE("VkEngineApp::createAsyncCompute");
+
+        uint32_t graphicsFamily = QueueFamilyIndexes::query(mPhysicalDevice, mSurface).getGraphics();
+        TRY(mAsyncCompute.init(mDevice, mAsyncComputeQueue, mAsyncComputeFamily, graphicsFamily, MAX_CONCURRENT_FRAMES));
+
+        if (mAsyncCompute.isAsync()) {
+            log::debug(log::Category::ENGINE, "Async compute enabled on queue family ", mAsyncComputeFamily);
+        }
+
+        return {};
+    }
+
+    EngineResult<void> VkEngineApp::createAssetStreamer() {
+        VKE_TRACE_SCOPE("VkEngineApp::createAssetStreamer");
+
+        return mAssetStreamer.init(mDevice, mStagingMemType, mSpeedyMemType, ASSET_STAGING_SIZE, MAX_CONCURRENT_FRAMES);
+    }
+
+    EngineResult<void> VkEngineApp::createTextureStreamer() {
+        VKE_TRACE_SCOPE("VkEngineApp::createTextureStreamer");
+
+        return mTextureStreamer.init(mDevice, mPhysicalDevice, mStagingMemType, mSpeedyMemType, TEXTURE_FRAME_BUDGET, MAX_CONCURRENT_FRAMES);
+    }
+
+    EngineResult<void> VkEngineApp::createFrameCapture() {
+        VKE_TRACE_SCOPE("VkEngineApp::createFrameCapture");
+
+        return mFrameCapture.init(mDevice, mStagingMemType, CAPTURE_SLOTS);
+    }
+
+    EngineResult<void> VkEngineApp::createGpuTimeline() {
+#ifdef VKE_TRACING
+        VKE_TRACE_SCOPE("VkEngineApp::createGpuTimeline");
+
+        uint32_t graphicsFamily = QueueFamilyIndexes::query(mPhysicalDevice, mSurface).getGraphics();
+        return mGpuTimeline.init(mDevice, mPhysicalDevice, graphicsFamily, MAX_CONCURRENT_FRAMES);
+#else
+        return {};
+#endif
+    }
+
     void VkEngineApp::render(VkCommandBuffer cmdBuffer) {}
 
     EngineResult<void> VkEngineApp::onInit() {
         return {};
     }
 
-    EngineResult<Buffer> VkEngineApp::allocateBuffer(VkBufferUsageFlagBits bufferUsage, uint64_t size, BufferType type) {
+    PipelineDescription VkEngineApp::describePipeline() {
+        return {};
+    }
+
+    EngineResult<Buffer> VkEngineApp::allocateBuffer(VkBufferUsageFlags bufferUsage, uint64_t size, BufferType type) {
         VkBufferCreateInfo createInfo{};
         createInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
         createInfo.size = size;
@@ -957,8 +1764,13 @@ namespace vke {
 
         uint32_t typeIndex = memType.getTypeIndex();
 
+        if (type == BufferType::SPEEDY && (!memType.isValid() || !((requirements.memoryTypeBits >> typeIndex) & 1))) {
+            // only the device touches these, so any type the buffer accepts works, same fallback as images
+            typeIndex = std::countr_zero(requirements.memoryTypeBits);
+        }
+
         if (!((requirements.memoryTypeBits >> typeIndex) & 1)) {
-            std::cout << "[ENGINE] [WARN]: No memory type supports this buffer (" << buffer << ")\n";
+            log::warn(log::Category::ENGINE, "No memory type supports this buffer (", buffer, ")");
         }
 
         VkDeviceMemory memory;
@@ -971,7 +1783,474 @@ namespace vke {
 
         vkBindBufferMemory(mDevice, buffer, memory, 0);
 
-        return Buffer(mDevice, buffer, memory, size, memType.isHostCoherent());
+        return Buffer(mDevice, buffer, memory, size, !memType.isHostCoherent(), mNonCoherentAtomSize);
+    }
+
+    EngineResult<Mesh> VkEngineApp::createMesh(const MeshData& data) {
+        uint32_t vertexCount = data.getVertexCount();
+        uint64_t vertexBytes = data.vertices.size() * sizeof(float);
+
+        // half the index bandwidth whenever every vertex can be addressed with 16 bits
+        if (vertexCount <= UINT16_MAX + 1) {
+            std::vector<uint16_t> indices(data.indices.begin(), data.indices.end());
+            return createMesh(data.vertices.data(), vertexBytes, vertexCount, indices.data(), VK_INDEX_TYPE_UINT16, indices.size());
+        }
+
+        return createMesh(data.vertices.data(), vertexBytes, vertexCount, data.indices.data(), VK_INDEX_TYPE_UINT32, data.indices.size());
+    }
+
+    EngineResult<Mesh> VkEngineApp::createMesh(const MeshFile& file) {
+        const MeshFile::Header& header = file.getHeader();
+        return createMesh(file.getVertices(), file.getVertexBytes(), header.vertexCount, file.getIndices(), file.getIndexType(), header.indexCount);
+    }
+
+    EngineResult<Mesh> VkEngineApp::createMesh(const void* vertices, uint64_t vertexBytes, uint32_t vertexCount, const void* indices, VkIndexType indexType, uint32_t indexCount) {
+        uint64_t indexBytes = static_cast<uint64_t>(indexCount) * (indexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t));
+        // vkCmdCopyBuffer has no alignment rules, keeping indices 4 byte aligned is just cheaper to read
+        uint64_t indexOffset = (vertexBytes + 3) / 4 * 4;
+
+        auto staging = allocateBuffer(VK_BUFFER_USAGE_TRANSFER_SRC_BIT, indexOffset + indexBytes, BufferType::STAGING);
+        if (!staging)
+            return EngineResult<Mesh>::error(std::move(staging.getError()));
+
+        if (auto mapped = staging->map()) {
+            std::memcpy(&mapped.getOk()[0], vertices, vertexBytes);
+            std::memcpy(&mapped.getOk()[indexOffset], indices, indexBytes);
+            if (auto flushed = mapped->flush(0, indexOffset + indexBytes); !flushed)
+                return EngineResult<Mesh>::error(std::move(flushed.getError()));
+        } else {
+            return EngineResult<Mesh>::error(std::move(mapped.getError()));
+        }
+
+        auto vertexBuffer = allocateBuffer(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, vertexBytes, BufferType::SPEEDY);
+        if (!vertexBuffer)
+            return EngineResult<Mesh>::error(std::move(vertexBuffer.getError()));
+
+        auto indexBuffer = allocateBuffer(VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, indexBytes, BufferType::SPEEDY);
+        if (!indexBuffer)
+            return EngineResult<Mesh>::error(std::move(indexBuffer.getError()));
+
+        mMeshUploads.push_back({ std::move(staging.getOk()), vertexBuffer->getHandle(), indexBuffer->getHandle(), vertexBytes, indexOffset, indexBytes });
+
+        return Mesh(std::move(vertexBuffer.getOk()), std::move(indexBuffer.getOk()), indexType, indexCount, vertexCount);
+    }
+
+    EngineResult<Image> VkEngineApp::createImage(VkFormat format, VkExtent2D extent, VkImageUsageFlags usage, uint32_t mipLevels) {
+        VkImageCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        createInfo.imageType = VK_IMAGE_TYPE_2D;
+        createInfo.format = format;
+        createInfo.extent = { extent.width, extent.height, 1 };
+        createInfo.mipLevels = mipLevels;
+        createInfo.arrayLayers = 1;
+        createInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        createInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        createInfo.usage = usage;
+        createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        createInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        VkImage image;
+        if (VkResult result = vkCreateImage(mDevice, &createInfo, nullptr, &image)) {
+            return EngineResult<Image>::error(EngineError::fromVkError(result));
+        }
+        mImages.push_back(image);
+
+        VkMemoryRequirements requirements;
+        vkGetImageMemoryRequirements(mDevice, image, &requirements);
+
+        uint32_t typeIndex = mSpeedyMemType.getTypeIndex();
+        if (!mSpeedyMemType.isValid() || !((requirements.memoryTypeBits >> typeIndex) & 1)) {
+            // fall back to lowest type the image accepts
+            typeIndex = std::countr_zero(requirements.memoryTypeBits);
+        }
+
+        VkMemoryAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.allocationSize = requirements.size;
+        allocateInfo.memoryTypeIndex = typeIndex;
+
+        VkDeviceMemory memory;
+        if (VkResult result = vkAllocateMemory(mDevice, &allocateInfo, nullptr, &memory)) {
+            return EngineResult<Image>::error(EngineError::fromVkError(result));
+        }
+        mMemoryAllocations.push_back(memory);
+
+        if (VkResult result = vkBindImageMemory(mDevice, image, memory, 0)) {
+            return EngineResult<Image>::error(EngineError::fromVkError(result));
+        }
+
+        VkImageViewCreateInfo viewCreateInfo{};
+        viewCreateInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewCreateInfo.image = image;
+        viewCreateInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewCreateInfo.format = format;
+        viewCreateInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewCreateInfo.subresourceRange.baseMipLevel = 0;
+        viewCreateInfo.subresourceRange.levelCount = mipLevels;
+        viewCreateInfo.subresourceRange.baseArrayLayer = 0;
+        viewCreateInfo.subresourceRange.layerCount = 1;
+
+        VkImageView view;
+        if (VkResult result = vkCreateImageView(mDevice, &viewCreateInfo, nullptr, &view)) {
+            return EngineResult<Image>::error(EngineError::fromVkError(result));
+        }
+        mImageViews.push_back(view);
+
+        return Image(image, view, memory, format, extent, mipLevels);
+    }
+
+    EngineResult<Image> VkEngineApp::createTexture(const void* pixels, uint64_t bytes, VkFormat format, VkExtent2D extent, bool mipmapped) {
+        // level 0 is copied tightly packed, so anything shorter would read past the pixels
+        uint32_t texelSize = getTexelSize(format);
+        if (texelSize == 0)
+            return EngineResult<Image>::error(EngineError::featureNotSupported("texture format"));
+        if (bytes < static_cast<uint64_t>(extent.width) * extent.height * texelSize)
+            return EngineResult<Image>::error(EngineError::invalidFile("pixel data is smaller than the texture"));
+
+        uint32_t mipLevels = 1;
+        VkImageUsageFlags usage = VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+
+        if (mipmapped) {
+            // chain is built with linear blits, which not every format supports
+            VkFormatProperties properties;
+            vkGetPhysicalDeviceFormatProperties(mPhysicalDevice, format, &properties);
+
+            VkFormatFeatureFlags required = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+            if ((properties.optimalTilingFeatures & required) == required) {
+                mipLevels = Image::getMipLevelCount(extent);
+                usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+            } else {
+                log::warn(log::Category::ENGINE, "Format ", format, " can not be blitted, texture gets no mip chain");
+            }
+        }
+
+        auto image = createImage(format, extent, usage, mipLevels);
+        if (!image)
+            return image;
+
+        auto staging = allocateBuffer(VK_BUFFER_USAGE_TRANSFER_SRC_BIT, bytes, BufferType::STAGING);
+        if (!staging)
+            return EngineResult<Image>::error(std::move(staging.getError()));
+
+        if (auto mapped = staging->map()) {
+            mapped->write(pixels, bytes);
+            if (auto flushed = mapped->flush(0, bytes); !flushed)
+                return EngineResult<Image>::error(std::move(flushed.getError()));
+        } else {
+            return EngineResult<Image>::error(std::move(mapped.getError()));
+        }
+
+        const Image& created = image.getOk();
+        mImageUploads.push_back({ Image(created.getHandle(), created.getView(), created.getMemory(), format, extent, mipLevels), std::move(staging.getOk()) });
+
+        return image;
+    }
+
+    EngineResult<VkSampler> VkEngineApp::createSampler(VkSamplerAddressMode addressMode) {
+        VkSamplerCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        createInfo.magFilter = VK_FILTER_LINEAR;
+        createInfo.minFilter = VK_FILTER_LINEAR;
+        createInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+        createInfo.addressModeU = addressMode;
+        createInfo.addressModeV = addressMode;
+        createInfo.addressModeW = addressMode;
+        createInfo.minLod = 0.0f;
+        createInfo.maxLod = VK_LOD_CLAMP_NONE;
+
+        VkSampler sampler;
+        if (VkResult result = vkCreateSampler(mDevice, &createInfo, nullptr, &sampler)) {
+            return EngineResult<VkSampler>::error(EngineError::fromVkError(result));
+        }
+        mSamplers.push_back(sampler);
+
+        return sampler;
+    }
+
+    void VkEngineApp::destroyImage(Image& image) {
+        VkImage handle = image.getHandle();
+        VkImageView view = image.getView();
+        VkDeviceMemory memory = image.getMemory();
+
+        vkDestroyImageView(mDevice, view, nullptr);
+        vkDestroyImage(mDevice, handle, nullptr);
+        vkFreeMemory(mDevice, memory, nullptr);
+
+        std::erase(mImageViews, view);
+        std::erase(mImages, handle);
+        std::erase(mMemoryAllocations, memory);
+
+        image = Image{};
+    }
+
+    void VkEngineApp::recordUploads(VkCommandBuffer cmdBuffer) {
+        // this frame's fence was waited on, so its previous copies are done
+        for (Buffer& staging : mUploadStaging[mCurrentFrame]) {
+            destroyBuffer(staging);
+        }
+        mUploadStaging[mCurrentFrame].clear();
+
+        for (MeshUpload& upload : mMeshUploads) {
+            VkBufferCopy vertexRegion{ 0, 0, upload.vertexBytes };
+            VkBufferCopy indexRegion{ upload.indexOffset, 0, upload.indexBytes };
+            vkCmdCopyBuffer(cmdBuffer, upload.staging.getHandle(), upload.vertexBuffer, 1, &vertexRegion);
+            vkCmdCopyBuffer(cmdBuffer, upload.staging.getHandle(), upload.indexBuffer, 1, &indexRegion);
+            mUploadStaging[mCurrentFrame].push_back(std::move(upload.staging));
+        }
+
+        if (!mMeshUploads.empty()) {
+            VkMemoryBarrier2 barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+            barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+            barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            barrier.dstStageMask = VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT | VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT;
+            barrier.dstAccessMask = VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_2_INDEX_READ_BIT;
+
+            VkDependencyInfo dependency{};
+            dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+            dependency.memoryBarrierCount = 1;
+            dependency.pMemoryBarriers = &barrier;
+            vkCmdPipelineBarrier2(cmdBuffer, &dependency);
+        }
+        mMeshUploads.clear();
+
+        for (ImageUpload& upload : mImageUploads) {
+            upload.image.recordUpload(cmdBuffer, upload.staging.getHandle(), 0);
+            mUploadStaging[mCurrentFrame].push_back(std::move(upload.staging));
+        }
+        mImageUploads.clear();
+    }
+
+    void VkEngineApp::pushConstantsData(VkCommandBuffer cmdBuffer, VkShaderStageFlags stages, uint32_t offset, uint32_t size, const void* data) {
+        vkCmdPushConstants(cmdBuffer, mPipelineLayout, stages, offset, size, data);
+    }
+
+    EngineResult<VkDescriptorSet> VkEngineApp::allocateDescriptorSet(uint32_t set) {
+        return mDescriptorAllocator.allocate(mDescriptorSetLayouts[set]);
+    }
+
+    EngineResult<VkDescriptorSet> VkEngineApp::allocatePersistentDescriptorSet(uint32_t set) {
+        return mDescriptorAllocator.allocatePersistent(mDescriptorSetLayouts[set]);
+    }
+
+    void VkEngineApp::updateDescriptorSets(DescriptorWriter& writer) {
+        writer.update(mDevice);
+    }
+
+    VkPipelineLayout VkEngineApp::getPipelineLayout() const {
+        return mPipelineLayout;
+    }
+
+    void VkEngineApp::submitOpaque(const DrawCommand& draw) {
+        mOpaqueDraws.submit(draw);
+    }
+
+    const DrawList::Stats& VkEngineApp::getDrawStats() const {
+        return mOpaqueDraws.getStats();
+    }
+
+    EngineResult<void> VkEngineApp::enableGpuCulling(Mesh& geometry, uint32_t maxObjects) {
+        if (!mSupportsIndirectCount) {
+            return EngineError::featureNotSupported("drawIndirectCount");
+        }
+
+        ShaderFile shader;
+        if (auto file = ShaderFile::loadFromFile(VKE_SHADER_DIR "/cull.comp.spv", "main")) {
+            shader = std::move(file.getOk());
+        } else {
+            return file;
+        }
+
+        std::vector<VkDescriptorSetLayoutBinding> bindings{3};
+        for (uint32_t i = 0; i < bindings.size(); i++) {
+            bindings[i].binding = i;
+            bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            bindings[i].descriptorCount = 1;
+            bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        }
+
+        if (auto layout = mDescriptorLayoutCache.getLayout(bindings)) {
+            mCullingSetLayout = layout.getOk();
+        } else {
+            return layout;
+        }
+
+        std::vector<Buffer> objectBuffers;
+        std::vector<Buffer> drawBuffers;
+        std::vector<Buffer> countBuffers;
+        for (int i = 0; i < MAX_CONCURRENT_FRAMES; i++) {
+            if (auto buffer = allocateBuffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, static_cast<uint64_t>(maxObjects) * sizeof(GpuCullObject), BufferType::STAGING)) {
+                objectBuffers.push_back(std::move(buffer.getOk()));
+            } else {
+                return buffer;
+            }
+
+            if (auto buffer = allocateBuffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, static_cast<uint64_t>(maxObjects) * sizeof(VkDrawIndexedIndirectCommand), BufferType::SPEEDY)) {
+                drawBuffers.push_back(std::move(buffer.getOk()));
+            } else {
+                return buffer;
+            }
+
+            if (auto buffer = allocateBuffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, sizeof(uint32_t), BufferType::SPEEDY)) {
+                countBuffers.push_back(std::move(buffer.getOk()));
+            } else {
+                return buffer;
+            }
+        }
+
+        VkShaderModuleCreateInfo createInfo{};
+        createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        createInfo.codeSize = shader.getSize();
+        createInfo.pCode = shader.getCode();
+
+        VkShaderModule module;
+        if (VkResult result = vkCreateShaderModule(mDevice, &createInfo, nullptr, &module)) {
+            return EngineError::fromVkError(result);
+        }
+
+        // pipeline keeps what it needs, module can go right away
+        EngineResult<void> result = mGpuCulling.init(mDevice, module, mCullingSetLayout, std::move(objectBuffers), std::move(drawBuffers), std::move(countBuffers), maxObjects);
+        vkDestroyShaderModule(mDevice, module, nullptr);
+
+        if (!result)
+            return result;
+
+        mGpuCulling.setGeometry(geometry);
+
+        return {};
+    }
+
+    GpuCulling& VkEngineApp::getGpuCulling() {
+        return mGpuCulling;
+    }
+
+    AssetStreamer& VkEngineApp::getAssetStreamer() {
+        return mAssetStreamer;
+    }
+
+    TextureStreamer& VkEngineApp::getTextureStreamer() {
+        return mTextureStreamer;
+    }
+
+    void VkEngineApp::captureFrame(std::filesystem::path path, FrameCapture::Encoding encoding) {
+        if (!(mSwapchainUsage & VK_IMAGE_USAGE_TRANSFER_SRC_BIT)) {
+            log::warn(log::Category::ENGINE, "Swapchain images can not be copied from, capture skipped");
+            return;
+        }
+
+        mFrameCapture.capture(std::move(path), encoding);
+    }
+
+    void VkEngineApp::captureFrame(FrameCapture::Callback callback) {
+        if (!(mSwapchainUsage & VK_IMAGE_USAGE_TRANSFER_SRC_BIT)) {
+            log::warn(log::Category::ENGINE, "Swapchain images can not be copied from, capture skipped");
+            return;
+        }
+
+        mFrameCapture.capture(std::move(callback));
+    }
+
+    FrameCapture& VkEngineApp::getFrameCapture() {
+        return mFrameCapture;
+    }
+
+    void VkEngineApp::scheduleCompute(AsyncCompute::Job job) {
+        mAsyncCompute.schedule(std::move(job));
+    }
+
+    void VkEngineApp::releaseToGraphics(std::vector<VkBuffer> buffers, VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess) {
+        mAsyncCompute.release(std::move(buffers), dstStage, dstAccess);
+    }
+
+    VkDevice VkEngineApp::getDevice() const {
+        return mDevice;
+    }
+
+    VkExtent2D VkEngineApp::getSwapchainExtent() const {
+        return mSwapchainExtent;
+    }
+
+    void VkEngineApp::stop() {
+        mRunning = false;
+    }
+
+    VkFormat VkEngineApp::getSwapchainFormat() const {
+        return mSwapchainImageFormat;
+    }
+
+    int VkEngineApp::getCurrentFrame() const {
+        return mCurrentFrame;
+    }
+
+    EngineResult<VkBuffer> VkEngineApp::uploadTransforms(TransformHierarchy& hierarchy) {
+        VKE_TRACE_SCOPE("VkEngineApp::uploadTransforms");
+
+        hierarchy.update();
+
+        TransformUploads& uploads = mTransformUploads[hierarchy.getId()];
+        if (uploads.buffers.empty()) {
+            uploads.buffers.resize(MAX_CONCURRENT_FRAMES);
+            uploads.mappings.resize(MAX_CONCURRENT_FRAMES);
+            uploads.sizes.resize(MAX_CONCURRENT_FRAMES, 0);
+            uploads.versions.resize(MAX_CONCURRENT_FRAMES, 0);
+        }
+
+        uint64_t bytes = std::max<uint64_t>(hierarchy.size() * TransformHierarchy::MATRIX_SIZE, TransformHierarchy::MATRIX_SIZE);
+
+        if (uploads.sizes[mCurrentFrame] < bytes) {
+            uint64_t size = std::max(bytes, uploads.sizes[mCurrentFrame] * 2);
+
+            uploads.mappings[mCurrentFrame] = Buffer::MappedScope{};
+            if (uploads.sizes[mCurrentFrame] > 0) {
+                destroyBuffer(uploads.buffers[mCurrentFrame]);
+            }
+
+            // mapped for good and patched from the host, so host visible memory is read directly by the device
+            if (auto buffer = allocateBuffer(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, size, BufferType::STAGING)) {
+                uploads.buffers[mCurrentFrame] = std::move(buffer.getOk());
+            } else {
+                return EngineResult<VkBuffer>::error(std::move(buffer.getError()));
+            }
+
+            if (auto mapped = uploads.buffers[mCurrentFrame].map()) {
+                uploads.mappings[mCurrentFrame] = std::move(mapped.getOk());
+            } else {
+                return EngineResult<VkBuffer>::error(std::move(mapped.getError()));
+            }
+
+            uploads.sizes[mCurrentFrame] = size;
+            // fresh buffer, everything has to be written
+            uploads.versions[mCurrentFrame] = 0;
+        }
+
+        TransformHierarchy::WorldWrite written = hierarchy.writeWorld(&uploads.mappings[mCurrentFrame][0], uploads.versions[mCurrentFrame]);
+        if (auto flushed = uploads.mappings[mCurrentFrame].flush(written.offset, written.bytes); !flushed)
+            return EngineResult<VkBuffer>::error(std::move(flushed.getError()));
+        uploads.versions[mCurrentFrame] = written.version;
+
+        return uploads.buffers[mCurrentFrame].getHandle();
+    }
+
+    size_t VkEngineApp::drawScene(EntityStore& store, TransformHierarchy& hierarchy, const Frustum& frustum) {
+        VKE_TRACE_SCOPE("VkEngineApp::drawScene");
+
+        store.applyCommands();
+        hierarchy.update();
+
+        return mRenderSystem.gather(store, hierarchy, frustum, mInstanceBatcher);
+    }
+
+    void VkEngineApp::destroyBuffer(Buffer& buffer) {
+        VkBuffer handle = buffer.getHandle();
+        VkDeviceMemory memory = buffer.getMemory();
+
+        vkDestroyBuffer(mDevice, handle, nullptr);
+        vkFreeMemory(mDevice, memory, nullptr);
+
+        std::erase(mBuffers, handle);
+        std::erase(mMemoryAllocations, memory);
+
+        buffer = Buffer{};
     }
 
     void VkEngineApp::setMemoryTypes() {
@@ -979,13 +2258,14 @@ namespace vke {
         vkGetPhysicalDeviceMemoryProperties(mPhysicalDevice, &memoryProperties);
 
         uint32_t speedyMemoryTypeIndex = VK_MAX_MEMORY_TYPES + 1;
-        VkDeviceSize speedyMemorySize;
+        VkDeviceSize speedyMemorySize = 0;
         uint32_t stagingMemoryTypeIndex = VK_MAX_MEMORY_TYPES + 1;
         VkDeviceSize stagingMemorySize = 0;
         bool stagingMemoryCoherent = false;
         uint32_t universalMemoryTypeIndex = VK_MAX_MEMORY_TYPES + 1;
         VkDeviceSize universalMemorySize = 0;
         bool universalMemoryCoherent = false;
+        uint32_t lazyMemoryTypeIndex = VK_MAX_MEMORY_TYPES + 1;
 
         for (size_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
             VkMemoryType type = memoryProperties.memoryTypes[i];
@@ -1001,6 +2281,10 @@ namespace vke {
                 }
             }
 
+            if (type.propertyFlags & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT) {
+                lazyMemoryTypeIndex = i;
+            }
+
             if (type.propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
                 if (heap.size > stagingMemorySize) {
                     stagingMemoryTypeIndex = i;
@@ -1027,5 +2311,6 @@ namespace vke {
         mSpeedyMemType = MemoryType(speedyMemoryTypeIndex, false);
         mStagingMemType = MemoryType(stagingMemoryTypeIndex, stagingMemoryCoherent);
         mUniversalMemType = MemoryType(universalMemoryTypeIndex, universalMemoryCoherent);
+        mLazyMemType = MemoryType(lazyMemoryTypeIndex, false);
     }
 }
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include "engine/WorkerPool.hpp"
+#include "engine/Trace.hpp"
+
+namespace vke {
+
+    WorkerPool::WorkerPool(uint32_t workers) : mThreads{}, mRunMutex{}, mMutex{}, mWake{}, mDone{}, mGeneration{0}, mTask{nullptr}, mCount{0}, mNext{0}, mHelpers{0}, mJoined{0}, mActive{0}, mStopping{false} {
+        if (workers == 0) {
+            workers = std::max(1u, std::thread::hardware_concurrency()) - 1;
+        }
+
+        for (uint32_t i = 0; i < workers; i++) {
+            mThreads.emplace_back(&WorkerPool::runWorker, this);
+        }
+    }
+
+    WorkerPool::~WorkerPool() {
+        {
+            std::lock_guard lock{mMutex};
+            mStopping = true;
+        }
+        mWake.notify_all();
+
+        for (std::thread& thread : mThreads) {
+            thread.join();
+        }
+    }
+
+    WorkerPool& WorkerPool::getShared() {
+        static WorkerPool pool;
+        return pool;
+    }
+
+    uint32_t WorkerPool::getWorkerCount() const {
+        return mThreads.size();
+    }
+
+    void WorkerPool::runWorker() {
+        VKE_TRACE_THREAD("Worker");
+
+        uint64_t seen = 0;
+        std::unique_lock lock{mMutex};
+
+        while (true) {
+            mWake.wait(lock, [this, seen] { return mStopping || mGeneration != seen; });
+            if (mStopping)
+                return;
+
+            seen = mGeneration;
+            if (mJoined >= mHelpers)
+                continue;
+
+            mJoined++;
+            mActive++;
+            lock.unlock();
+
+            drain();
+
+            lock.lock();
+            if (--mActive == 0) {
+                mDone.notify_all();
+            }
+        }
+    }
+
+    void WorkerPool::drain() {
+        for (size_t i = mNext.fetch_add(1, std::memory_order_relaxed); i < mCount; i = mNext.fetch_add(1, std::memory_order_relaxed)) {
+            (*mTask)(i);
+        }
+    }
+
+    void WorkerPool::run(size_t count, const std::function<void(size_t)>& task, uint32_t maxThreads) {
+        size_t helpers = std::min<size_t>(mThreads.size(), count - std::min<size_t>(count, 1));
+        if (maxThreads != 0) {
+            helpers = std::min<size_t>(helpers, maxThreads - 1);
+        }
+
+        if (helpers == 0) {
+            for (size_t i = 0; i < count; i++) {
+                task(i);
+            }
+            return;
+        }
+
+        std::lock_guard runLock{mRunMutex};
+        {
+            std::lock_guard lock{mMutex};
+            mTask = &task;
+            mCount = count;
+            mNext.store(0, std::memory_order_relaxed);
+            mHelpers = helpers;
+            mJoined = 0;
+            mGeneration++;
+        }
+        mWake.notify_all();
+
+        drain();
+
+        // every index is taken once drain() returns, workers that joined may still be running theirs. Workers
+        // joining late find nothing left to take.
+        std::unique_lock lock{mMutex};
+        mDone.wait(lock, [this] { return mActive == 0; });
+        mHelpers = 0;
+    }
+}
@@ -1 +1,11 @@
+#include <cstdio>
+#include <exception>
 #include "engine/utils/Result.hpp"
+
+namespace vke::utils::detail {
+
+    void fail(const char* message) noexcept {
+        std::fputs(message, stderr);
+        std::terminate();
+    }
+}
@@ -0,0 +1,30 @@
+#include "engine/vk/dispatch.hpp"
+
+namespace vke::vk {
+
+#define VKE_DEFINE_FUNCTION(name) PFN_##name name = nullptr;
+    VKE_GLOBAL_FUNCTIONS(VKE_DEFINE_FUNCTION)
+    VKE_INSTANCE_FUNCTIONS(VKE_DEFINE_FUNCTION)
+    VKE_DEVICE_FUNCTIONS(VKE_DEFINE_FUNCTION)
+#undef VKE_DEFINE_FUNCTION
+
+    void loadGlobal() {
+#define VKE_LOAD_FUNCTION(name) name = reinterpret_cast<PFN_##name>(::vkGetInstanceProcAddr(VK_NULL_HANDLE, #name));
+        VKE_GLOBAL_FUNCTIONS(VKE_LOAD_FUNCTION)
+#undef VKE_LOAD_FUNCTION
+    }
+
+    void loadInstance(VkInstance instance) {
+#define VKE_LOAD_FUNCTION(name) name = reinterpret_cast<PFN_##name>(::vkGetInstanceProcAddr(instance, #name));
+        VKE_INSTANCE_FUNCTIONS(VKE_LOAD_FUNCTION)
+        // device functions through the instance dispatch until loadDevice() replaces them
+        VKE_DEVICE_FUNCTIONS(VKE_LOAD_FUNCTION)
+#undef VKE_LOAD_FUNCTION
+    }
+
+    void loadDevice(VkDevice device) {
+#define VKE_LOAD_FUNCTION(name) name = reinterpret_cast<PFN_##name>(vkGetDeviceProcAddr(device, #name));
+        VKE_DEVICE_FUNCTIONS(VKE_LOAD_FUNCTION)
+#undef VKE_LOAD_FUNCTION
+    }
+}
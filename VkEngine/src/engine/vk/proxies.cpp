@@ -1,22 +0,0 @@
-#include "engine/vk/proxies.hpp"
-
-namespace vke::vk {
-
-    VkResult vkCreateDebugUtilsMessengerEXT(VkInstance instance, const VkDebugUtilsMessengerCreateInfoEXT* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDebugUtilsMessengerEXT* pMessenger) {
-        auto func = (PFN_vkCreateDebugUtilsMessengerEXT) vkGetInstanceProcAddr(instance, "vkCreateDebugUtilsMessengerEXT");
-
-        if (func != nullptr) {
-            return func(instance, pCreateInfo, pAllocator, pMessenger);
-        }
-
-        return VK_ERROR_EXTENSION_NOT_PRESENT;
-    }
-
-    void vkDestroyDebugUtilsMessengerEXT(VkInstance instance, VkDebugUtilsMessengerEXT messenger, const VkAllocationCallbacks* pAllocator) {
-        auto func = (PFN_vkDestroyDebugUtilsMessengerEXT) vkGetInstanceProcAddr(instance, "vkDestroyDebugUtilsMessengerEXT");
-
-        if (func != nullptr) {
-            func(instance, messenger, pAllocator);
-        }
-    }
-}
\ No newline at end of file
@@ -1,12 +0,0 @@
-#ifndef PROXIES_HPP
-#define PROXIES_HPP
-
-#include <vulkan/vulkan.h>
-
-namespace vke::vk {
-
-    VkResult vkCreateDebugUtilsMessengerEXT(VkInstance instance, const VkDebugUtilsMessengerCreateInfoEXT* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkDebugUtilsMessengerEXT* pMessenger);
-    void vkDestroyDebugUtilsMessengerEXT(VkInstance instance, VkDebugUtilsMessengerEXT pMessenger, const VkAllocationCallbacks* pAllocator);
-}
-
-#endif